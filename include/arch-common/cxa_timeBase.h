@@ -68,4 +68,29 @@ uint32_t cxa_timeBase_getCount_us(void);
 uint32_t cxa_timeBase_getMaxCount_us(void);
 
 
+/**
+ * @public
+ * @brief Returns the current monotonic, relative time in microseconds
+ * as a 64-bit value (which, for all practical purposes, never overflows).
+ *
+ * @note Not available on all architectures (currently posix and esp32).
+ *		Required when CXA_TIMEDIFF_64BIT_ENABLE is defined.
+ *
+ * @return the current time of the timeBase, in microseconds
+ */
+uint64_t cxa_timeBase_getCount64_us(void);
+
+
+/**
+ * @public
+ * @brief Returns the current monotonic, relative time in nanoseconds
+ * as a 64-bit value. Resolution is architecture-dependent.
+ *
+ * @note Not available on all architectures (currently posix and esp32)
+ *
+ * @return the current time of the timeBase, in nanoseconds
+ */
+uint64_t cxa_timeBase_getCount64_ns(void);
+
+
 #endif // CXA_TIMEBASE_H_
@@ -0,0 +1,95 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains prototypes for a wakeable sleep. A wakeable sleep blocks the
+ * calling thread for up to a fixed amount of time, but can be woken early by
+ * another thread (or, where the architecture supports it, an interrupt).
+ *
+ * @note This is primarily used by the runLoop to idle between deadlines when
+ *		CXA_RUNLOOP_TICKLESS_ENABLE is defined
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_wakeableSleep_t* ws = cxa_wakeableSleep_reserve();
+ *
+ * ...
+ *
+ * // sleeping thread: returns after 1 second OR as soon as woken
+ * cxa_wakeableSleep_sleep_us(ws, 1000000);
+ *
+ * ...
+ *
+ * // other thread
+ * cxa_wakeableSleep_wake(ws);
+ * @endcode
+ */
+#ifndef CXA_WAKEABLESLEEP_H_
+#define CXA_WAKEABLESLEEP_H_
+
+
+// ******** includes ********
+#include <stdint.h>
+
+
+// ******** global macro definitions ********
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ */
+typedef struct cxa_wakeableSleep cxa_wakeableSleep_t;
+
+
+/**
+ * @private
+ */
+struct cxa_wakeableSleep
+{
+	void* placeholder;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Reserves a wakeable sleep from the architecture-specific pool
+ *
+ * @return the wakeable sleep, or NULL if none are available
+ */
+cxa_wakeableSleep_t* cxa_wakeableSleep_reserve(void);
+
+
+/**
+ * @public
+ * @brief Blocks the calling thread until the specified time has elapsed
+ * or until ::cxa_wakeableSleep_wake is called (whichever is first).
+ *
+ * A call to ::cxa_wakeableSleep_wake made while the thread is NOT sleeping
+ * will cause the next call to this function to return immediately.
+ *
+ * @param[in] wsIn the pre-reserved wakeable sleep
+ * @param[in] maxSleep_usIn the maximum amount of time to sleep, in microseconds
+ */
+void cxa_wakeableSleep_sleep_us(cxa_wakeableSleep_t *const wsIn, uint32_t maxSleep_usIn);
+
+
+/**
+ * @public
+ * @brief Wakes the thread sleeping on this wakeable sleep (if any).
+ * Safe to call from any thread.
+ *
+ * @param[in] wsIn the pre-reserved wakeable sleep
+ */
+void cxa_wakeableSleep_wake(cxa_wakeableSleep_t *const wsIn);
+
+
+#endif // CXA_WAKEABLESLEEP_H_
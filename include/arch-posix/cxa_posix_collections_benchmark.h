@@ -0,0 +1,136 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains micro-benchmarks for the collections.
+ *
+ * ::cxa_posix_collections_benchmark_measureSpscFifo measures two-thread
+ * throughput of a ::cxa_spscFifo_t: a producer thread writes a byte stream
+ * (in place, using ::cxa_spscFifo_bulkQueue_reserve / commit) while the
+ * calling thread reads and verifies it (using ::cxa_spscFifo_bulkDequeue_peek /
+ * ::cxa_spscFifo_bulkDequeue). No critical sections are involved.
+ *
+ * ::cxa_posix_collections_benchmark_measureFixedByteBuffer measures inserting
+ * (then removing) a block of bytes near the start of a ::cxa_fixedByteBuffer_t
+ * holding a payload (eg. prepending a topic to a 512-byte MQTT publish), both
+ * as a single bulk operation and one byte at a time.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_posix_collections_benchmark_fifoResults_t results;
+ * if( cxa_posix_collections_benchmark_measureSpscFifo(64 * 1024 * 1024, 256, &results) )
+ * {
+ * 	cxa_posix_collections_benchmark_writeFifoResults(&results, stdoutIoStream);
+ * }
+ * @endcode
+ */
+#ifndef CXA_POSIX_COLLECTIONS_BENCHMARK_H_
+#define CXA_POSIX_COLLECTIONS_BENCHMARK_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_ioStream.h>
+
+
+// ******** global macro definitions ********
+/**
+ * Size of the fifo used by ::cxa_posix_collections_benchmark_measureSpscFifo
+ * (must be a power of two)
+ */
+#ifndef CXA_POSIX_COLLECTIONS_BENCHMARK_FIFO_SIZE_BYTES
+	#define CXA_POSIX_COLLECTIONS_BENCHMARK_FIFO_SIZE_BYTES			4096
+#endif
+
+/**
+ * Size of the buffer used by ::cxa_posix_collections_benchmark_measureFixedByteBuffer
+ * (must hold the payload and the inserted bytes)
+ */
+#ifndef CXA_POSIX_COLLECTIONS_BENCHMARK_FBB_SIZE_BYTES
+	#define CXA_POSIX_COLLECTIONS_BENCHMARK_FBB_SIZE_BYTES			1024
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t numBytes;
+	size_t maxChunkSize_bytes;
+
+	size_t numErrors;						///< bytes received out of order / corrupted (should be 0)
+	size_t numProducerStalls;				///< times the producer found the fifo full
+	size_t numConsumerStalls;				///< times the consumer found the fifo empty
+
+	uint32_t elapsed_ms;
+	uint64_t throughput_bytesPerSec;
+}cxa_posix_collections_benchmark_fifoResults_t;
+
+
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t payloadSize_bytes;
+	size_t insertSize_bytes;
+	size_t numOps;
+
+	uint32_t bulk_nsPerOp;					///< one insert + one remove of insertSize_bytes
+	uint32_t perByte_nsPerOp;				///< the same, one byte at a time
+}cxa_posix_collections_benchmark_fbbResults_t;
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Streams numBytesIn bytes through a ::cxa_spscFifo_t from a producer
+ * 		thread to the calling thread
+ *
+ * @param[in] maxChunkSize_bytesIn maximum number of bytes the producer writes
+ * 		(and publishes) at once
+ *
+ * @return false if the parameters are invalid or the producer thread couldn't be started
+ */
+bool cxa_posix_collections_benchmark_measureSpscFifo(size_t numBytesIn, size_t maxChunkSize_bytesIn,
+													 cxa_posix_collections_benchmark_fifoResults_t *const resultsOut);
+
+
+/**
+ * @public
+ * @brief Writes the results as a single human-readable line
+ */
+void cxa_posix_collections_benchmark_writeFifoResults(const cxa_posix_collections_benchmark_fifoResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn);
+
+
+/**
+ * @public
+ * @brief Times numOpsIn insertions (and removals) of insertSize_bytesIn bytes
+ * 		at the start of a payloadSize_bytesIn-byte payload
+ *
+ * @return false if the payload and inserted bytes don't fit in
+ * 		CXA_POSIX_COLLECTIONS_BENCHMARK_FBB_SIZE_BYTES
+ */
+bool cxa_posix_collections_benchmark_measureFixedByteBuffer(size_t payloadSize_bytesIn, size_t insertSize_bytesIn, size_t numOpsIn,
+															cxa_posix_collections_benchmark_fbbResults_t *const resultsOut);
+
+
+/**
+ * @public
+ * @brief Writes the results as a single human-readable line
+ */
+void cxa_posix_collections_benchmark_writeFbbResults(const cxa_posix_collections_benchmark_fbbResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn);
+
+
+#endif // CXA_POSIX_COLLECTIONS_BENCHMARK_H_
@@ -0,0 +1,230 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains an end-to-end load generator / latency benchmark for the
+ * MQTT stack. N cxa_mqtt_client_t instances are connected to an in-process
+ * cxa_mqtt_broker_t over cxa_ioStream_pipe_t endpoints. Client i publishes to
+ * "bench/<i>" and client i+1 (wrapping) subscribes to it, so every publish
+ * crosses a client, the broker and another client.
+ *
+ * Each payload carries its publish timestamp, so the latency reported is the
+ * time from cxa_mqtt_client_publish_withCallback to the subscriber's
+ * onPublish callback (including the broker).
+ *
+ * @note The benchmark drives the runLoop of the given thread itself (it
+ * 		blocks in ::cxa_posix_mqtt_benchmark_run). Since runLoop entries cannot
+ * 		be removed, initialize / run it once per process.
+ *
+ * @note Every client and broker connection holds message factory messages, so
+ * 		CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES, CXA_MQTT_BROKER_MAXNUM_CONNECTIONS
+ * 		and CXA_RUNLOOP_MAXNUM_ENTRIES must be sized for numClients, and
+ * 		CXA_IOSTREAM_PIPE_BUFFER_SIZE_BYTES must hold several publishes. For
+ * 		QoS2, CXA_MQTT_BROKER_MAXNUM_INBOUND_QOS2 should be at least
+ * 		CXA_MQTT_CLIENT_MAXNUM_INFLIGHT.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * int main(int argc, char** argv)
+ * {
+ * 	static cxa_posix_mqtt_benchmark_t bench;
+ * 	cxa_posix_mqtt_benchmark_config_t config =
+ * 	{
+ * 		.numClients = 4,
+ * 		.qos = CXA_MQTT_QOS_ATLEAST_ONCE,
+ * 		.payloadSize_bytes = 64,
+ * 		.publishRate_hz = 0,
+ * 		.maxNumOutstanding = 8,
+ * 		.duration_ms = 5000
+ * 	};
+ * 	if( !cxa_posix_mqtt_benchmark_init(&bench, &config, CXA_RUNLOOP_THREADID_DEFAULT) ||
+ * 		!cxa_posix_mqtt_benchmark_run(&bench) ) return 1;
+ *
+ * 	cxa_posix_mqtt_benchmark_writeResults(&bench, stdoutIoStream);
+ * 	return 0;
+ * }
+ * @endcode
+ */
+#ifndef CXA_POSIX_MQTT_BENCHMARK_H_
+#define CXA_POSIX_MQTT_BENCHMARK_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_ioStream.h>
+#include <cxa_ioStream_pipe.h>
+#include <cxa_logger_header.h>
+#include <cxa_mqtt_broker.h>
+#include <cxa_mqtt_client.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_MQTT_BENCHMARK_MAXNUM_CLIENTS
+	#define CXA_POSIX_MQTT_BENCHMARK_MAXNUM_CLIENTS				CXA_MQTT_BROKER_MAXNUM_CONNECTIONS
+#endif
+
+#ifndef CXA_POSIX_MQTT_BENCHMARK_MAXSIZE_PAYLOAD_BYTES
+	#define CXA_POSIX_MQTT_BENCHMARK_MAXSIZE_PAYLOAD_BYTES		512
+#endif
+
+/**
+ * Publish timestamp (8 bytes) + publishing client's index (1 byte)
+ */
+#define CXA_POSIX_MQTT_BENCHMARK_MINSIZE_PAYLOAD_BYTES			9
+
+/**
+ * Number of latency samples kept for the percentiles. Once full, samples are
+ * replaced at random (reservoir sampling) so long runs stay representative.
+ */
+#ifndef CXA_POSIX_MQTT_BENCHMARK_MAXNUM_LATENCY_SAMPLES
+	#define CXA_POSIX_MQTT_BENCHMARK_MAXNUM_LATENCY_SAMPLES		8192
+#endif
+
+#ifndef CXA_POSIX_MQTT_BENCHMARK_CONNECT_TIMEOUT_MS
+	#define CXA_POSIX_MQTT_BENCHMARK_CONNECT_TIMEOUT_MS			5000
+#endif
+
+/**
+ * Maximum time to wait for outstanding publishes once publishing stops
+ */
+#ifndef CXA_POSIX_MQTT_BENCHMARK_DRAIN_TIMEOUT_MS
+	#define CXA_POSIX_MQTT_BENCHMARK_DRAIN_TIMEOUT_MS			2000
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_mqtt_benchmark_t object
+ */
+typedef struct cxa_posix_mqtt_benchmark cxa_posix_mqtt_benchmark_t;
+
+
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t numClients;					///< 1 - CXA_POSIX_MQTT_BENCHMARK_MAXNUM_CLIENTS
+	cxa_mqtt_qosLevel_t qos;			///< QoS of every publish (and subscription)
+	size_t payloadSize_bytes;			///< CXA_POSIX_MQTT_BENCHMARK_MINSIZE_PAYLOAD_BYTES - CXA_POSIX_MQTT_BENCHMARK_MAXSIZE_PAYLOAD_BYTES
+	uint32_t publishRate_hz;			///< per client, 0 publishes as fast as maxNumOutstanding allows
+	size_t maxNumOutstanding;			///< per client, publishes sent but not yet received (0 for no limit)
+	uint32_t duration_ms;				///< time spent publishing
+}cxa_posix_mqtt_benchmark_config_t;
+
+
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t numPublished;
+	size_t numThrottled;				///< publishes refused by the client (in-flight window full / write failed)
+	size_t numReceived;
+	size_t numLost;						///< published but not received before the drain timeout
+
+	uint32_t elapsed_ms;				///< first publish to last delivery
+	uint32_t throughput_msgsPerSec;		///< deliveries / elapsed_ms
+
+	uint32_t latencyMin_ns;
+	uint32_t latencyMean_ns;
+	uint32_t latencyP50_ns;
+	uint32_t latencyP90_ns;
+	uint32_t latencyP99_ns;
+	uint32_t latencyMax_ns;
+
+	size_t factoryHighWaterMark;		///< see ::cxa_mqtt_messageFactory_getHighWaterMark
+	size_t factoryNumExhausted;			///< see ::cxa_mqtt_messageFactory_getNumExhausted
+}cxa_posix_mqtt_benchmark_results_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	uint8_t index;
+
+	cxa_ioStream_pipe_t pipe;
+	cxa_mqtt_client_t client;
+
+	char clientId[16];
+	char pubTopic[16];
+	char subTopic[16];
+
+	uint64_t nextPublish_ns;
+	size_t numPublished;
+	size_t numReceivedBySubscriber;
+}cxa_posix_mqtt_benchmark_client_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_mqtt_benchmark
+{
+	cxa_posix_mqtt_benchmark_config_t config;
+	int threadId;
+
+	cxa_mqtt_broker_t broker;
+	cxa_posix_mqtt_benchmark_client_t clients[CXA_POSIX_MQTT_BENCHMARK_MAXNUM_CLIENTS];
+
+	uint8_t payload[CXA_POSIX_MQTT_BENCHMARK_MAXSIZE_PAYLOAD_BYTES];
+	uint64_t lastDelivery_ns;
+
+	uint32_t latencySamples_ns[CXA_POSIX_MQTT_BENCHMARK_MAXNUM_LATENCY_SAMPLES];
+	size_t numLatencySamples;
+	uint64_t latencySum_ns;
+
+	cxa_posix_mqtt_benchmark_results_t results;
+
+	cxa_logger_t logger;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Creates the broker and clients and starts connecting them
+ *
+ * @return false if the configuration is invalid (nothing is created)
+ */
+bool cxa_posix_mqtt_benchmark_init(cxa_posix_mqtt_benchmark_t *const benchIn, const cxa_posix_mqtt_benchmark_config_t *const configIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Connects all clients, publishes for the configured duration, waits
+ * 		for outstanding publishes and computes the results.
+ * 		Blocks (iterating the runLoop) until complete.
+ *
+ * @return false if the clients could not be connected / subscribed
+ */
+bool cxa_posix_mqtt_benchmark_run(cxa_posix_mqtt_benchmark_t *const benchIn);
+
+
+/**
+ * @public
+ * @return the results of the last ::cxa_posix_mqtt_benchmark_run
+ */
+const cxa_posix_mqtt_benchmark_results_t* cxa_posix_mqtt_benchmark_getResults(cxa_posix_mqtt_benchmark_t *const benchIn);
+
+
+/**
+ * @public
+ * @brief Writes the configuration and results as a human-readable report
+ */
+void cxa_posix_mqtt_benchmark_writeResults(cxa_posix_mqtt_benchmark_t *const benchIn, cxa_ioStream_t *const ioStreamIn);
+
+
+#endif // CXA_POSIX_MQTT_BENCHMARK_H_
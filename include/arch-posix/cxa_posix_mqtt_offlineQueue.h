@@ -0,0 +1,171 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a persistent (disk-backed) store-and-forward queue for
+ * MQTT publishes. Publishes made while the client is not connected (or while
+ * older queued publishes are still draining) are appended to an on-disk log
+ * and published, in order, at a bounded rate once the client is connected.
+ *
+ * The log is a directory of fixed-size, memory-mapped segment files. Records
+ * are only ever appended to the newest segment and consumed from the oldest;
+ * the read position is kept in each segment's header so queued publishes
+ * survive a restart. When the maximum number of segments is reached, the
+ * oldest segment (queued or not) is dropped to make room.
+ *
+ * @note Topic and payload are published directly from the mapped segment
+ *
+ * @note Each queued publish is synced to disk (msync) before
+ * 		::cxa_posix_mqtt_offlineQueue_publish returns, so it survives a crash
+ * 		or power loss. The read position is only flushed lazily, so after a
+ * 		power loss some already-sent publishes may be sent again.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_posix_mqtt_offlineQueue_t offlineQueue;
+ * cxa_posix_mqtt_offlineQueue_init(&offlineQueue, "/var/lib/myApp/mqttQueue", 64*1024, 16, mqttClient, threadId);
+ *
+ * // instead of cxa_mqtt_client_publish
+ * cxa_posix_mqtt_offlineQueue_publish(&offlineQueue, CXA_MQTT_QOS_ATLEAST_ONCE, false, "sensors/temp", &temp, sizeof(temp));
+ * @endcode
+ */
+#ifndef CXA_POSIX_MQTT_OFFLINEQUEUE_H_
+#define CXA_POSIX_MQTT_OFFLINEQUEUE_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_logger_header.h>
+#include <cxa_mqtt_client.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_MQTT_OFFLINEQUEUE_MAXLEN_DIR_BYTES
+	#define CXA_POSIX_MQTT_OFFLINEQUEUE_MAXLEN_DIR_BYTES			192
+#endif
+
+/**
+ * Period at which queued publishes are drained once connected
+ */
+#ifndef CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_PERIOD_MS
+	#define CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_PERIOD_MS				100
+#endif
+
+/**
+ * Default maximum number of queued publishes sent per drain period
+ * (see ::cxa_posix_mqtt_offlineQueue_setDrainRate)
+ */
+#ifndef CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_MAXNUM_PER_PERIOD
+	#define CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_MAXNUM_PER_PERIOD		10
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_mqtt_offlineQueue_t object
+ */
+typedef struct cxa_posix_mqtt_offlineQueue cxa_posix_mqtt_offlineQueue_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	uint32_t id;
+	int fd;
+	uint8_t* map;
+}cxa_posix_mqtt_offlineQueue_segment_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_mqtt_offlineQueue
+{
+	char dir[CXA_POSIX_MQTT_OFFLINEQUEUE_MAXLEN_DIR_BYTES];
+	size_t segmentSize_bytes;
+	size_t maxNumSegments;
+
+	// segments [firstSegmentId, lastSegmentId] exist on disk
+	uint32_t firstSegmentId;
+	uint32_t lastSegmentId;
+
+	cxa_posix_mqtt_offlineQueue_segment_t readSegment;
+	cxa_posix_mqtt_offlineQueue_segment_t writeSegment;
+	uint32_t writeOffset;
+
+	size_t numQueued;
+	size_t numDropped;
+	size_t drainMaxNumPerPeriod;
+
+	cxa_mqtt_client_t* client;
+	cxa_logger_t logger;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Opens (or creates) the queue in the given directory and starts draining
+ * 		it to the given client whenever it is connected
+ *
+ * @param[in] dirIn directory holding the segment files (created if needed)
+ * @param[in] segmentSize_bytesIn size of each segment file. This also limits
+ * 		the size of a single queued publish.
+ * @param[in] maxNumSegmentsIn maximum number of segment files (>= 2). Total
+ * 		disk usage is bounded by segmentSize_bytesIn * maxNumSegmentsIn.
+ *
+ * @return true if the queue was opened successfully
+ */
+bool cxa_posix_mqtt_offlineQueue_init(cxa_posix_mqtt_offlineQueue_t *const oqIn, const char *const dirIn,
+									  size_t segmentSize_bytesIn, size_t maxNumSegmentsIn,
+									  cxa_mqtt_client_t *const clientIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Publishes immediately if the client is connected and nothing is
+ * 		queued, otherwise queues the publish (preserving order)
+ *
+ * @return true if the publish was sent or queued
+ */
+bool cxa_posix_mqtt_offlineQueue_publish(cxa_posix_mqtt_offlineQueue_t *const oqIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+										 char *const topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn);
+
+
+/**
+ * @public
+ * @brief Sets the maximum number of queued publishes sent every
+ * 		CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_PERIOD_MS (to avoid flooding
+ * 		the broker after a long disconnect)
+ */
+void cxa_posix_mqtt_offlineQueue_setDrainRate(cxa_posix_mqtt_offlineQueue_t *const oqIn, size_t maxNumPerPeriodIn);
+
+
+/**
+ * @public
+ * @return the number of publishes currently queued
+ */
+size_t cxa_posix_mqtt_offlineQueue_getNumQueued(cxa_posix_mqtt_offlineQueue_t *const oqIn);
+
+
+/**
+ * @public
+ * @return the number of queued publishes dropped (oldest first) because the
+ * 		queue was full
+ */
+size_t cxa_posix_mqtt_offlineQueue_getNumDropped(cxa_posix_mqtt_offlineQueue_t *const oqIn);
+
+
+#endif // CXA_POSIX_MQTT_OFFLINEQUEUE_H_
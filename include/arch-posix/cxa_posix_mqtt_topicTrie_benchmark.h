@@ -0,0 +1,85 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a micro-benchmark for subscription dispatch using a
+ * ::cxa_mqtt_topicTrie_t (as done by ::cxa_mqtt_client_t for every received
+ * PUBLISH).
+ *
+ * A trie is built from numSubscriptions topic filters (a mix of exact, '+'
+ * and '#' filters under "site/<i>/...") and then matched against topics
+ * which each match three of them. The cost per match should stay (nearly)
+ * flat as subscriptions are added.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * const size_t counts[] = {8, 64, 512};
+ * for( size_t i = 0; i < sizeof(counts)/sizeof(*counts); i++ )
+ * {
+ * 	cxa_posix_mqtt_topicTrie_benchmark_results_t results;
+ * 	if( cxa_posix_mqtt_topicTrie_benchmark_measureMatch(counts[i], 100000, &results) )
+ * 	{
+ * 		cxa_posix_mqtt_topicTrie_benchmark_writeResults(&results, stdoutIoStream);
+ * 	}
+ * }
+ * @endcode
+ */
+#ifndef CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_H_
+#define CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_ioStream.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS
+	#define CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS		1024
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t numSubscriptions;
+	size_t numMatches;
+
+	size_t numMatchedEntries;				///< total matching subscriptions, across all matches
+	uint32_t match_nsPerCall;				///< mean cost of a single ::cxa_mqtt_topicTrie_match
+}cxa_posix_mqtt_topicTrie_benchmark_results_t;
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Builds a trie with numSubscriptionsIn filters and times numMatchesIn
+ * 		calls to ::cxa_mqtt_topicTrie_match
+ *
+ * @return false if numSubscriptionsIn is 0 / more than
+ * 		CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS
+ */
+bool cxa_posix_mqtt_topicTrie_benchmark_measureMatch(size_t numSubscriptionsIn, size_t numMatchesIn,
+													 cxa_posix_mqtt_topicTrie_benchmark_results_t *const resultsOut);
+
+
+/**
+ * @public
+ * @brief Writes the results as a single human-readable line
+ */
+void cxa_posix_mqtt_topicTrie_benchmark_writeResults(const cxa_posix_mqtt_topicTrie_benchmark_results_t *const resultsIn, cxa_ioStream_t *const ioStreamIn);
+
+
+#endif // CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_H_
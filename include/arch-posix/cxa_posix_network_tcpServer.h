@@ -0,0 +1,60 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_H_
+#define CXA_POSIX_NETWORK_TCPSERVER_H_
+
+
+// ******** includes ********
+#include <cxa_network_tcpServer.h>
+#include <cxa_ioStream.h>
+#include <cxa_posix_network_tcpServer_connectedClient.h>
+#include <cxa_stateMachine.h>
+
+
+// ******** global macro definitions ********
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS
+	#define CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS			4
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_network_tcpServer_t object
+ */
+typedef struct cxa_posix_network_tcpServer cxa_posix_network_tcpServer_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_network_tcpServer
+{
+	cxa_network_tcpServer_t super;
+
+	uint16_t portNumber;
+	bool isLoopbackOnly;
+	int listenSocket;
+
+	cxa_posix_network_tcpServer_connectedClient_t connectedClients[CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS];
+
+	cxa_stateMachine_t stateMachine;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes a non-blocking, BSD-sockets based tcpServer
+ *
+ * @param isLoopbackOnlyIn if true, only accept connections on 127.0.0.1
+ * 		(eg. for an in-process broker), otherwise listen on all interfaces
+ */
+void cxa_posix_network_tcpServer_init(cxa_posix_network_tcpServer_t *const netServerIn, bool isLoopbackOnlyIn, int threadIdIn);
+
+
+#endif // CXA_POSIX_NETWORK_TCPSERVER_H_
@@ -0,0 +1,58 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_POSIX_NETWORK_TCPSERVER_CONNECTEDCLIENT_H_
+#define CXA_POSIX_NETWORK_TCPSERVER_CONNECTEDCLIENT_H_
+
+
+// ******** includes ********
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <cxa_network_tcpServer_connectedClient.h>
+#include <cxa_timeDiff.h>
+
+
+// ******** global macro definitions ********
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_network_tcpServer_connectedClient_t object
+ */
+typedef struct cxa_posix_network_tcpServer_connectedClient cxa_posix_network_tcpServer_connectedClient_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_network_tcpServer_connectedClient
+{
+	cxa_network_tcpServer_connectedClient_t super;
+
+	int socket;
+	char descriptiveString[23];			// "aaa.bbb.ccc.ddd::eeeee"
+
+	cxa_timeDiff_t td_writeTimeout;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @protected
+ */
+void cxa_posix_network_tcpServer_connectedClient_initUnbound(cxa_posix_network_tcpServer_connectedClient_t *const ccIn);
+
+
+/**
+ * @public
+ */
+void cxa_posix_network_tcpServer_connectedClient_bindToSocket(cxa_posix_network_tcpServer_connectedClient_t *const ccIn,
+															  int socketIn,
+															  struct sockaddr_in * clientAddressIn);
+
+
+#endif // CXA_POSIX_NETWORK_TCPSERVER_CONNECTEDCLIENT_H_
@@ -0,0 +1,172 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains micro-benchmarks for the runLoop.
+ *
+ * ::cxa_posix_runLoop_benchmark_measureIterate measures the cost of a single
+ * ::cxa_runLoop_iterate with a given number of idle timed entries (entries
+ * whose period is long enough that they never come due during the
+ * measurement). With the timer wheel, this cost should stay flat as entries
+ * are added.
+ *
+ * ::cxa_posix_runLoop_benchmark_measurePost (requires
+ * CXA_RUNLOOP_POSTQUEUE_ENABLE) measures cross-thread throughput of
+ * ::cxa_runLoop_post: producer threads post callbacks as fast as the post
+ * queue accepts them while the calling thread iterates the runLoop.
+ *
+ * @note Since runLoop entries cannot be removed, timed entries are only ever
+ * 		added: measure with an increasing number of entries (eg. a sweep) and
+ * 		size CXA_RUNLOOP_MAXNUM_ENTRIES for the largest count.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * static cxa_posix_runLoop_benchmark_t bench;
+ * cxa_posix_runLoop_benchmark_init(&bench, CXA_RUNLOOP_THREADID_DEFAULT);
+ *
+ * const size_t counts[] = {0, 16, 64, 256};
+ * for( size_t i = 0; i < sizeof(counts)/sizeof(*counts); i++ )
+ * {
+ * 	cxa_posix_runLoop_benchmark_iterateResults_t results;
+ * 	if( cxa_posix_runLoop_benchmark_measureIterate(&bench, counts[i], 100000, &results) )
+ * 	{
+ * 		cxa_posix_runLoop_benchmark_writeIterateResults(&results, stdoutIoStream);
+ * 	}
+ * }
+ * @endcode
+ */
+#ifndef CXA_POSIX_RUNLOOP_BENCHMARK_H_
+#define CXA_POSIX_RUNLOOP_BENCHMARK_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_ioStream.h>
+#include <cxa_logger_header.h>
+#include <cxa_runLoop.h>
+
+
+// ******** global macro definitions ********
+/**
+ * Period of the idle timed entries (long enough they never execute during a measurement)
+ */
+#ifndef CXA_POSIX_RUNLOOP_BENCHMARK_IDLE_PERIOD_MS
+	#define CXA_POSIX_RUNLOOP_BENCHMARK_IDLE_PERIOD_MS				3600000
+#endif
+
+#ifndef CXA_POSIX_RUNLOOP_BENCHMARK_MAXNUM_PRODUCERS
+	#define CXA_POSIX_RUNLOOP_BENCHMARK_MAXNUM_PRODUCERS			8
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_posix_runLoop_benchmark_t object
+ */
+typedef struct cxa_posix_runLoop_benchmark cxa_posix_runLoop_benchmark_t;
+
+
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t numTimedEntries;
+	size_t numIterations;
+
+	uint32_t elapsed_ms;
+	uint32_t iterate_nsPerCall;				///< mean cost of a single ::cxa_runLoop_iterate
+}cxa_posix_runLoop_benchmark_iterateResults_t;
+
+
+/**
+ * @public
+ */
+typedef struct
+{
+	size_t numProducers;
+	size_t numPostsPerProducer;
+
+	size_t numExecuted;
+	size_t numQueueFull;					///< posts refused (post queue full) and retried
+
+	uint32_t elapsed_ms;					///< first post to last execution
+	uint32_t throughput_postsPerSec;
+}cxa_posix_runLoop_benchmark_postResults_t;
+
+
+/**
+ * @private
+ */
+struct cxa_posix_runLoop_benchmark
+{
+	int threadId;
+	size_t numTimedEntries;
+
+	// only touched by the runLoop thread
+	size_t numPostsExecuted;
+
+	cxa_logger_t logger;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the benchmark for the given (otherwise idle) runLoop thread
+ */
+void cxa_posix_runLoop_benchmark_init(cxa_posix_runLoop_benchmark_t *const benchIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Adds idle timed entries (until there are numTimedEntriesIn) and
+ * 		times numIterationsIn iterations of the runLoop
+ *
+ * @return false if numTimedEntriesIn is less than a previous measurement
+ * 		(entries can't be removed)
+ */
+bool cxa_posix_runLoop_benchmark_measureIterate(cxa_posix_runLoop_benchmark_t *const benchIn, size_t numTimedEntriesIn, size_t numIterationsIn,
+												cxa_posix_runLoop_benchmark_iterateResults_t *const resultsOut);
+
+
+/**
+ * @public
+ * @brief Writes the results as a single human-readable line
+ */
+void cxa_posix_runLoop_benchmark_writeIterateResults(const cxa_posix_runLoop_benchmark_iterateResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn);
+
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+/**
+ * @public
+ * @brief Starts numProducersIn threads which each post numPostsPerProducerIn
+ * 		callbacks to our runLoop thread, and iterates the runLoop (on the
+ * 		calling thread) until all have executed
+ *
+ * @return false if numProducersIn is 0 / more than
+ * 		CXA_POSIX_RUNLOOP_BENCHMARK_MAXNUM_PRODUCERS or a thread couldn't be started
+ */
+bool cxa_posix_runLoop_benchmark_measurePost(cxa_posix_runLoop_benchmark_t *const benchIn, size_t numProducersIn, size_t numPostsPerProducerIn,
+											 cxa_posix_runLoop_benchmark_postResults_t *const resultsOut);
+
+
+/**
+ * @public
+ * @brief Writes the results as a single human-readable line
+ */
+void cxa_posix_runLoop_benchmark_writePostResults(const cxa_posix_runLoop_benchmark_postResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn);
+#endif
+
+
+#endif // CXA_POSIX_RUNLOOP_BENCHMARK_H_
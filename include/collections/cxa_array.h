@@ -206,6 +206,21 @@ void* cxa_array_append_empty(cxa_array_t *const arrIn);
 bool cxa_array_remove_atIndex(cxa_array_t *const arrIn, const size_t indexIn);
 
 
+/**
+ * @public
+ * @brief Removes a range of contiguous elements from the array
+ * (moving all following elements down with a single memmove)
+ *
+ * @param[in] arrIn pointer to the pre-initialized cxa_array_t object
+ * @param[in] indexIn the index of the first element which should be removed
+ * @param[in] numElemsIn the number of elements to remove
+ *
+ * @return true if the elements were successfully removed, false on error
+ *		(range extends beyond the end of the array)
+ */
+bool cxa_array_removeRange(cxa_array_t *const arrIn, const size_t indexIn, const size_t numElemsIn);
+
+
 /**
  * @public
  * @brief Removes the element at the specified memory location from the
@@ -284,6 +299,42 @@ bool cxa_array_overwrite(cxa_array_t *const arrIn, const size_t indexIn, void *c
 bool cxa_array_insert(cxa_array_t *const arrIn, const size_t indexIn, void *const itemLocIn);
 
 
+/**
+ * @public
+ * @brief Inserts a range of contiguous elements at the specified index
+ * of the array. Subsequent elements are moved (single memmove) to make
+ * room for the insertion, then the new elements are copied (single memcpy).
+ *
+ * @param[in] arrIn pointer to the pre-initialized cxa_array_t object
+ * @param[in] indexIn the index of the first inserted element. MUST be less
+ * 		than or equal to ::cxa_getSize_elems.
+ * @param[in] itemsLocIn pointer to the contiguous elements which will be
+ * 		copied into the array
+ * @param[in] numElemsIn the number of elements to insert
+ *
+ * @return true on successful insertion, false on error
+ * 		(not enough space, invalid index)
+ */
+bool cxa_array_insertRange(cxa_array_t *const arrIn, const size_t indexIn, void *const itemsLocIn, const size_t numElemsIn);
+
+
+/**
+ * @public
+ * @brief Same as ::cxa_array_insertRange except that no data is copied
+ * into the new elements. Instead, a pointer to the first new element is
+ * returned so it may be initialized "in-place".
+ *
+ * @param[in] arrIn pointer to the pre-initialized cxa_array_t object
+ * @param[in] indexIn the index of the first inserted element. MUST be less
+ * 		than or equal to ::cxa_getSize_elems.
+ * @param[in] numElemsIn the number of elements to insert
+ *
+ * @return a pointer to the first new element within the array OR
+ * 		NULL on error (not enough space, invalid index)
+ */
+void* cxa_array_insertRange_empty(cxa_array_t *const arrIn, const size_t indexIn, const size_t numElemsIn);
+
+
 /**
  * @public
  * @brief Determines the size of the array (in number of elements).
@@ -0,0 +1,180 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a pool of fixed-size blocks carved out of a single
+ * statically allocated buffer. Free blocks are kept on an intrusive singly
+ * linked list, so reserving a block, releasing a block and finding the block
+ * that contains a given pointer are all constant time (regardless of the
+ * number of blocks in the pool).
+ *
+ * @note While a block is free, its first CXA_BLOCKPOOL_LINK_SIZE_BYTES are
+ * 		used to store the free list. Any other contents of a block are left
+ * 		untouched by the pool (so they are preserved across release/reserve).
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * typedef struct
+ * {
+ * 	void* poolLink;				// used by the pool while free
+ * 	uint8_t refCount;
+ * 	...
+ * }myEntry_t;
+ *
+ * cxa_blockPool_t myPool;
+ * myEntry_t myPool_entries[8];
+ *
+ * cxa_blockPool_initStd(&myPool, myPool_entries);
+ *
+ * myEntry_t* entry = cxa_blockPool_reserve(&myPool);
+ * ...
+ * // find an entry from a pointer to one of its members
+ * entry = cxa_blockPool_getBlock_byPointer(&myPool, &entry->refCount);
+ * ...
+ * cxa_blockPool_release(&myPool, entry);
+ * @endcode
+ */
+#ifndef CXA_BLOCKPOOL_H_
+#define CXA_BLOCKPOOL_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+/**
+ * @public
+ * Number of bytes at the start of each free block used by the pool
+ */
+#define CXA_BLOCKPOOL_LINK_SIZE_BYTES			sizeof(void*)
+
+
+/**
+ * @public
+ * @brief Shortcut to initialize the pool with an array of an explicit data type
+ *
+ * @param[in] poolIn pointer to the pool to initialize
+ * @param[in] bufferIn the declared c-style array whose elements will be
+ * 		the blocks of the pool
+ */
+#define cxa_blockPool_initStd(poolIn, bufferIn)			cxa_blockPool_init((poolIn), sizeof(*(bufferIn)), ((void*)(bufferIn)), sizeof(bufferIn))
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_blockPool_t object
+ */
+typedef struct cxa_blockPool cxa_blockPool_t;
+
+
+/**
+ * @private
+ */
+struct cxa_blockPool
+{
+	uint8_t* bufferLoc;
+	size_t blockSize_bytes;
+	size_t maxNumBlocks;
+
+	void* freeListHead;
+	size_t numReserved;
+
+	size_t highWaterMark;
+	size_t numExhausted;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the pool with all blocks free
+ *
+ * @param[in] poolIn pointer to the pre-allocated pool object
+ * @param[in] blockSize_bytesIn size of each block (at least
+ * 		CXA_BLOCKPOOL_LINK_SIZE_BYTES)
+ * @param[in] bufferLocIn buffer which will be divided into blocks. Must be
+ * 		suitably aligned to store a pointer.
+ * @param[in] bufferMaxSize_bytesIn size of bufferLocIn, in bytes
+ */
+void cxa_blockPool_init(cxa_blockPool_t *const poolIn, size_t blockSize_bytesIn, void *const bufferLocIn, size_t bufferMaxSize_bytesIn);
+
+
+/**
+ * @public
+ * @brief Reserves a free block from the pool
+ *
+ * @param[in] poolIn pointer to the pre-initialized pool
+ *
+ * @return pointer to the reserved block or NULL if the pool is exhausted
+ */
+void* cxa_blockPool_reserve(cxa_blockPool_t *const poolIn);
+
+
+/**
+ * @public
+ * @brief Returns a previously reserved block to the pool
+ *
+ * @param[in] poolIn pointer to the pre-initialized pool
+ * @param[in] blockIn pointer to the block (as returned by ::cxa_blockPool_reserve)
+ */
+void cxa_blockPool_release(cxa_blockPool_t *const poolIn, void *const blockIn);
+
+
+/**
+ * @public
+ * @brief Finds the block containing the given pointer (eg. a pointer
+ * 		to a member of a block's struct)
+ *
+ * @note This does not check whether the block is currently reserved
+ *
+ * @param[in] poolIn pointer to the pre-initialized pool
+ * @param[in] ptrIn the pointer to look up
+ *
+ * @return pointer to the start of the containing block, or NULL if the
+ * 		pointer does not point into this pool
+ */
+void* cxa_blockPool_getBlock_byPointer(cxa_blockPool_t *const poolIn, const void *const ptrIn);
+
+
+/**
+ * @public
+ * @return the number of blocks which are currently free
+ */
+size_t cxa_blockPool_getNumFree(cxa_blockPool_t *const poolIn);
+
+
+/**
+ * @public
+ * @return the total number of blocks in the pool
+ */
+size_t cxa_blockPool_getMaxNumBlocks(cxa_blockPool_t *const poolIn);
+
+
+/**
+ * @public
+ * @return the maximum number of blocks that have been reserved at the same time
+ */
+size_t cxa_blockPool_getHighWaterMark(cxa_blockPool_t *const poolIn);
+
+
+/**
+ * @public
+ * @return the number of times ::cxa_blockPool_reserve failed because
+ * 		the pool was exhausted
+ */
+size_t cxa_blockPool_getNumExhausted(cxa_blockPool_t *const poolIn);
+
+
+#endif // CXA_BLOCKPOOL_H_
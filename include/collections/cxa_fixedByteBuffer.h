@@ -127,6 +127,9 @@ typedef struct cxa_fixedByteBuffer cxa_fixedByteBuffer_t;
 struct cxa_fixedByteBuffer
 {
 	cxa_array_t bytes;
+
+	size_t headroom_bytes;
+	size_t initialHeadroom_bytes;
 };
 
 
@@ -160,6 +163,31 @@ void cxa_fixedByteBuffer_init(cxa_fixedByteBuffer_t *const fbbIn, void *const bu
 void cxa_fixedByteBuffer_init_inPlace(cxa_fixedByteBuffer_t *const fbbIn, const size_t currNumElemsIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn);
 
 
+/**
+ * @public
+ * @brief Initializes the pre-allocated fixedByteBuffer, reserving the specified
+ *		number of bytes at the front of the buffer as "headroom".
+ *
+ * Inserting bytes near the front of the buffer (eg. prepending headers) will
+ * move the (few) leading bytes down into the headroom rather than moving all
+ * following bytes up, so a prepend costs O(index) rather than O(size). Likewise,
+ * removing bytes near the front returns them to the headroom. The headroom is
+ * still counted towards ::cxa_fixedByteBuffer_getMaxSize_bytes: if an append
+ * needs the space, the contents are moved to the start of the buffer (once).
+ * ::cxa_fixedByteBuffer_clear restores the initial headroom.
+ *
+ * @note the address of the data (::cxa_fixedByteBuffer_get_pointerToStartOfData)
+ *		may change with structure-modifying operations
+ *
+ * @param[in] fbbIn pointer to the pre-allocated fixedByteBuffer object
+ * @param[in] bufferLocIn pointer to the pre-allocated chunk of memory that will
+ * 		be used to store elements in the buffer
+ * @param[in] bufferMaxSize_bytesIn the maximum size of the chunk of memory (buffer) in bytes
+ * @param[in] headroom_bytesIn the number of bytes to reserve at the front of the buffer
+ */
+void cxa_fixedByteBuffer_init_withHeadroom(cxa_fixedByteBuffer_t *const fbbIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn, const size_t headroom_bytesIn);
+
+
 /**
  * @public
  * @brief Initializes a new subBuffer whose bytes are stored within another fixedByteBuffer. This
@@ -400,4 +428,17 @@ bool cxa_fixedByteBuffer_isEmpty(cxa_fixedByteBuffer_t *const fbbIn);
 void cxa_fixedByteBuffer_clear(cxa_fixedByteBuffer_t *const fbbIn);
 
 
+/**
+ * @public
+ * @brief Determines the number of bytes currently available at the
+ * front of this buffer for O(1)-ish prepends.
+ * See ::cxa_fixedByteBuffer_init_withHeadroom.
+ *
+ * @param[in] fbbIn pointer to the pre-initialized fixedByteBuffer object
+ *
+ * @return the number of bytes of headroom
+ */
+size_t cxa_fixedByteBuffer_getHeadroom_bytes(cxa_fixedByteBuffer_t *const fbbIn);
+
+
 #endif // CXA_FIXED_BYTE_BUFFER_H_
@@ -258,7 +258,14 @@ bool cxa_fixedFifo_dequeue(cxa_fixedFifo_t *const fifoIn, void *elemOut);
 
 /**
  * @public
- * @brief Convenience function for queueing multiple contiguous elements in one call.
+ * @brief Queues multiple contiguous elements in one call.
+ *
+ * Elements are copied using (at most) two memcpy operations: one up to the
+ * end of the underlying buffer and one from the start of the buffer.
+ * If the FIFO does not have room for all elements and was initialized with
+ * ::CXA_FF_ON_FULL_DROP, as many elements as will fit are queued. If it was
+ * initialized with ::CXA_FF_ON_FULL_DEQUEUE, the oldest elements are dequeued
+ * to make room.
  *
  * @param[in] fifoIn pointer to the pre-initialized FIFO object
  * @param[in] elemsIn pointer to the contiguous elements which will be copied into
@@ -272,11 +279,45 @@ bool cxa_fixedFifo_dequeue(cxa_fixedFifo_t *const fifoIn, void *elemOut);
 bool cxa_fixedFifo_bulkQueue(cxa_fixedFifo_t *const fifoIn, void *const elemsIn, size_t numElemsIn);
 
 
+/**
+ * @public
+ * @brief Reserves a contiguous region of free elements (within the FIFO buffer
+ * 		itself) so a producer can write elements in-place. Written elements
+ * 		are not visible to the consumer until ::cxa_fixedFifo_bulkQueue_commit
+ * 		is called.
+ *
+ * The number of contiguous elements _may_ be less than the number of free
+ * elements in the FIFO (if the region wraps around the end of the buffer). In
+ * this case, commit the first region and reserve again.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemsOut a pointer that will be set with the address of the first
+ * 		free element
+ *
+ * @return the number of contiguous elements which may be written
+ */
+size_t cxa_fixedFifo_bulkQueue_reserve(cxa_fixedFifo_t *const fifoIn, void **const elemsOut);
+
+
+/**
+ * @public
+ * @brief Commits elements previously written into a region returned by
+ * 		::cxa_fixedFifo_bulkQueue_reserve.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] numElemsIn the number of elements that were written
+ *
+ * @return true on success, false if numElemsIn exceeds the reserved region
+ */
+bool cxa_fixedFifo_bulkQueue_commit(cxa_fixedFifo_t *const fifoIn, size_t numElemsIn);
+
+
 /**
  * @public
  * @brief Convenience function for dequeueing multiple elements in one call. This
  * 		function doesn't copy any elements out of the queue so should be used
- * 		in concert with ::cxa_fixedFifo_bulkDequeue_peek.
+ * 		in concert with ::cxa_fixedFifo_bulkDequeue_peek (which, together, act
+ * 		as a peek-in-place / consume pair). Constant time regardless of numElemsIn.
  *
  * @param[in] fifoIn pointer to the pre-initialized FIFO object
  * @param[in] numElemsIn number of elements to dequeue from the FIFO.
@@ -286,6 +327,20 @@ bool cxa_fixedFifo_bulkQueue(cxa_fixedFifo_t *const fifoIn, void *const elemsIn,
 bool cxa_fixedFifo_bulkDequeue(cxa_fixedFifo_t *const fifoIn, size_t numElemsIn);
 
 
+/**
+ * @public
+ * @brief Dequeues up to maxNumElemsIn elements, copying them into the
+ * 		supplied buffer using (at most) two memcpy operations.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemsOut buffer which will receive the dequeued elements
+ * @param[in] maxNumElemsIn the maximum number of elements to dequeue
+ *
+ * @return the number of elements actually dequeued
+ */
+size_t cxa_fixedFifo_bulkDequeue_copy(cxa_fixedFifo_t *const fifoIn, void *const elemsOut, size_t maxNumElemsIn);
+
+
 /**
  * @public
  * @brief 'Peeks' at the queue and determines the maximum number of contiguous elements
@@ -72,7 +72,14 @@ struct cxa_fixedByteBuffer_linkedField
 	cxa_linkedField_t* prev;
 	cxa_linkedField_t* next;
 
+	// cached (updated as fields before us change size)
 	size_t startIndex;
+	size_t numUnfilledFixedFieldsUpChain;
+
+	// cached chain-wide state (so sizes can be computed without walking the chain)
+	cxa_linkedField_t* root;
+	cxa_linkedField_t* tail;					///< only maintained on the root
+	size_t fixedLengthUpChain_bytes;			///< maxFixedLength_bytes of us and every fixed field before us
 
 	bool isFixedLength;
 	size_t maxFixedLength_bytes;
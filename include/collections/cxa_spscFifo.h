@@ -0,0 +1,310 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a lock-free, single-producer / single-consumer variant of
+ * ::cxa_fixedFifo_t. Exactly one context (thread, task, or ISR) may queue and
+ * exactly one (other) context may dequeue without the use of a critical section.
+ *
+ * Unlike ::cxa_fixedFifo_t:
+ *   - the number of elements in the buffer must be a power of two (indices are masked)
+ *   - the FIFO always drops on full (the producer cannot dequeue)
+ *   - the full buffer capacity is usable (no sentinel element)
+ *
+ * Each side caches the last index it observed from the other side, so it only
+ * touches the shared cache line when that cached view is exhausted. Bulk
+ * operations publish their index once per call.
+ *
+ * @note Requires C11 atomics (stdatomic.h)
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_spscFifo_t myFifo;
+ * uint8_t myFifo_buffer[256];
+ *
+ * cxa_spscFifo_initStd(&myFifo, myFifo_buffer);
+ *
+ * // producer thread
+ * cxa_spscFifo_bulkQueue(&myFifo, rxBytes, numRxBytes);
+ *
+ * // consumer (runLoop) thread
+ * uint8_t tmp[32];
+ * size_t numBytes = cxa_spscFifo_bulkDequeue_copy(&myFifo, tmp, sizeof(tmp));
+ * @endcode
+ */
+#ifndef CXA_SPSC_FIFO_H_
+#define CXA_SPSC_FIFO_H_
+
+
+// ******** includes ********
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+/**
+ * @public
+ * Size of a cache line on the target architecture. The producer and
+ * consumer indices are placed on separate cache lines to avoid false sharing.
+ */
+#ifndef CXA_SPSCFIFO_CACHELINE_SIZE_BYTES
+	#define CXA_SPSCFIFO_CACHELINE_SIZE_BYTES			64
+#endif
+
+
+/**
+ * @public
+ * @brief Shortcut to initialize the fifo with a buffer of an explict data type
+ *
+ * @param[in] fifoIn pointer to FIFO to initialize
+ * @param[in] bufferIn pointer to the declared c-style array which
+ * 		will contain the data for the FIFO (number of elements must be a power of two)
+ */
+#define cxa_spscFifo_initStd(fifoIn, bufferIn)						cxa_spscFifo_init((fifoIn), sizeof(*(bufferIn)), ((void*)(bufferIn)), sizeof(bufferIn))
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_spscFifo_t object
+ */
+typedef struct cxa_spscFifo cxa_spscFifo_t;
+
+
+/**
+ * @private
+ */
+struct cxa_spscFifo
+{
+	// written by the producer, read by the consumer
+	_Alignas(CXA_SPSCFIFO_CACHELINE_SIZE_BYTES) atomic_size_t insertIndex;
+	size_t prod_cachedRemoveIndex;
+
+	// written by the consumer, read by the producer
+	_Alignas(CXA_SPSCFIFO_CACHELINE_SIZE_BYTES) atomic_size_t removeIndex;
+	size_t cons_cachedInsertIndex;
+
+	// constant after init
+	_Alignas(CXA_SPSCFIFO_CACHELINE_SIZE_BYTES) void *bufferLoc;
+	size_t datatypeSize_bytes;
+	size_t maxNumElements;
+	size_t indexMask;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the FIFO using the specified buffer (which is empty) to store elements
+ *
+ * @param[in] fifoIn pointer to the pre-allocated cxa_spscFifo_t object
+ * @param[in] datatypeSize_bytesIn the size of each element that will be inserted
+ * 		into the FIFO (all elements MUST be the same size)
+ * @param[in] bufferLocIn pointer to the pre-allocated chunk of memory that will
+ * 		be used to store elements in the FIFO (the buffer)
+ * @param[in] bufferMaxSize_bytesIn the maximum size of the chunk of memory (buffer) in bytes.
+ * 		bufferMaxSize_bytesIn / datatypeSize_bytesIn must be a power of two.
+ */
+void cxa_spscFifo_init(cxa_spscFifo_t *const fifoIn, const size_t datatypeSize_bytesIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn);
+
+
+/**
+ * @public
+ * @brief Clears the contents of the FIFO
+ *
+ * @note NOT safe to call while either the producer or consumer is active
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ */
+void cxa_spscFifo_clear(cxa_spscFifo_t *const fifoIn);
+
+
+/**
+ * @public
+ * @brief Queues an element in the FIFO (producer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] elemIn pointer to the element which will be copied
+ * 		into the FIFO's buffer
+ *
+ * @return true if the element was queued, false if the FIFO was full
+ */
+bool cxa_spscFifo_queue(cxa_spscFifo_t *const fifoIn, void *const elemIn);
+
+
+/**
+ * @public
+ * @brief Queues multiple contiguous elements in one call (producer only).
+ * 		As many elements as will fit are queued using (at most) two memcpy
+ * 		operations, and are published to the consumer at once.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] elemsIn pointer to the contiguous elements which will be copied into
+ * 		the FIFO's buffer
+ * @param[in] numElemsIn the number of elements to copy into the buffer.
+ *
+ * @return true if all elements were queued, false if the FIFO filled first
+ */
+bool cxa_spscFifo_bulkQueue(cxa_spscFifo_t *const fifoIn, void *const elemsIn, size_t numElemsIn);
+
+
+/**
+ * @public
+ * @brief Reserves a contiguous region of free elements for in-place writes
+ * 		(producer only). See ::cxa_fixedFifo_bulkQueue_reserve.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemsOut a pointer that will be set with the address of the first
+ * 		free element
+ *
+ * @return the number of contiguous elements which may be written
+ */
+size_t cxa_spscFifo_bulkQueue_reserve(cxa_spscFifo_t *const fifoIn, void **const elemsOut);
+
+
+/**
+ * @public
+ * @brief Publishes elements previously written into a region returned by
+ * 		::cxa_spscFifo_bulkQueue_reserve (producer only).
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] numElemsIn the number of elements that were written
+ *
+ * @return true on success, false if numElemsIn exceeds the free space
+ */
+bool cxa_spscFifo_bulkQueue_commit(cxa_spscFifo_t *const fifoIn, size_t numElemsIn);
+
+
+/**
+ * @public
+ * @brief "Peeks" at the next element in the FIFO (consumer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemOut pointer to where the element should be copied. May be
+ * 		NULL if no copy is desired.
+ *
+ * @return true if the FIFO was not empty
+ */
+bool cxa_spscFifo_peek(cxa_spscFifo_t *const fifoIn, void *elemOut);
+
+
+/**
+ * @public
+ * @brief Dequeues an element from the FIFO (consumer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemOut pointer to where the element should be copied. May be
+ * 		NULL if no copy is desired.
+ *
+ * @return true if the FIFO was not empty, false if the FIFO was empty
+ */
+bool cxa_spscFifo_dequeue(cxa_spscFifo_t *const fifoIn, void *elemOut);
+
+
+/**
+ * @public
+ * @brief Dequeues up to maxNumElemsIn elements, copying them into the
+ * 		supplied buffer using (at most) two memcpy operations (consumer only)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemsOut buffer which will receive the dequeued elements
+ * @param[in] maxNumElemsIn the maximum number of elements to dequeue
+ *
+ * @return the number of elements actually dequeued
+ */
+size_t cxa_spscFifo_bulkDequeue_copy(cxa_spscFifo_t *const fifoIn, void *const elemsOut, size_t maxNumElemsIn);
+
+
+/**
+ * @public
+ * @brief Returns the address and number of contiguous elements available
+ * 		for in-place reads (consumer only). See ::cxa_fixedFifo_bulkDequeue_peek.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[out] elemsOut a pointer that will be set with the address of the first
+ * 		element slated for dequeue
+ *
+ * @return the number of contiguous elements available for dequeue
+ */
+size_t cxa_spscFifo_bulkDequeue_peek(cxa_spscFifo_t *const fifoIn, void **const elemsOut);
+
+
+/**
+ * @public
+ * @brief Releases elements previously read in-place (consumer only).
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ * @param[in] numElemsIn number of elements to dequeue from the FIFO.
+ *
+ * @return true if the desired number of elements were dequeued, false if not
+ */
+bool cxa_spscFifo_bulkDequeue(cxa_spscFifo_t *const fifoIn, size_t numElemsIn);
+
+
+/**
+ * @public
+ * @brief Determines the size of the FIFO (in number of elements).
+ * 		Only a snapshot if called while the other side is active.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return the size of the FIFO, in number of elements
+ */
+size_t cxa_spscFifo_getSize_elems(cxa_spscFifo_t *const fifoIn);
+
+
+/**
+ * @public
+ * @brief Determines the number of free spots/elements in the FIFO.
+ * 		Only a snapshot if called while the other side is active.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return the number of free elements in the FIFO
+ */
+size_t cxa_spscFifo_getFreeSize_elems(cxa_spscFifo_t *const fifoIn);
+
+
+/**
+ * @public
+ * @brief Determines the maximum number of elements in the FIFO.
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return the maximum number of the elements the FIFO can hold
+ */
+size_t cxa_spscFifo_getMaxSize_elems(cxa_spscFifo_t *const fifoIn);
+
+
+/**
+ * @public
+ * @brief Determines whether the FIFO is empty (does not hold any elements)
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return true if the FIFO does not current contain any elements
+ */
+bool cxa_spscFifo_isEmpty(cxa_spscFifo_t *const fifoIn);
+
+
+/**
+ * @public
+ * @brief Determines whether the FIFO is full (cannot hold any more elements).
+ *
+ * @param[in] fifoIn pointer to the pre-initialized FIFO object
+ *
+ * @return true if the FIFO cannot hold any more elements
+ */
+bool cxa_spscFifo_isFull(cxa_spscFifo_t *const fifoIn);
+
+
+#endif // CXA_SPSC_FIFO_H_
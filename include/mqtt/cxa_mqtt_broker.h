@@ -0,0 +1,338 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a small, statically allocated MQTT (3.1.1) broker which
+ * runs inside an existing process / runLoop. Clients connect through a
+ * ::cxa_network_tcpServer and/or through ioStreams attached directly to the
+ * broker (eg. one end of a ::cxa_ioStream_pipe for an in-process client).
+ * Received publishes are fanned out to every matching subscription using a
+ * ::cxa_mqtt_topicTrie, and may also be consumed (or injected) locally using
+ * ::cxa_mqtt_broker_subscribe / ::cxa_mqtt_broker_publish, which makes the
+ * broker usable as an edge aggregator as well as a local stand-in for a
+ * remote broker (eg. for integration tests and benchmarks with no network).
+ *
+ * Supported: CONNECT (clean sessions only) with optional authentication,
+ * SUBSCRIBE (multiple topic filters, granted at QoS0), PUBLISH at QoS0/1/2
+ * (inbound QoS2 duplicates are suppressed), PINGREQ, keepalive timeouts.
+ *
+ * Not supported: retained messages, will messages, persistent sessions,
+ * UNSUBSCRIBE and outbound QoS1/2 (all deliveries are QoS0).
+ *
+ * @note Each connection slot holds one message from the ::cxa_mqtt_messageFactory
+ * 		for reception, plus one runLoop entry for its protocol parser. Size
+ * 		CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES and CXA_RUNLOOP_MAXNUM_ENTRIES
+ * 		accordingly.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_posix_network_tcpServer_t tcpServer;
+ * cxa_mqtt_broker_t broker;
+ *
+ * cxa_posix_network_tcpServer_init(&tcpServer, true, CXA_RUNLOOP_THREADID_DEFAULT);
+ * cxa_mqtt_broker_init(&broker, &tcpServer.super, CXA_RUNLOOP_THREADID_DEFAULT);
+ * cxa_network_tcpServer_listen(&tcpServer.super, 1883);
+ *
+ * // in-process client (no network)
+ * cxa_ioStream_pipe_init(&pipe);
+ * cxa_mqtt_broker_attachIoStream(&broker, cxa_ioStream_pipe_getEndpoint2(&pipe));
+ * cxa_mqtt_client_init(&client, cxa_ioStream_pipe_getEndpoint1(&pipe), 60, "myClient", CXA_RUNLOOP_THREADID_DEFAULT);
+ * @endcode
+ */
+#ifndef CXA_MQTT_BROKER_H_
+#define CXA_MQTT_BROKER_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <cxa_array.h>
+#include <cxa_ioStream.h>
+#include <cxa_ioStream_nullablePassthrough.h>
+#include <cxa_logger_header.h>
+#include <cxa_mqtt_message.h>
+#include <cxa_mqtt_topicTrie.h>
+#include <cxa_network_tcpServer.h>
+#include <cxa_protocolParser_mqtt.h>
+#include <cxa_timeDiff.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+/**
+ * Maximum number of simultaneously connected clients (tcpServer connections
+ * and attached ioStreams combined)
+ */
+#ifndef CXA_MQTT_BROKER_MAXNUM_CONNECTIONS
+	#define CXA_MQTT_BROKER_MAXNUM_CONNECTIONS				4
+#endif
+
+/**
+ * Maximum number of topic filters subscribed, across all connections
+ * (including local subscriptions)
+ */
+#ifndef CXA_MQTT_BROKER_MAXNUM_SUBSCRIPTIONS
+	#define CXA_MQTT_BROKER_MAXNUM_SUBSCRIPTIONS			16
+#endif
+
+/**
+ * Maximum number of levels in a subscribed topic filter (eg. "a/+/c" has 3).
+ * Deeper filters are refused.
+ */
+#ifndef CXA_MQTT_BROKER_MAXNUM_TOPICFILTER_LEVELS
+	#define CXA_MQTT_BROKER_MAXNUM_TOPICFILTER_LEVELS		8
+#endif
+
+/**
+ * Number of nodes in the subscription topic trie (one for the root,
+ * plus one per unique topic filter prefix). The default fits every
+ * subscription at the maximum depth, even if they share no prefixes.
+ */
+#ifndef CXA_MQTT_BROKER_MAXNUM_TOPICTRIE_NODES
+	#define CXA_MQTT_BROKER_MAXNUM_TOPICTRIE_NODES			(1 + (CXA_MQTT_BROKER_MAXNUM_TOPICFILTER_LEVELS * CXA_MQTT_BROKER_MAXNUM_SUBSCRIPTIONS))
+#endif
+
+#ifndef CXA_MQTT_BROKER_MAXLEN_CLIENTID_BYTES
+	#define CXA_MQTT_BROKER_MAXLEN_CLIENTID_BYTES			23
+#endif
+
+#ifndef CXA_MQTT_BROKER_MAXLEN_TOPICFILTER_BYTES
+	#define CXA_MQTT_BROKER_MAXLEN_TOPICFILTER_BYTES		72
+#endif
+
+/**
+ * Topic names of publishes are copied (null-terminated) when a new PUBLISH
+ * must be built for delivery, longer topics are dropped
+ */
+#ifndef CXA_MQTT_BROKER_MAXLEN_TOPICNAME_BYTES
+	#define CXA_MQTT_BROKER_MAXLEN_TOPICNAME_BYTES			128
+#endif
+
+/**
+ * Number of received QoS2 publishes (awaiting PUBREL) tracked per connection
+ * to suppress duplicate delivery
+ */
+#ifndef CXA_MQTT_BROKER_MAXNUM_INBOUND_QOS2
+	#define CXA_MQTT_BROKER_MAXNUM_INBOUND_QOS2				4
+#endif
+
+/**
+ * Time a new connection has to send its CONNECT before it is closed
+ */
+#ifndef CXA_MQTT_BROKER_CONNECT_TIMEOUT_MS
+	#define CXA_MQTT_BROKER_CONNECT_TIMEOUT_MS				10000
+#endif
+
+/**
+ * Period at which connections are checked for keepalive timeouts
+ * (1.5x the keepalive requested in the CONNECT) and closed sockets
+ */
+#ifndef CXA_MQTT_BROKER_HOUSEKEEPING_PERIOD_MS
+	#define CXA_MQTT_BROKER_HOUSEKEEPING_PERIOD_MS			1000
+#endif
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_mqtt_broker_t object
+ */
+typedef struct cxa_mqtt_broker cxa_mqtt_broker_t;
+
+
+/**
+ * @public
+ * @brief Called for each CONNECT (if set)
+ *
+ * @param[in] usernameIn / passwordIn NULL if not provided by the client
+ * 		(strings are NOT null-terminated)
+ *
+ * @return true to accept the connection, false to refuse it
+ * 		(CONNACK: bad username or password)
+ */
+typedef bool (*cxa_mqtt_broker_cb_authenticateClient_t)(char *const clientIdIn, size_t clientIdLen_bytesIn,
+														char *const usernameIn, size_t usernameLen_bytesIn,
+														uint8_t *const passwordIn, size_t passwordLen_bytesIn,
+														void *const userVarIn);
+
+
+/**
+ * @public
+ * @brief Called for each publish matching a local subscription. May publish
+ * 		or detach / close connections (their subscriptions are removed once
+ * 		the current publish has been delivered).
+ *
+ * @param[in] topicNameIn topic of the publish (NOT null-terminated)
+ */
+typedef void (*cxa_mqtt_broker_cb_onPublish_t)(char *const topicNameIn, size_t topicNameLen_bytesIn,
+											   void *const payloadIn, size_t payloadLen_bytesIn,
+											   void *const userVarIn);
+
+
+/**
+ * @private
+ */
+typedef enum
+{
+	CXA_MQTT_BROKER_CONNSTATE_FREE,
+	CXA_MQTT_BROKER_CONNSTATE_AWAITING_CONNECT,
+	CXA_MQTT_BROKER_CONNSTATE_CONNECTED
+}cxa_mqtt_broker_connectionState_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	cxa_mqtt_broker_t* broker;
+	cxa_mqtt_broker_connectionState_t state;
+
+	// NULL for directly attached ioStreams
+	cxa_network_tcpServer_connectedClient_t* tcpClient;
+
+	// gives the (persistent) protocol parser a stable ioStream
+	// while connections come and go
+	cxa_ioStream_nullablePassthrough_t ios;
+	cxa_protocolParser_mqtt_t mpp;
+	bool isParserResetPending;
+
+	char clientId[CXA_MQTT_BROKER_MAXLEN_CLIENTID_BYTES+1];
+	uint16_t keepAlive_s;
+	cxa_timeDiff_t td_lastRx;
+
+	cxa_array_t inboundQos2PacketIds;
+	uint16_t inboundQos2PacketIds_raw[CXA_MQTT_BROKER_MAXNUM_INBOUND_QOS2];
+
+	// each publish is delivered at most once per connection, even with overlapping subscriptions
+	uint32_t lastDeliverySeq;
+}cxa_mqtt_broker_connection_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	// NULL for local subscriptions
+	cxa_mqtt_broker_connection_t* connection;
+
+	char topicFilter[CXA_MQTT_BROKER_MAXLEN_TOPICFILTER_BYTES+1];
+
+	cxa_mqtt_broker_cb_onPublish_t cb_onPublish;
+	void* userVar;
+
+	// removed while a publish was being delivered (see removeSubscriptions)
+	bool isRemoved;
+}cxa_mqtt_broker_subscription_t;
+
+
+/**
+ * @private
+ */
+struct cxa_mqtt_broker
+{
+	cxa_network_tcpServer_t* tcpServer;
+
+	cxa_mqtt_broker_connection_t connections[CXA_MQTT_BROKER_MAXNUM_CONNECTIONS];
+
+	cxa_array_t subscriptions;
+	cxa_mqtt_broker_subscription_t subscriptions_raw[CXA_MQTT_BROKER_MAXNUM_SUBSCRIPTIONS];
+
+	// entry index == index into subscriptions (rebuilt when subscriptions are removed)
+	cxa_mqtt_topicTrie_t subscriptionTrie;
+	cxa_mqtt_topicTrie_node_t subscriptionTrie_nodes_raw[CXA_MQTT_BROKER_MAXNUM_TOPICTRIE_NODES];
+	uint16_t subscriptionTrie_entryNext_raw[CXA_MQTT_BROKER_MAXNUM_SUBSCRIPTIONS];
+
+	cxa_mqtt_broker_cb_authenticateClient_t cb_authenticate;
+	void* authenticateUserVar;
+
+	uint32_t currDeliverySeq;
+
+	// subscriptions can't be removed while the trie is being matched
+	size_t deliveryDepth;
+	bool isRemovalPending;
+
+	cxa_logger_t logger;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes the broker
+ *
+ * @param[in] tcpServerIn server whose connections should be handled
+ * 		by this broker (may be NULL if only attached ioStreams are used).
+ * 		The broker listens for connections but does not start listening.
+ */
+void cxa_mqtt_broker_init(cxa_mqtt_broker_t *const brokerIn, cxa_network_tcpServer_t *const tcpServerIn, int threadIdIn);
+
+
+/**
+ * @public
+ * @brief Sets the callback used to accept / refuse clients. Without it,
+ * 		all clients are accepted.
+ */
+void cxa_mqtt_broker_setAuthenticationCallback(cxa_mqtt_broker_t *const brokerIn,
+											   cxa_mqtt_broker_cb_authenticateClient_t cb_authenticateIn, void *const userVarIn);
+
+
+/**
+ * @public
+ * @brief Treats the given (bound) ioStream as a newly established connection.
+ * 		The client must send a CONNECT as it would over the network.
+ *
+ * @return false if there are no free connection slots
+ */
+bool cxa_mqtt_broker_attachIoStream(cxa_mqtt_broker_t *const brokerIn, cxa_ioStream_t *const ioStreamIn);
+
+
+/**
+ * @public
+ * @brief Closes the connection using the given (previously attached)
+ * 		ioStream and removes its subscriptions
+ */
+void cxa_mqtt_broker_detachIoStream(cxa_mqtt_broker_t *const brokerIn, cxa_ioStream_t *const ioStreamIn);
+
+
+/**
+ * @public
+ * @brief Subscribes locally (within this process) to publishes from all clients
+ * 		(and from ::cxa_mqtt_broker_publish)
+ *
+ * @param[in] topicFilterIn null-terminated topic filter (copied)
+ *
+ * @return false if the filter is malformed / too long / deeper than
+ * 		CXA_MQTT_BROKER_MAXNUM_TOPICFILTER_LEVELS or there are no free subscriptions
+ */
+bool cxa_mqtt_broker_subscribe(cxa_mqtt_broker_t *const brokerIn, char *const topicFilterIn,
+							   cxa_mqtt_broker_cb_onPublish_t cb_onPublishIn, void *const userVarIn);
+
+
+/**
+ * @public
+ * @brief Publishes (at QoS0) from within this process to all matching
+ * 		subscriptions (local and connected clients)
+ *
+ * @param[in] topicNameIn null-terminated topic name
+ *
+ * @return the number of subscriptions the publish was delivered to
+ */
+size_t cxa_mqtt_broker_publish(cxa_mqtt_broker_t *const brokerIn, char *const topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn);
+
+
+/**
+ * @public
+ * @return the number of clients which have completed their CONNECT
+ */
+size_t cxa_mqtt_broker_getNumConnectedClients(cxa_mqtt_broker_t *const brokerIn);
+
+
+#endif // CXA_MQTT_BROKER_H_
@@ -13,6 +13,7 @@
 #include <cxa_ioStream.h>
 #include <cxa_logger_header.h>
 #include <cxa_mqtt_message.h>
+#include <cxa_mqtt_topicTrie.h>
 #include <cxa_protocolParser_mqtt.h>
 #include <cxa_stateMachine.h>
 #include <cxa_timeDiff.h>
@@ -28,6 +29,59 @@
 	#define CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS			2
 #endif
 
+/**
+ * Maximum number of levels in a subscribed topic filter (eg. "a/+/c" has 3).
+ * Deeper filters are rejected when subscribing.
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_TOPICFILTER_LEVELS
+	#define CXA_MQTT_CLIENT_MAXNUM_TOPICFILTER_LEVELS		8
+#endif
+
+/**
+ * Number of nodes in the subscription topic trie (one for the root,
+ * plus one per unique topic filter prefix). The default fits every
+ * subscription at the maximum depth, even if they share no prefixes.
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES
+	#define CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES			(1 + (CXA_MQTT_CLIENT_MAXNUM_TOPICFILTER_LEVELS * CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS))
+#endif
+
+/**
+ * Maximum number of QoS1/QoS2 publishes which may be awaiting acknowledgement
+ * at once. Each in-flight QoS1 (or not-yet-received QoS2) publish holds a
+ * reference to its message so it can be retransmitted, so the message factory
+ * must be sized to match (small publishes use the smallest size class that fits).
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_INFLIGHT
+	#define CXA_MQTT_CLIENT_MAXNUM_INFLIGHT					4
+#endif
+
+/**
+ * Time after which an unacknowledged in-flight publish (or PUBREL) is
+ * retransmitted while connected
+ */
+#ifndef CXA_MQTT_CLIENT_INFLIGHT_RETRANSMIT_MS
+	#define CXA_MQTT_CLIENT_INFLIGHT_RETRANSMIT_MS			10000
+#endif
+
+/**
+ * Number of received QoS2 publishes (awaiting PUBREL) which are tracked
+ * to suppress duplicate delivery
+ */
+#ifndef CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2
+	#define CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2				4
+#endif
+
+/**
+ * Define CXA_MQTT_CLIENT_TXCOALESCE_ENABLE to allow outgoing packets to be
+ * coalesced into fewer (larger) writes to the underlying ioStream
+ * (see ::cxa_mqtt_client_setWriteCoalescing). This is the size of the
+ * per-client buffer used to do so.
+ */
+#ifndef CXA_MQTT_CLIENT_TXCOALESCE_BUFFER_SIZE_BYTES
+	#define CXA_MQTT_CLIENT_TXCOALESCE_BUFFER_SIZE_BYTES	512
+#endif
+
 
 #ifndef CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES
 	#define CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES		72
@@ -65,6 +119,45 @@ typedef void (*cxa_mqtt_client_cb_onActivity_t)(cxa_mqtt_client_t *const clientI
 typedef void (*cxa_mqtt_client_cb_onPublish_t)(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
 		char* topicNameIn, size_t topicNameLen_bytesIn, void* payloadIn, size_t payloadLen_bytesIn, void* userVarIn);
 
+/**
+ * @public
+ * Called once a QoS1 publish is acknowledged (PUBACK) or a QoS2 publish is
+ * completed (PUBCOMP)
+ */
+typedef void (*cxa_mqtt_client_cb_onPublishComplete_t)(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn, void* userVarIn);
+
+/**
+ * @public
+ * Called once the client no longer needs a payload passed to
+ * ::cxa_mqtt_client_publish_zeroCopy (ownership returns to the caller)
+ */
+typedef void (*cxa_mqtt_client_cb_onPayloadReleased_t)(cxa_mqtt_client_t *const clientIn, void *const payloadIn, void* userVarIn);
+
+/**
+ * @public
+ * Called when a PUBLISH matching a streaming subscription starts arriving
+ * (topicNameIn is not null-terminated and is only valid during the callback)
+ *
+ * @return true to receive the payload (cb_onStreamData / cb_onStreamEnd),
+ * 		false to skip this publish
+ */
+typedef bool (*cxa_mqtt_client_cb_onPublishStreamBegin_t)(cxa_mqtt_client_t *const clientIn, char* topicNameIn, size_t topicNameLen_bytesIn,
+														  size_t payloadLen_bytesIn, void* userVarIn);
+
+/**
+ * @public
+ * Called with each chunk of the payload, in order
+ */
+typedef void (*cxa_mqtt_client_cb_onPublishStreamData_t)(cxa_mqtt_client_t *const clientIn, void* dataIn, size_t dataLen_bytesIn, void* userVarIn);
+
+/**
+ * @public
+ * Called once the entire payload has been delivered (wasSuccessfulIn == true),
+ * or if reception was interrupted (the publish should then be discarded, QoS1
+ * and QoS2 publishes will be redelivered by the server)
+ */
+typedef void (*cxa_mqtt_client_cb_onPublishStreamEnd_t)(cxa_mqtt_client_t *const clientIn, bool wasSuccessfulIn, void* userVarIn);
+
 
 /**
  * @private
@@ -100,16 +193,53 @@ typedef enum
 typedef struct
 {
 	uint16_t packetId;
+	uint16_t subAckIndex;			// position of our topic filter in the SUBSCRIBE (and return code in the SUBACK)
 	cxa_mqtt_client_subscriptionState_t state;
 
 	char topicFilter[CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES];
 	cxa_mqtt_qosLevel_t qos;
 	cxa_mqtt_client_cb_onPublish_t cb_onPublish;
 
+	// streaming subscriptions only (cb_onPublish == NULL)
+	cxa_mqtt_client_cb_onPublishStreamBegin_t cb_onStreamBegin;
+	cxa_mqtt_client_cb_onPublishStreamData_t cb_onStreamData;
+	cxa_mqtt_client_cb_onPublishStreamEnd_t cb_onStreamEnd;
+	bool isStreamActive;
+
 	void* userVar;
 }cxa_mqtt_client_subscriptionEntry_t;
 
 
+typedef enum
+{
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK,
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBREC,
+	CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP
+}cxa_mqtt_client_inflightState_t;
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	uint16_t packetId;
+	cxa_mqtt_client_inflightState_t state;
+
+	// the publish itself (released once PUBREC is received)
+	cxa_mqtt_message_t* msg;
+	cxa_timeDiff_t td_lastSent;
+
+	// zero-copy publishes: payload written after msg, directly from caller memory
+	void* extPayload;
+	size_t extPayloadLen_bytes;
+	cxa_mqtt_client_cb_onPayloadReleased_t cb_onPayloadReleased;
+
+	cxa_mqtt_client_cb_onPublishComplete_t cb_onComplete;
+	void* userVar;
+}cxa_mqtt_client_inflightEntry_t;
+
+
 /**
  * @private
  */
@@ -123,6 +253,16 @@ struct cxa_mqtt_client
 	cxa_array_t subscriptions;
 	cxa_mqtt_client_subscriptionEntry_t subscriptions_raw[CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS];
 
+	cxa_mqtt_topicTrie_t subscriptionTrie;
+	cxa_mqtt_topicTrie_node_t subscriptionTrie_nodes_raw[CXA_MQTT_CLIENT_MAXNUM_TOPICTRIE_NODES];
+	uint16_t subscriptionTrie_entryNext_raw[CXA_MQTT_CLIENT_MAXNUM_SUBSCRIPTIONS];
+
+	cxa_array_t inflight;
+	cxa_mqtt_client_inflightEntry_t inflight_raw[CXA_MQTT_CLIENT_MAXNUM_INFLIGHT];
+
+	cxa_array_t inboundQos2PacketIds;
+	uint16_t inboundQos2PacketIds_raw[CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2];
+
 	int threadId;
 
 	cxa_stateMachine_t stateMachine;
@@ -136,6 +276,16 @@ struct cxa_mqtt_client
 	char* clientId;
 	uint16_t currPacketId;
 
+	bool isCleanSession;
+	bool isSessionPresent;
+
+	// PUBLISH currently being streamed (too large for our receive buffer)
+	struct{
+		cxa_mqtt_qosLevel_t qos;
+		uint16_t packetId;
+		bool isDuplicate;
+	}inboundStream;
+
 	struct{
 		cxa_mqtt_qosLevel_t qos;
 		bool retain;
@@ -147,6 +297,17 @@ struct cxa_mqtt_client
 
 	cxa_mqtt_client_connectFailureReason_t connFailReason;
 	cxa_mqtt_client_scm_onDisconnect_t scm_onDisconnect;
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+	struct{
+		bool isEnabled;
+		uint32_t maxLatency_ms;
+		cxa_timeDiff_t td_firstQueued;
+
+		cxa_fixedByteBuffer_t fbb;
+		uint8_t fbb_raw[CXA_MQTT_CLIENT_TXCOALESCE_BUFFER_SIZE_BYTES];
+	}txCoalesce;
+#endif
 };
 
 
@@ -163,15 +324,120 @@ void cxa_mqtt_client_addListener(cxa_mqtt_client_t *const clientIn,
 								 cxa_mqtt_client_cb_onActivity_t cb_onActivityIn,
 								 void *const userVarIn);
 
+/**
+ * @public
+ * Selects whether future connects request a clean session (the default).
+ *
+ * With a persistent session (cleanSessionIn == false), the broker keeps our
+ * subscriptions (and queues QoS1/QoS2 publishes to them) while we're
+ * disconnected. If the broker reports that our session is still present
+ * when we reconnect, previously acknowledged subscriptions are not re-sent.
+ *
+ * @note a persistent session requires a client id that is stable across connects
+ */
+void cxa_mqtt_client_setCleanSession(cxa_mqtt_client_t *const clientIn, bool cleanSessionIn);
+
 bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const usernameIn, uint8_t *const passwordIn, uint16_t passwordLen_bytesIn);
 bool cxa_mqtt_client_isConnected(cxa_mqtt_client_t *const clientIn);
+
+/**
+ * @public
+ * @return true if the broker resumed our persistent session on the current
+ * 		(or most recent) connection
+ */
+bool cxa_mqtt_client_isSessionPresent(cxa_mqtt_client_t *const clientIn);
 void cxa_mqtt_client_disconnect(cxa_mqtt_client_t *const clientIn);
 
 bool cxa_mqtt_client_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
 							 char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn);
 bool cxa_mqtt_client_publish_message(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
 
-void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn);
+/**
+ * @public
+ * Publishes without waiting for any previous publishes to be acknowledged.
+ * QoS1/QoS2 publishes are held in the in-flight window (retransmitted with
+ * DUP on timeout or reconnect) until acknowledged, at which point
+ * cb_onCompleteIn is called.
+ *
+ * @return false if not connected, the message could not be sent, or the
+ * 		in-flight window is full (see ::cxa_mqtt_client_getNumFreeInflightSlots)
+ */
+bool cxa_mqtt_client_publish_withCallback(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+										  char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn,
+										  cxa_mqtt_client_cb_onPublishComplete_t cb_onCompleteIn, void* userVarIn);
+bool cxa_mqtt_client_publish_message_withCallback(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+												  cxa_mqtt_client_cb_onPublishComplete_t cb_onCompleteIn, void* userVarIn);
+
+/**
+ * @public
+ * Publishes a payload directly from caller-owned memory. Only the fixed header,
+ * topic and packet id are built in a (small) message; the payload is written
+ * after it with a vectored write, so it is never copied and is not limited
+ * by the message factory's message size.
+ *
+ * The caller must not modify payloadIn until cb_onPayloadReleasedIn is called:
+ * immediately (before returning) for QoS0, when PUBACK is received for QoS1,
+ * or when PUBREC is received for QoS2 (retransmits also use payloadIn).
+ *
+ * @return false (without calling cb_onPayloadReleasedIn) if not connected,
+ * 		the publish could not be sent, or the in-flight window is full
+ */
+bool cxa_mqtt_client_publish_zeroCopy(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+									  char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn,
+									  cxa_mqtt_client_cb_onPayloadReleased_t cb_onPayloadReleasedIn, void* userVarIn);
+
+size_t cxa_mqtt_client_getNumFreeInflightSlots(cxa_mqtt_client_t *const clientIn);
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+/**
+ * @public
+ * Enables/disables coalescing of outgoing packets. When enabled, packets are
+ * buffered and written together once the buffer fills, maxLatency_msIn has
+ * elapsed since the first buffered packet, or ::cxa_mqtt_client_flush is called.
+ *
+ * @param[in] maxLatency_msIn 0 coalesces packets produced within the same
+ * 		runLoop iteration
+ */
+void cxa_mqtt_client_setWriteCoalescing(cxa_mqtt_client_t *const clientIn, bool enableIn, uint32_t maxLatency_msIn);
+#endif
+
+/**
+ * @public
+ * Writes any coalesced outgoing packets now (no-op if coalescing is disabled)
+ *
+ * @return false if the write to the underlying ioStream failed
+ */
+bool cxa_mqtt_client_flush(cxa_mqtt_client_t *const clientIn);
+
+/**
+ * @public
+ * Subscriptions are remembered and re-sent every time we (re)connect. On
+ * reconnect, topic filters are packed into as few SUBSCRIBE packets as the
+ * message size allows and all are sent without waiting for their SUBACKs.
+ *
+ * @return false if the topic filter is malformed, deeper than
+ * 		CXA_MQTT_CLIENT_MAXNUM_TOPICFILTER_LEVELS, or there is no room for
+ * 		another subscription
+ */
+bool cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn);
+
+/**
+ * @public
+ * Subscribes with the payload delivered in chunks as it is received, so
+ * publishes larger than the message factory's messages can be received
+ * (eg. firmware images). Publishes which do fit are delivered the same way,
+ * as a single chunk.
+ *
+ * Publishes too large for the receive buffer which don't match a streaming
+ * subscription are acknowledged (QoS1/QoS2) but otherwise discarded.
+ *
+ * @return false under the same conditions as ::cxa_mqtt_client_subscribe
+ */
+bool cxa_mqtt_client_subscribe_streaming(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn,
+										 cxa_mqtt_client_cb_onPublishStreamBegin_t cb_onStreamBeginIn,
+										 cxa_mqtt_client_cb_onPublishStreamData_t cb_onStreamDataIn,
+										 cxa_mqtt_client_cb_onPublishStreamEnd_t cb_onStreamEndIn,
+										 void* userVarIn);
 
 
 /**
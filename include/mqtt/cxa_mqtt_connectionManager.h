@@ -13,6 +13,24 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Reconnect standoff is CXA_MQTT_CONNMAN_STANDOFF_MIN_MS plus a random jitter.
+ * The jitter window starts at CXA_MQTT_CONNMAN_STANDOFF_INITIALJITTER_MS and
+ * doubles with every further consecutive failed connect (up to
+ * CXA_MQTT_CONNMAN_STANDOFF_MAXJITTER_MS), so a fleet of devices that lost
+ * the same broker spreads out its reconnects.
+ */
+#ifndef CXA_MQTT_CONNMAN_STANDOFF_MIN_MS
+	#define CXA_MQTT_CONNMAN_STANDOFF_MIN_MS					1000
+#endif
+
+#ifndef CXA_MQTT_CONNMAN_STANDOFF_INITIALJITTER_MS
+	#define CXA_MQTT_CONNMAN_STANDOFF_INITIALJITTER_MS			10000
+#endif
+
+#ifndef CXA_MQTT_CONNMAN_STANDOFF_MAXJITTER_MS
+	#define CXA_MQTT_CONNMAN_STANDOFF_MAXJITTER_MS				300000
+#endif
 
 
 // ******** global type definitions *********
@@ -27,6 +45,14 @@ void cxa_mqtt_connManager_setStandoffManagementCbs(cxa_mqtt_connManager_entering
 												  cxa_mqtt_connManager_canLeaveStandoffCb_t cb_canLeaveStandoffCbIn,
 												  void *const userVarIn);
 
+/**
+ * Requests a persistent session (clean session = false) for future connects,
+ * so the broker keeps our subscriptions across reconnects (see
+ * ::cxa_mqtt_client_setCleanSession). Our client id is the unique id of
+ * this device, so it is stable across connects and restarts.
+ */
+void cxa_mqtt_connManager_setPersistentSession(bool persistentSessionIn);
+
 bool cxa_mqtt_connManager_areCredentialsSet(void);
 
 bool cxa_mqtt_connManager_start(void);
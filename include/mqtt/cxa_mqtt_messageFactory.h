@@ -15,6 +15,10 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Number and size of messages in the largest size class. This is also the
+ * maximum size of any message (eg. received messages use this class).
+ */
 #ifndef CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES
 	#define CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES			2
 #endif
@@ -23,14 +27,92 @@
 	#define CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES		64
 #endif
 
+/**
+ * Optional smaller size classes (disabled when NUM_MESSAGES is 0). Messages
+ * requested with ::cxa_mqtt_messageFactory_getFreeMessage_withCapacity come
+ * from the smallest class that fits (falling back to larger classes when
+ * that class is exhausted). Enabled classes must be strictly smaller than
+ * the next enabled class.
+ */
+#ifndef CXA_MQTT_MESSAGEFACTORY_SMALL_NUM_MESSAGES
+	#define CXA_MQTT_MESSAGEFACTORY_SMALL_NUM_MESSAGES			0
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES		64
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_MEDIUM_NUM_MESSAGES
+	#define CXA_MQTT_MESSAGEFACTORY_MEDIUM_NUM_MESSAGES			0
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES		256
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_LARGE_NUM_MESSAGES
+	#define CXA_MQTT_MESSAGEFACTORY_LARGE_NUM_MESSAGES			0
+#endif
+
+#ifndef CXA_MQTT_MESSAGEFACTORY_LARGE_MESSAGE_SIZE_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_LARGE_MESSAGE_SIZE_BYTES		1024
+#endif
+
+/**
+ * Number of bytes (of CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES) initially
+ * reserved at the front of each message buffer so topic prepends don't need
+ * to move the payload. Does not reduce the maximum message size. Smaller
+ * size classes reserve the same fraction of their size.
+ */
+#ifndef CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES
+	#define CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES			(CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES / 2)
+#endif
+
 
 // ******** global type definitions *********
 
 
 // ******** global function prototypes ********
+/**
+ * @public
+ * @return the number of free messages (across all size classes)
+ */
 size_t cxa_mqtt_messageFactory_getNumFreeMessages(void);
+
+/**
+ * @public
+ * @return the sum of the high-water marks of each size class
+ */
+size_t cxa_mqtt_messageFactory_getHighWaterMark(void);
+
+/**
+ * @public
+ * @return the number of times a size class was exhausted (even if the
+ * 		message was then taken from a larger class)
+ */
+size_t cxa_mqtt_messageFactory_getNumExhausted(void);
+
+/**
+ * @public
+ * @brief Reserves an empty message from the largest size class
+ */
 cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_empty(void);
 
+/**
+ * @public
+ * @brief Reserves an empty message that can hold at least capacity_bytesIn
+ * 		bytes, from the smallest size class that fits
+ *
+ * @return the message or NULL if no class that fits has a free message
+ */
+cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_withCapacity(size_t capacity_bytesIn);
+
+/**
+ * @public
+ * @return the maximum number of bytes the given message can hold
+ */
+size_t cxa_mqtt_messageFactory_getCapacity_bytes(cxa_mqtt_message_t *const msgIn);
+
 cxa_mqtt_message_t* cxa_mqtt_messageFactory_getMessage_byBuffer(cxa_fixedByteBuffer_t *const fbbIn);
 
 void cxa_mqtt_messageFactory_incrementMessageRefCount(cxa_mqtt_message_t *const msgIn);
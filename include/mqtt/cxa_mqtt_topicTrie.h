@@ -0,0 +1,179 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+
+/**
+ * @file
+ * This file contains a statically allocated trie of MQTT topic filters, split
+ * by topic level, with support for the '+' (single-level) and '#' (multi-level)
+ * wildcards. Each inserted filter is associated with an entry index (eg. an
+ * index into an array of subscriptions).
+ *
+ * Exact-level children are found by hashing (parent, level) and wildcard
+ * children are linked directly, so matching a topic visits only the branches
+ * that can match it: the cost is proportional to the number of topic levels
+ * (and wildcard branches) rather than the number of filters. Topics are
+ * length-delimited and never modified.
+ *
+ * @note Filter strings are NOT copied. They must remain valid (and unchanged)
+ * 		for as long as they are in the trie.
+ *
+ *
+ * #### Example Usage: ####
+ *
+ * @code
+ * cxa_mqtt_topicTrie_t trie;
+ * cxa_mqtt_topicTrie_node_t trie_nodes[16];
+ * uint16_t trie_entryNext[4];
+ *
+ * cxa_mqtt_topicTrie_initStd(&trie, trie_nodes, trie_entryNext);
+ * cxa_mqtt_topicTrie_insert(&trie, "home/+/temp", 0);
+ * cxa_mqtt_topicTrie_insert(&trie, "home/#", 1);
+ *
+ * // calls cb_onMatch for entry 0 and entry 1
+ * cxa_mqtt_topicTrie_match(&trie, topicName, topicNameLen_bytes, cb_onMatch, NULL);
+ * @endcode
+ */
+#ifndef CXA_MQTT_TOPICTRIE_H_
+#define CXA_MQTT_TOPICTRIE_H_
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <cxa_config.h>
+
+
+// ******** global macro definitions ********
+#define CXA_MQTT_TOPICTRIE_INDEX_NONE				UINT16_MAX
+
+
+/**
+ * @public
+ * @brief Shortcut to initialize the trie with explicitly declared buffers
+ */
+#define cxa_mqtt_topicTrie_initStd(trieIn, nodesIn, entryNextIn)		cxa_mqtt_topicTrie_init((trieIn), (nodesIn), sizeof(nodesIn), (entryNextIn), sizeof(entryNextIn))
+
+
+// ******** global type definitions *********
+/**
+ * @public
+ * @brief "Forward" declaration of the cxa_mqtt_topicTrie_t object
+ */
+typedef struct cxa_mqtt_topicTrie cxa_mqtt_topicTrie_t;
+
+
+/**
+ * @public
+ * @brief Callback called once for each entry whose filter matches a topic
+ */
+typedef void (*cxa_mqtt_topicTrie_cb_onMatch_t)(uint16_t entryIndexIn, void* userVarIn);
+
+
+/**
+ * @private
+ */
+typedef struct
+{
+	const char* level;
+	uint16_t levelLen_bytes;
+	uint16_t parent;
+
+	// children matching an exact level are found via hash (parent + level)
+	uint16_t bucketHead;
+	uint16_t nextInBucket;
+
+	uint16_t plusChild;
+	uint16_t hashChild;
+
+	uint16_t firstEntry;
+}cxa_mqtt_topicTrie_node_t;
+
+
+/**
+ * @private
+ */
+struct cxa_mqtt_topicTrie
+{
+	cxa_mqtt_topicTrie_node_t* nodes;
+	size_t numNodes;
+	size_t maxNumNodes;
+
+	uint16_t* entryNext;
+	size_t maxNumEntries;
+};
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @brief Initializes an empty trie
+ *
+ * @param[in] trieIn pointer to the pre-allocated trie object
+ * @param[in] nodesIn buffer used to store the nodes of the trie (one node
+ * 		is used for the root, plus one per unique filter prefix)
+ * @param[in] nodesSize_bytesIn size of nodesIn, in bytes
+ * @param[in] entryNextIn buffer with one uint16_t per possible entry index
+ * @param[in] entryNextSize_bytesIn size of entryNextIn, in bytes
+ */
+void cxa_mqtt_topicTrie_init(cxa_mqtt_topicTrie_t *const trieIn,
+							 cxa_mqtt_topicTrie_node_t *const nodesIn, size_t nodesSize_bytesIn,
+							 uint16_t *const entryNextIn, size_t entryNextSize_bytesIn);
+
+
+/**
+ * @public
+ * @brief Removes all filters from the trie
+ */
+void cxa_mqtt_topicTrie_clear(cxa_mqtt_topicTrie_t *const trieIn);
+
+
+/**
+ * @public
+ * @brief Checks that a topic filter is well-formed ('+' and '#' occupy an
+ * 		entire level, '#' is the last level)
+ *
+ * @param[in] filterIn null-terminated topic filter
+ * @param[out] numLevelsOut optional, the number of levels in the filter (which
+ * 		is also the maximum number of nodes it adds to a trie)
+ *
+ * @return true if the filter is well-formed
+ */
+bool cxa_mqtt_topicTrie_validateFilter(const char *const filterIn, size_t *const numLevelsOut);
+
+
+/**
+ * @public
+ * @brief Adds a topic filter to the trie
+ *
+ * @param[in] trieIn pointer to the pre-initialized trie
+ * @param[in] filterIn null-terminated topic filter (NOT copied, see file notes)
+ * @param[in] entryIndexIn index reported when this filter matches. Each index
+ * 		may only be inserted once.
+ *
+ * @return true on success, false if the filter is malformed or the trie is out of nodes
+ */
+bool cxa_mqtt_topicTrie_insert(cxa_mqtt_topicTrie_t *const trieIn, const char *const filterIn, uint16_t entryIndexIn);
+
+
+/**
+ * @public
+ * @brief Finds all filters matching the given topic name
+ *
+ * @param[in] trieIn pointer to the pre-initialized trie
+ * @param[in] topicIn topic name (need not be null-terminated)
+ * @param[in] topicLen_bytesIn length of the topic name
+ * @param[in] cb_onMatchIn called for each matching entry
+ * @param[in] userVarIn passed to cb_onMatchIn
+ *
+ * @return the number of matching entries
+ */
+size_t cxa_mqtt_topicTrie_match(cxa_mqtt_topicTrie_t *const trieIn, const char *const topicIn, size_t topicLen_bytesIn,
+								cxa_mqtt_topicTrie_cb_onMatch_t cb_onMatchIn, void *const userVarIn);
+
+
+#endif // CXA_MQTT_TOPICTRIE_H_
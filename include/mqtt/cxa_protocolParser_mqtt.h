@@ -15,20 +15,76 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Minimum free space (after the fixed and variable headers) required in the
+ * receive buffer to stream a PUBLISH. Payload chunks are at most the free size.
+ */
+#ifndef CXA_PROTOCOLPARSER_MQTT_MINSIZE_STREAMCHUNK_BYTES
+	#define CXA_PROTOCOLPARSER_MQTT_MINSIZE_STREAMCHUNK_BYTES		16
+#endif
 
 
 // ******** global type definitions *********
+/**
+ * @public
+ * Called once the variable header of a PUBLISH too large for the receive
+ * buffer has been received (topicNameIn points into the receive buffer and
+ * is not null-terminated).
+ *
+ * @return true to receive the payload via cb_onStreamData / cb_onStreamEnd,
+ * 		false to discard it
+ */
+typedef bool (*cxa_protocolParser_mqtt_cb_onStreamBegin_t)(cxa_mqtt_qosLevel_t qosIn, uint16_t packetIdIn,
+														   char *const topicNameIn, size_t topicNameLen_bytesIn,
+														   size_t payloadLen_bytesIn, void *const userVarIn);
+
+/**
+ * @public
+ * Called with each chunk of a streamed payload, in order
+ */
+typedef void (*cxa_protocolParser_mqtt_cb_onStreamData_t)(uint8_t *const dataIn, size_t dataLen_bytesIn, void *const userVarIn);
+
+/**
+ * @public
+ * Called once a streamed payload is complete (wasSuccessfulIn == true)
+ * or reception was interrupted (timeout, ioException, reset)
+ */
+typedef void (*cxa_protocolParser_mqtt_cb_onStreamEnd_t)(bool wasSuccessfulIn, void *const userVarIn);
+
+
 typedef struct
 {
 	cxa_protocolParser_t super;
 
 	cxa_stateMachine_t stateMachine;
 	size_t remainingBytesToReceive;
+
+	struct
+	{
+		cxa_protocolParser_mqtt_cb_onStreamBegin_t cb_onBegin;
+		cxa_protocolParser_mqtt_cb_onStreamData_t cb_onData;
+		cxa_protocolParser_mqtt_cb_onStreamEnd_t cb_onEnd;
+		void* userVar;
+
+		size_t headerLen_bytes;
+	}stream;
 }cxa_protocolParser_mqtt_t;
 
 
 // ******** global function prototypes ********
 void cxa_protocolParser_mqtt_init(cxa_protocolParser_mqtt_t *const mppIn, cxa_ioStream_t *const ioStreamIn, cxa_fixedByteBuffer_t *const buffIn, int threadIdIn);
 
+/**
+ * @public
+ * Enables streaming of PUBLISH packets which don't fit in the receive buffer.
+ * Without a stream handler (the default), such packets are discarded.
+ * Other packets are always delivered via the packet listeners.
+ */
+void cxa_protocolParser_mqtt_setStreamHandler(cxa_protocolParser_mqtt_t *const mppIn,
+											  cxa_protocolParser_mqtt_cb_onStreamBegin_t cb_onBeginIn,
+											  cxa_protocolParser_mqtt_cb_onStreamData_t cb_onDataIn,
+											  cxa_protocolParser_mqtt_cb_onStreamEnd_t cb_onEndIn,
+											  void *const userVarIn);
+
 
 #endif // CXA_PROTOCOLPARSER_MQTT_H_
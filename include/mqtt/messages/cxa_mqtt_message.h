@@ -14,6 +14,11 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Maximum size of the fixed header (type/flags plus up to 4 bytes of
+ * remaining length)
+ */
+#define CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES			5
 
 
 // ******** global type definitions *********
@@ -25,6 +30,10 @@ typedef enum
 	CXA_MQTT_MSGTYPE_CONNECT=1,
 	CXA_MQTT_MSGTYPE_CONNACK=2,
 	CXA_MQTT_MSGTYPE_PUBLISH=3,
+	CXA_MQTT_MSGTYPE_PUBACK=4,
+	CXA_MQTT_MSGTYPE_PUBREC=5,
+	CXA_MQTT_MSGTYPE_PUBREL=6,
+	CXA_MQTT_MSGTYPE_PUBCOMP=7,
 	CXA_MQTT_MSGTYPE_SUBSCRIBE=8,
 	CXA_MQTT_MSGTYPE_SUBACK=9,
 	CXA_MQTT_MSGTYPE_PINGREQ=12,
@@ -36,15 +45,82 @@ typedef enum
 typedef enum
 {
 	CXA_MQTT_QOS_ATMOST_ONCE=0,
-	//CXA_MQTT_QOS_ATLEAST_ONCE=1, -- not supported
-	//CXA_MQTT_QOS_EXACTLY_ONCE=2 -- not supported
+	CXA_MQTT_QOS_ATLEAST_ONCE=1,
+	CXA_MQTT_QOS_EXACTLY_ONCE=2
 }cxa_mqtt_qosLevel_t;
 
 
+/**
+ * @public
+ * Read-only, flat view of a received message. Decoded once when the
+ * received bytes are validated; pointers refer directly into the
+ * message's buffer (no copies) and are only valid until the message is
+ * modified or released.
+ */
+typedef struct
+{
+	cxa_mqtt_message_type_t type;
+	uint8_t flags;
+	size_t remainingLength_bytes;
+
+	union
+	{
+		struct
+		{
+			char* topicName;
+			uint16_t topicNameLen_bytes;
+
+			cxa_mqtt_qosLevel_t qos;
+			bool isDup;
+			bool isRetain;
+			uint16_t packetId;
+
+			uint8_t* payload;
+			size_t payloadSize_bytes;
+		}asPublish;
+
+		struct
+		{
+			uint16_t packetId;
+		}asPublishAck;
+
+		struct
+		{
+			uint16_t packetId;
+			uint8_t returnCode;
+
+			// one per topic filter in the SUBSCRIBE (returnCodes[0] == returnCode)
+			uint8_t* returnCodes;
+			size_t numReturnCodes;
+		}asSubAck;
+
+		struct
+		{
+			bool isSessionPresent;
+			uint8_t returnCode;
+		}asConnAck;
+
+		struct
+		{
+			uint16_t packetId;
+
+			// length-prefixed topic filter / requested qos pairs, use
+			// cxa_mqtt_message_subscribe_getTopicFilter to walk them
+			uint8_t* topicFilters;
+			size_t topicFiltersSize_bytes;
+			size_t numTopicFilters;
+		}asSubscribe;
+	};
+}cxa_mqtt_message_view_t;
+
+
 struct cxa_mqtt_message
 {
 	cxa_fixedByteBuffer_t* buffer;
 
+	bool isViewValid;
+	cxa_mqtt_message_view_t view;
+
 	bool areFieldsConfigured;
 	cxa_linkedField_t field_packetTypeAndFlags;
 	cxa_linkedField_t field_remainingLength;
@@ -89,6 +165,11 @@ struct cxa_mqtt_message
 		cxa_linkedField_t field_packetId;
 		cxa_linkedField_t field_payload;
 	}fields_publish;
+
+	struct
+	{
+		cxa_linkedField_t field_packetId;
+	}fields_publishAck;
 };
 
 
@@ -105,6 +186,16 @@ cxa_mqtt_message_type_t cxa_mqtt_message_getType(cxa_mqtt_message_t *const msgIn
 cxa_fixedByteBuffer_t* cxa_mqtt_message_getBuffer(cxa_mqtt_message_t *const msgIn);
 
 
+/**
+ * @public
+ * Returns the flat view of a received (and validated) message.
+ *
+ * @return the view, or NULL if this message was not received or has
+ * 		been modified (or re-initialized) since it was received
+ */
+const cxa_mqtt_message_view_t* cxa_mqtt_message_getView(cxa_mqtt_message_t *const msgIn);
+
+
 /**
  * @protected
  */
@@ -130,10 +221,25 @@ cxa_mqtt_message_type_t cxa_mqtt_message_rxBytes_getType(uint8_t headerByteIn);
 bool cxa_mqtt_message_rxBytes_parseVariableLengthField(cxa_fixedByteBuffer_t *const fbbIn, bool *isCompleteOut, size_t *actualLengthOut, size_t *fieldLength_bytesOut);
 
 
+/**
+ * @protected
+ * Called whenever the message contents are modified
+ */
+void cxa_mqtt_message_invalidateView(cxa_mqtt_message_t *const msgIn);
+
+
 /**
  * @protected
  */
 bool cxa_mqtt_message_updateVariableLengthField(cxa_mqtt_message_t *const msgIn);
 
 
+/**
+ * @protected
+ * Same as ::cxa_mqtt_message_updateVariableLengthField for messages whose last
+ * numTrailingBytesIn bytes are written separately (not stored in the message buffer)
+ */
+bool cxa_mqtt_message_updateVariableLengthField_withTrailingBytes(cxa_mqtt_message_t *const msgIn, size_t numTrailingBytesIn);
+
+
 #endif /* CXA_MQTT_MESSAGE_H_ */
@@ -13,6 +13,7 @@
 
 
 // ******** global macro definitions ********
+#define CXA_MQTT_MESSAGE_CONNACK_MAXSIZE_BYTES			(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES + 2)
 
 
 // ******** global type definitions *********
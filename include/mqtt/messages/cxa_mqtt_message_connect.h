@@ -13,6 +13,13 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Maximum encoded size of a CONNECT (the will, username and password are
+ * counted even if they end up being omitted)
+ */
+#define CXA_MQTT_MESSAGE_CONNECT_MAXSIZE_BYTES(clientIdLen_bytesIn, willTopicLen_bytesIn, willPayloadLen_bytesIn, usernameLen_bytesIn, passwordLen_bytesIn)		\
+	(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES + 10 + (2 + (clientIdLen_bytesIn)) +														\
+	 (2 + (willTopicLen_bytesIn)) + (2 + (willPayloadLen_bytesIn)) + (2 + (usernameLen_bytesIn)) + (2 + (passwordLen_bytesIn)))
 
 
 // ******** global type definitions *********
@@ -32,6 +39,8 @@ bool cxa_mqtt_message_connect_cleanSessionRequested(cxa_mqtt_message_t *const ms
 bool cxa_mqtt_message_connect_getClientId(cxa_mqtt_message_t *const msgIn, char** clientIdOut, uint16_t* clientIdLen_bytesOut);
 bool cxa_mqtt_message_connect_getUsername(cxa_mqtt_message_t *const msgIn, char** usernameOut, uint16_t* usernameLen_bytesOut);
 bool cxa_mqtt_message_connect_getPassword(cxa_mqtt_message_t *const msgIn, uint8_t** passwordOut, uint16_t* passwordLen_bytesOut);
+bool cxa_mqtt_message_connect_getProtocolLevel(cxa_mqtt_message_t *const msgIn, uint8_t *const protocolLevelOut);
+bool cxa_mqtt_message_connect_getKeepAlive_s(cxa_mqtt_message_t *const msgIn, uint16_t *const keepAlive_sOut);
 
 /**
  * @protected
@@ -13,6 +13,11 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Maximum encoded size of a PUBLISH with the given topic and payload lengths
+ * (eg. for ::cxa_mqtt_messageFactory_getFreeMessage_withCapacity)
+ */
+#define CXA_MQTT_MESSAGE_PUBLISH_MAXSIZE_BYTES(topicNameLen_bytesIn, payloadLen_bytesIn)		(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES + 2 + (topicNameLen_bytesIn) + 2 + (payloadLen_bytesIn))
 
 
 // ******** global type definitions *********
@@ -22,6 +27,9 @@
 bool cxa_mqtt_message_publish_init(cxa_mqtt_message_t *const msgIn, bool dupIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn, char *const topicNameIn, uint16_t packedIdIn, void *const payloadIn, uint16_t payloadSize_bytesIn);
 
 bool cxa_mqtt_message_publish_getTopicName(cxa_mqtt_message_t *const msgIn, char** topicNameOut, uint16_t *const topicNameLen_bytesOut);
+bool cxa_mqtt_message_publish_getQos(cxa_mqtt_message_t *const msgIn, cxa_mqtt_qosLevel_t *const qosOut);
+bool cxa_mqtt_message_publish_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut);
+bool cxa_mqtt_message_publish_setDup(cxa_mqtt_message_t *const msgIn, bool dupIn);
 bool cxa_mqtt_message_publish_getPayload(cxa_mqtt_message_t *const msgIn, cxa_linkedField_t **payloadLfOut);
 
 bool cxa_mqtt_message_publish_topicName_trimToPointer(cxa_mqtt_message_t *const msgIn, char *const ptrIn);
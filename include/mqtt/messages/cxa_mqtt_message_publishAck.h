@@ -0,0 +1,52 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#ifndef CXA_MQTT_MESSAGE_PUBLISH_ACK_H_
+#define CXA_MQTT_MESSAGE_PUBLISH_ACK_H_
+
+
+/**
+ * @file
+ * This file contains the messages used to acknowledge QoS1 and QoS2 publishes
+ * (PUBACK, PUBREC, PUBREL and PUBCOMP). These share the same format: a fixed
+ * header followed by the packet identifier of the publish they refer to.
+ */
+
+
+// ******** includes ********
+#include <cxa_mqtt_message.h>
+
+
+// ******** global macro definitions ********
+#define CXA_MQTT_MESSAGE_PUBLISHACK_MAXSIZE_BYTES			(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES + 2)
+
+
+// ******** global type definitions *********
+
+
+// ******** global function prototypes ********
+/**
+ * @public
+ * @param[in] typeIn one of CXA_MQTT_MSGTYPE_PUBACK, CXA_MQTT_MSGTYPE_PUBREC,
+ * 		CXA_MQTT_MSGTYPE_PUBREL or CXA_MQTT_MSGTYPE_PUBCOMP
+ */
+bool cxa_mqtt_message_publishAck_init(cxa_mqtt_message_t *const msgIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn);
+
+bool cxa_mqtt_message_publishAck_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut);
+
+
+/**
+ * @protected
+ */
+bool cxa_mqtt_message_publishAck_isPublishAckType(cxa_mqtt_message_type_t typeIn);
+
+
+/**
+ * @protected
+ */
+bool cxa_mqtt_message_publishAck_validateReceivedBytes(cxa_mqtt_message_t *const msgIn);
+
+#endif /* CXA_MQTT_MESSAGE_PUBLISH_ACK_H_ */
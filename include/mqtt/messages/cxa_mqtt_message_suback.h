@@ -13,6 +13,7 @@
 
 
 // ******** global macro definitions ********
+#define CXA_MQTT_MESSAGE_SUBACK_MAXSIZE_BYTES(numReturnCodesIn)			(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES + 2 + (numReturnCodesIn))
 
 
 // ******** global type definitions *********
@@ -27,6 +28,12 @@ typedef enum
 
 
 // ******** global function prototypes ********
+/**
+ * Initializes a SUBACK with one return code per topic filter of the
+ * corresponding SUBSCRIBE (in the same order)
+ */
+bool cxa_mqtt_message_suback_init(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn, cxa_mqtt_subAck_returnCode_t *const returnCodesIn, size_t numReturnCodesIn);
+
 bool cxa_mqtt_message_suback_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut);
 bool cxa_mqtt_message_suback_getReturnCode(cxa_mqtt_message_t *const msgIn, cxa_mqtt_subAck_returnCode_t *const returnCodeOut);
 
@@ -13,6 +13,11 @@
 
 
 // ******** global macro definitions ********
+/**
+ * Maximum encoded size of a SUBSCRIBE with a single topic filter
+ */
+#define CXA_MQTT_MESSAGE_SUBSCRIBE_MAXSIZE_BYTES(topicFilterLen_bytesIn)		(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES + 2 + 2 + (topicFilterLen_bytesIn) + 1)
+#define CXA_MQTT_MESSAGE_SUBSCRIBE_TOPICFILTER_SIZE_BYTES(topicFilterLen_bytesIn)	(2 + (topicFilterLen_bytesIn) + 1)
 
 
 // ******** global type definitions *********
@@ -21,6 +26,31 @@
 // ******** global function prototypes ********
 bool cxa_mqtt_message_subscribe_init(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn, char *const topicFilterIn, cxa_mqtt_qosLevel_t qosLevelIn);
 
+/**
+ * Initializes a SUBSCRIBE carrying multiple topic filters. Add (at least one)
+ * topic filter using ::cxa_mqtt_message_subscribe_appendTopicFilter. The
+ * SUBACK will contain one return code per topic filter, in the same order.
+ */
+bool cxa_mqtt_message_subscribe_initBatch(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn);
+
+/**
+ * @return false if the topic filter doesn't fit in the message (message is unchanged)
+ */
+bool cxa_mqtt_message_subscribe_appendTopicFilter(cxa_mqtt_message_t *const msgIn, char *const topicFilterIn, cxa_mqtt_qosLevel_t qosLevelIn);
+
+/**
+ * Retrieves a topic filter from a received SUBSCRIBE
+ *
+ * @param currIndexIn index into the topic filter / qos pairs at which to read
+ * 		(start with 0, then pass the returned nextIndexOut)
+ * @param topicFilterOut points into the message buffer (NOT null-terminated)
+ *
+ * @return false if there are no more topic filters
+ */
+bool cxa_mqtt_message_subscribe_getTopicFilter(cxa_mqtt_message_t *const msgIn, size_t currIndexIn,
+											   char** topicFilterOut, uint16_t *const topicFilterLen_bytesOut,
+											   cxa_mqtt_qosLevel_t *const qosOut, size_t *const nextIndexOut);
+
 
 /**
  * @protected
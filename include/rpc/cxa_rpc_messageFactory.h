@@ -27,6 +27,8 @@
 void cxa_rpc_messageFactory_init(void);
 
 size_t cxa_rpc_messageFactory_getNumFreeMessages(void);
+size_t cxa_rpc_messageFactory_getHighWaterMark(void);
+size_t cxa_rpc_messageFactory_getNumExhausted(void);
 cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_empty(void);
 
 cxa_rpc_message_t* cxa_rpc_messageFactory_getMessage_byBuffer(cxa_fixedByteBuffer_t *const fbbIn);
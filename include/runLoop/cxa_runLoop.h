@@ -10,17 +10,41 @@
 
 // ******** includes ********
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <cxa_config.h>
 
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+	#include <cxa_ioStream.h>
+#endif
+
 
 // ******** global macro definitions ********
 #ifndef CXA_RUNLOOP_MAXNUM_ENTRIES
 	#define CXA_RUNLOOP_MAXNUM_ENTRIES				10
 #endif
 
+#ifndef CXA_RUNLOOP_TICKLESS_POLLPERIOD_MS
+	#define CXA_RUNLOOP_TICKLESS_POLLPERIOD_MS		10
+#endif
+
+#ifndef CXA_RUNLOOP_TICKLESS_MAXSLEEP_MS
+	#define CXA_RUNLOOP_TICKLESS_MAXSLEEP_MS		1000
+#endif
+
+#ifndef CXA_RUNLOOP_POSTQUEUE_SIZE
+	#define CXA_RUNLOOP_POSTQUEUE_SIZE				16
+#endif
+
+#ifndef CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT
+	#define CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT		CXA_RUNLOOP_CATCHUP_SKIP
+#endif
+
 #define CXA_RUNLOOP_THREADID_DEFAULT				0
 
+// lateness buckets: <100us, <1ms, <10ms, <100ms, <1s, >=1s
+#define CXA_RUNLOOP_STATS_NUM_LATENESS_BUCKETS		6
+
 
 // ******** global type definitions *********
 /**
@@ -29,15 +53,227 @@
 typedef void (*cxa_runLoop_cb_t)(void* userVarIn);
 
 
+/**
+ * @public
+ * Determines what a periodic (timed) entry does when one or more of its
+ * deadlines have been missed (eg. due to a long-running callback)
+ */
+typedef enum
+{
+	// drop the missed executions, stay in phase with the original schedule
+	CXA_RUNLOOP_CATCHUP_SKIP,
+
+	// execute every missed period back-to-back
+	CXA_RUNLOOP_CATCHUP_BURST,
+
+	// treat the (late) execution as covering all missed periods and restart the period from now
+	CXA_RUNLOOP_CATCHUP_COALESCE
+}cxa_runLoop_catchUpPolicy_t;
+
+
+/**
+ * @public
+ * Determines whether an untimed entry keeps a tickless thread polling
+ * (see ::cxa_runLoop_execute)
+ */
+typedef enum
+{
+	// must be polled: the thread wakes at least every CXA_RUNLOOP_TICKLESS_POLLPERIOD_MS
+	CXA_RUNLOOP_POLL_PERIODIC,
+
+	// executed on every iteration, but reports when it next needs attention
+	// (::cxa_runLoop_requestWakeWithin_ms / ::cxa_runLoop_wake) so doesn't limit sleep
+	CXA_RUNLOOP_POLL_ONREQUEST
+}cxa_runLoop_pollPolicy_t;
+
+
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+/**
+ * @public
+ * Execution statistics for a single runLoop entry (update callback only)
+ */
+typedef struct
+{
+	int threadId;
+	cxa_runLoop_cb_t updateCb;
+	void* userVar;
+	uint32_t execPeriod_ms;
+
+	uint32_t numCalls;
+	uint64_t totalExecTime_us;
+	uint32_t minExecTime_us;
+	uint32_t maxExecTime_us;
+
+	// number of executions which took longer than execPeriod_ms (timed entries only)
+	uint32_t numOverruns;
+
+	// time between deadline and actual execution (timed entries only)
+	uint32_t maxLateness_us;
+	uint32_t latenessHistogram[CXA_RUNLOOP_STATS_NUM_LATENESS_BUCKETS];
+}cxa_runLoop_entryStats_t;
+#endif
+
+
 // ******** global function prototypes ********
+/**
+ * @public
+ * @brief Adds an entry which is executed on every iteration of the specified thread.
+ *
+ * @note this (and the other add / dispatch functions) briefly enter a
+ *		critical section. Critical sections nest, so they may be called from
+ *		within one (eg. during setup), but not from interrupt context...use
+ *		::cxa_runLoop_post there.
+ */
 void cxa_runLoop_addEntry(int threadIdIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Same as ::cxa_runLoop_addEntry (which uses CXA_RUNLOOP_POLL_PERIODIC),
+ * but with an explicit poll policy.
+ */
+void cxa_runLoop_addEntry_full(int threadIdIn, cxa_runLoop_pollPolicy_t pollPolicyIn,
+							   cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Adds an entry which is executed every execPeriod_msIn milliseconds.
+ *
+ * Executions are scheduled against absolute deadlines (the first being
+ * execPeriod_msIn after this call), so a late execution does not delay
+ * subsequent executions. Missed deadlines are handled according to
+ * CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT.
+ */
 void cxa_runLoop_addTimedEntry(int threadIdIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
+
+/**
+ * @public
+ * @brief Same as ::cxa_runLoop_addTimedEntry, but with an explicit policy
+ * for handling missed deadlines.
+ */
+void cxa_runLoop_addTimedEntry_full(int threadIdIn, uint32_t execPeriod_msIn, cxa_runLoop_catchUpPolicy_t catchUpPolicyIn,
+									cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 void cxa_runLoop_clearAllEntries(void);
 
 void cxa_runLoop_dispatchNextIteration(int threadIdIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 void cxa_runLoop_dispatchAfter(int threadIdIn, uint32_t delay_msIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+/**
+ * @public
+ * @brief Posts a callback for execution on the next iteration of the
+ * specified thread, waking that thread if it is idle.
+ *
+ * Unlike ::cxa_runLoop_dispatchNextIteration, this function is lock-free and
+ * safe to call from any thread or interrupt context. Posted callbacks are
+ * placed in a fixed-size (CXA_RUNLOOP_POSTQUEUE_SIZE) multi-producer,
+ * single-consumer queue owned by the target thread.
+ *
+ * @note the target thread must already be known to the runLoop (ie. it has
+ *		registered entries or has been iterated at least once)
+ *
+ * @param[in] threadIdIn the thread on which the callback should execute
+ * @param[in] cbIn the callback to execute
+ * @param[in] userVarIn user variable passed to the callback
+ *
+ * @return true if the callback was queued, false if the target thread is
+ *		unknown or its queue is full
+ */
+bool cxa_runLoop_post(int threadIdIn, cxa_runLoop_cb_t cbIn, void *const userVarIn);
+#endif
+
+/**
+ * @public
+ * @brief Ensures that the specified thread iterates again no later than
+ * the specified number of milliseconds from now.
+ *
+ * Only meaningful when CXA_RUNLOOP_TICKLESS_ENABLE is defined (otherwise
+ * the runLoop never sleeps). Typically called from the thread's own
+ * runLoop callbacks (eg. by entries which are polled, but know when they
+ * next need attention), but safe to call from any thread: if the target
+ * thread is idle, it is woken to re-evaluate its deadline. The request is
+ * cleared by the first iteration at (or after) the requested time.
+ *
+ * @note like the add / dispatch functions, this briefly enters a critical
+ *		section (so not from interrupt context...use ::cxa_runLoop_post there)
+ *
+ * @param[in] threadIdIn the thread which should wake
+ * @param[in] delay_msIn the maximum time, in milliseconds, until the next iteration
+ */
+void cxa_runLoop_requestWakeWithin_ms(int threadIdIn, uint32_t delay_msIn);
+
+/**
+ * @public
+ * @brief Wakes the specified thread if it is currently idle (sleeping
+ * until its next deadline). Safe to call from any thread.
+ *
+ * Only meaningful when CXA_RUNLOOP_TICKLESS_ENABLE is defined.
+ *
+ * @param[in] threadIdIn the thread to wake
+ */
+void cxa_runLoop_wake(int threadIdIn);
+
 uint32_t cxa_runLoop_iterate(int threadIdIn);
+
+/**
+ * @public
+ * @brief Returns the specified thread's cached notion of "now", in microseconds.
+ *
+ * This value is captured (once) at the start of each iteration, so runLoop
+ * callbacks can use it without calling into the timeBase / OS again. It
+ * does not roll over: when CXA_TIMEDIFF_64BIT_ENABLE is defined it is the
+ * value of ::cxa_timeBase_getCount64_us, otherwise it is ::cxa_timeBase_getCount_us
+ * extended to 64-bits.
+ *
+ * @param[in] threadIdIn the thread in question
+ *
+ * @return the time at the start of the current (or most recent) iteration
+ */
+uint64_t cxa_runLoop_getCachedTime_us(int threadIdIn);
+
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+/**
+ * @public
+ * @brief Retrieves the execution statistics for the entry at the given
+ * slot index. Iterate over all slots with indices [0, CXA_RUNLOOP_MAXNUM_ENTRIES).
+ *
+ * @param[in] indexIn the slot index
+ * @param[out] statsOut the statistics for the slot's entry
+ *
+ * @return true if the slot contains an active entry (and statsOut was populated)
+ */
+bool cxa_runLoop_stats_getEntryStats(size_t indexIn, cxa_runLoop_entryStats_t *const statsOut);
+
+/**
+ * @public
+ * @brief Resets the execution statistics of all entries
+ */
+void cxa_runLoop_stats_reset(void);
+
+/**
+ * @public
+ * @brief Writes a table of all active entries, sorted by total execution
+ * time (most expensive first), to the provided ioStream
+ *
+ * @param[in] ioStreamIn the ioStream to which the table should be written
+ */
+void cxa_runLoop_stats_writeTable(cxa_ioStream_t *const ioStreamIn);
+#endif
+
+/**
+ * @public
+ * @brief Repeatedly iterates the specified thread (never returns).
+ *
+ * If CXA_RUNLOOP_TICKLESS_ENABLE is defined, the thread will sleep between
+ * iterations until the earliest of:
+ *    1. the next timed entry deadline
+ *    2. a deadline set via ::cxa_runLoop_requestWakeWithin_ms
+ *    3. a call to ::cxa_runLoop_wake (or the addition of a new entry)
+ *    4. CXA_RUNLOOP_TICKLESS_POLLPERIOD_MS, if the thread has untimed entries
+ *       which must be polled (CXA_RUNLOOP_POLL_PERIODIC), otherwise
+ *       CXA_RUNLOOP_TICKLESS_MAXSLEEP_MS
+ *
+ * @param[in] threadIdIn the thread to execute
+ */
 void cxa_runLoop_execute(int threadIdIn);
 
 
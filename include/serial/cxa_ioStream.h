@@ -69,10 +69,32 @@ typedef cxa_ioStream_readStatus_t (*cxa_ioStream_cb_readByte_t)(uint8_t *const b
 typedef bool (*cxa_ioStream_cb_writeBytes_t)(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
 
 
+/**
+ * @public
+ * One of several buffers written (in order) by ::cxa_ioStream_writeBytes_vectored
+ */
+typedef struct
+{
+	void* buff;
+	size_t size_bytes;
+}cxa_ioStream_ioVec_t;
+
+
+/**
+ * @public
+ * @brief Write several buffers to the ioStream in a single operation
+ * 		(eg. using writev). Optional, see ::cxa_ioStream_bindVectoredWrite.
+ *
+ * @return true if all bytes were sent / queued to be sent
+ */
+typedef bool (*cxa_ioStream_cb_writeBytesVectored_t)(cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn, void *const userVarIn);
+
+
 struct cxa_ioStream
 {
 	cxa_ioStream_cb_readByte_t readCb;
 	cxa_ioStream_cb_writeBytes_t writeCb;
+	cxa_ioStream_cb_writeBytesVectored_t writeVectoredCb;
 
 	void *userVar;
 };
@@ -83,6 +105,13 @@ void cxa_ioStream_init(cxa_ioStream_t *const ioStreamIn);
 
 void cxa_ioStream_bind(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_readByte_t readCbIn, cxa_ioStream_cb_writeBytes_t writeCbIn, void *const userVarIn);
 void cxa_ioStream_unbind(cxa_ioStream_t *const ioStreamIn);
+
+/**
+ * @public
+ * @brief Optionally provides a vectored write implementation for an ioStream
+ * 		that is already bound. Cleared by ::cxa_ioStream_bind / ::cxa_ioStream_unbind.
+ */
+void cxa_ioStream_bindVectoredWrite(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_writeBytesVectored_t writeVectoredCbIn);
 bool cxa_ioStream_isBound(cxa_ioStream_t *const ioStreamIn);
 
 cxa_ioStream_readStatus_t cxa_ioStream_readByte(cxa_ioStream_t *const ioStreamIn, uint8_t *const byteOut);
@@ -94,6 +123,13 @@ bool cxa_ioStream_writeByte(cxa_ioStream_t *const ioStreamIn, uint8_t byteIn);
 bool cxa_ioStream_writeBytes(cxa_ioStream_t *const ioStreamIn, void* buffIn, size_t bufferSize_bytesIn);
 bool cxa_ioStream_writeBytes_hex(cxa_ioStream_t *const ioStreamIn, void* buffIn, size_t bufferSize_bytesIn);
 bool cxa_ioStream_writeFixedByteBuffer(cxa_ioStream_t *const ioStreamIn, cxa_fixedByteBuffer_t *const fbbIn);
+
+/**
+ * @public
+ * @brief Writes several buffers (in order) without first copying them together.
+ * 		Uses the ioStream's vectored write if bound, otherwise writes each buffer in turn.
+ */
+bool cxa_ioStream_writeBytes_vectored(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn);
 bool cxa_ioStream_writeString(cxa_ioStream_t *const ioStreamIn, const char* stringIn);
 bool cxa_ioStream_writeLine(cxa_ioStream_t *const ioStreamIn, const char* stringIn);
 bool cxa_ioStream_writeFormattedString(cxa_ioStream_t *const ioStreamIn, const char* formatIn, ...);
@@ -115,6 +115,7 @@ struct cxa_stateMachine
 	cxa_stateMachine_state_t* nextState;
 
 	bool hasStarted;
+	int threadId;
 
 	cxa_array_t states;
 	cxa_stateMachine_state_t states_raw[CXA_STATE_MACHINE_MAXNUM_STATES];
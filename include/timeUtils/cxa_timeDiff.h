@@ -43,15 +43,26 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <cxa_timeBase.h>
+#include <cxa_config.h>
 
 
 // ******** global macro definitions ********
 
 
 // ******** global type definitions *********
+/**
+ * @public
+ * When CXA_TIMEDIFF_64BIT_ENABLE is defined, timeDiffs are backed by the
+ * 64-bit timeBase (::cxa_timeBase_getCount64_us) and are not subject to
+ * timeBase rollover.
+ */
 typedef struct
 {
+#ifdef CXA_TIMEDIFF_64BIT_ENABLE
+	uint64_t startTime_us;
+#else
 	uint32_t startTime_us;
+#endif
 }cxa_timeDiff_t;
 
 
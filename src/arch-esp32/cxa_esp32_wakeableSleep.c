@@ -0,0 +1,115 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_wakeableSleep.h"
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdatomic.h>
+
+#include <cxa_assert.h>
+#include <cxa_criticalSection.h>
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+
+// ******** local macro definitions ********
+#ifndef CXA_ESP32_MAXNUM_WAKEABLESLEEPS
+#define CXA_ESP32_MAXNUM_WAKEABLESLEEPS		2
+#endif
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_wakeableSleep_t super;
+
+	bool isUsed;
+
+	// captured on every sleep, wakeups are delivered as task notifications
+	_Atomic(TaskHandle_t) task;
+
+	// latches wakeups posted before the owning task first sleeps (task == NULL)
+	atomic_bool isWakePending;
+}cxa_esp32_wakeableSleep_t;
+
+
+// ******** local function prototypes ********
+
+
+// ********  local variable declarations *********
+static cxa_esp32_wakeableSleep_t wakeableSleeps[CXA_ESP32_MAXNUM_WAKEABLESLEEPS];
+
+
+// ******** global function implementations ********
+cxa_wakeableSleep_t* cxa_wakeableSleep_reserve(void)
+{
+	cxa_esp32_wakeableSleep_t* retVal = NULL;
+
+	cxa_criticalSection_enter();
+	for( size_t i = 0; i < sizeof(wakeableSleeps)/sizeof(*wakeableSleeps); i++ )
+	{
+		if( !wakeableSleeps[i].isUsed )
+		{
+			wakeableSleeps[i].isUsed = true;
+			atomic_init(&wakeableSleeps[i].task, NULL);
+			atomic_init(&wakeableSleeps[i].isWakePending, false);
+			retVal = &wakeableSleeps[i];
+			break;
+		}
+	}
+	cxa_criticalSection_exit();
+
+	return (retVal != NULL) ? &retVal->super : NULL;
+}
+
+
+void cxa_wakeableSleep_sleep_us(cxa_wakeableSleep_t *const wsIn, uint32_t maxSleep_usIn)
+{
+	cxa_esp32_wakeableSleep_t* wsEsp = (cxa_esp32_wakeableSleep_t*)wsIn;
+	cxa_assert(wsEsp);
+
+	// publish our handle _before_ checking for a pending wake (pairs with wake)
+	atomic_store(&wsEsp->task, xTaskGetCurrentTaskHandle());
+	if( atomic_exchange(&wsEsp->isWakePending, false) ) return;
+
+	// round up (us->ms and ms->ticks) so we never wake _before_ the requested deadline
+	uint32_t sleep_ms = (maxSleep_usIn + 999) / 1000;
+	TickType_t numTicks = (TickType_t)((sleep_ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+	ulTaskNotifyTake(pdTRUE, (numTicks > 0) ? numTicks : 1);
+
+	// we're returning anyways, so any wakeup up to this point has been delivered
+	atomic_store(&wsEsp->isWakePending, false);
+}
+
+
+void cxa_wakeableSleep_wake(cxa_wakeableSleep_t *const wsIn)
+{
+	cxa_esp32_wakeableSleep_t* wsEsp = (cxa_esp32_wakeableSleep_t*)wsIn;
+	cxa_assert(wsEsp);
+
+	// if the owner hasn't slept yet, its first sleep will see the flag
+	atomic_store(&wsEsp->isWakePending, true);
+	TaskHandle_t task = atomic_load(&wsEsp->task);
+	if( task == NULL ) return;
+
+	if( xPortInIsrContext() )
+	{
+		BaseType_t higherPriorityTaskWoken = pdFALSE;
+		vTaskNotifyGiveFromISR(task, &higherPriorityTaskWoken);
+		if( higherPriorityTaskWoken ) portYIELD_FROM_ISR();
+	}
+	else
+	{
+		xTaskNotifyGive(task);
+	}
+}
+
+
+// ******** local function implementations ********
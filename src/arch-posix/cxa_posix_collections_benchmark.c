@@ -0,0 +1,216 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_collections_benchmark.h"
+
+
+// ******** includes ********
+#include <pthread.h>
+#include <sched.h>
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_fixedByteBuffer.h>
+#include <cxa_spscFifo.h>
+#include <cxa_timeBase.h>
+
+
+// ******** local macro definitions ********
+#define NS_PER_MS							1000000ull
+
+// just past an MQTT fixed header
+#define FBB_INSERT_INDEX					2
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	size_t numBytes;
+	size_t maxChunkSize_bytes;
+	size_t numStalls;
+}producer_t;
+
+
+// ******** local function prototypes ********
+static void* fifoProducerThread(void* userVarIn);
+static uint64_t timeFbbOps(cxa_fixedByteBuffer_t *const fbbIn, uint8_t *const insertBytesIn, size_t insertSize_bytesIn,
+						   size_t numOpsIn, bool isPerByteIn);
+
+
+// ********  local variable declarations *********
+static cxa_spscFifo_t fifo;
+static uint8_t fifo_buffer[CXA_POSIX_COLLECTIONS_BENCHMARK_FIFO_SIZE_BYTES];
+
+static cxa_fixedByteBuffer_t fbb;
+static uint8_t fbb_buffer[CXA_POSIX_COLLECTIONS_BENCHMARK_FBB_SIZE_BYTES];
+static uint8_t fbb_expected[CXA_POSIX_COLLECTIONS_BENCHMARK_FBB_SIZE_BYTES];
+static uint8_t fbb_insertBytes[CXA_POSIX_COLLECTIONS_BENCHMARK_FBB_SIZE_BYTES];
+
+
+// ******** global function implementations ********
+bool cxa_posix_collections_benchmark_measureSpscFifo(size_t numBytesIn, size_t maxChunkSize_bytesIn,
+													 cxa_posix_collections_benchmark_fifoResults_t *const resultsOut)
+{
+	cxa_assert(resultsOut);
+
+	if( (numBytesIn == 0) || (maxChunkSize_bytesIn == 0) ) return false;
+
+	cxa_spscFifo_initStd(&fifo, fifo_buffer);
+
+	producer_t producer;
+	producer.numBytes = numBytesIn;
+	producer.maxChunkSize_bytes = maxChunkSize_bytesIn;
+	producer.numStalls = 0;
+
+	resultsOut->numBytes = numBytesIn;
+	resultsOut->maxChunkSize_bytes = maxChunkSize_bytesIn;
+	resultsOut->numErrors = 0;
+	resultsOut->numConsumerStalls = 0;
+
+	uint64_t start_ns = cxa_timeBase_getCount64_ns();
+	pthread_t producerThread;
+	if( pthread_create(&producerThread, NULL, fifoProducerThread, (void*)&producer) != 0 ) return false;
+
+	// the producer writes the (truncated) stream offset of each byte
+	size_t numBytesReceived = 0;
+	while( numBytesReceived < numBytesIn )
+	{
+		uint8_t* elems;
+		size_t numAvailable = cxa_spscFifo_bulkDequeue_peek(&fifo, (void**)&elems);
+		if( numAvailable == 0 )
+		{
+			resultsOut->numConsumerStalls++;
+			sched_yield();
+			continue;
+		}
+
+		for( size_t i = 0; i < numAvailable; i++ )
+		{
+			if( elems[i] != (uint8_t)(numBytesReceived + i) ) resultsOut->numErrors++;
+		}
+		cxa_spscFifo_bulkDequeue(&fifo, numAvailable);
+		numBytesReceived += numAvailable;
+	}
+	uint64_t elapsed_ns = cxa_timeBase_getCount64_ns() - start_ns;
+	pthread_join(producerThread, NULL);
+
+	resultsOut->numProducerStalls = producer.numStalls;
+	resultsOut->elapsed_ms = elapsed_ns / NS_PER_MS;
+	resultsOut->throughput_bytesPerSec = (elapsed_ns != 0) ? ((numBytesIn * 1000000000ull) / elapsed_ns) : 0;
+
+	return true;
+}
+
+
+void cxa_posix_collections_benchmark_writeFifoResults(const cxa_posix_collections_benchmark_fifoResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(resultsIn);
+	cxa_assert(ioStreamIn);
+
+	// formatted writes are limited to CXA_IOSTREAM_FORMATTED_BUFFERLEN_BYTES
+	cxa_ioStream_writeFormattedString(ioStreamIn, "bytes: %zu ", resultsIn->numBytes);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "chunk: %zu ", resultsIn->maxChunkSize_bytes);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "errors: %zu ", resultsIn->numErrors);
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu MB/s", (unsigned long)(resultsIn->throughput_bytesPerSec / 1000000));
+}
+
+
+bool cxa_posix_collections_benchmark_measureFixedByteBuffer(size_t payloadSize_bytesIn, size_t insertSize_bytesIn, size_t numOpsIn,
+															cxa_posix_collections_benchmark_fbbResults_t *const resultsOut)
+{
+	cxa_assert(resultsOut);
+
+	if( (payloadSize_bytesIn < FBB_INSERT_INDEX) || (insertSize_bytesIn == 0) || (numOpsIn == 0) ||
+		((payloadSize_bytesIn + insertSize_bytesIn) > sizeof(fbb_buffer)) ) return false;
+
+	for( size_t i = 0; i < payloadSize_bytesIn; i++ ) fbb_expected[i] = (uint8_t)i;
+	for( size_t i = 0; i < insertSize_bytesIn; i++ ) fbb_insertBytes[i] = (uint8_t)('a' + (i % 26));
+
+	cxa_fixedByteBuffer_initStd(&fbb, fbb_buffer);
+	cxa_fixedByteBuffer_append(&fbb, fbb_expected, payloadSize_bytesIn);
+
+	uint64_t bulk_ns = timeFbbOps(&fbb, fbb_insertBytes, insertSize_bytesIn, numOpsIn, false);
+	uint64_t perByte_ns = timeFbbOps(&fbb, fbb_insertBytes, insertSize_bytesIn, numOpsIn, true);
+
+	// every insert was undone by a remove
+	cxa_assert_msg((cxa_fixedByteBuffer_getSize_bytes(&fbb) == payloadSize_bytesIn) &&
+				   (memcmp(fbb_buffer, fbb_expected, payloadSize_bytesIn) == 0), "fixedByteBuffer corrupted");
+
+	resultsOut->payloadSize_bytes = payloadSize_bytesIn;
+	resultsOut->insertSize_bytes = insertSize_bytesIn;
+	resultsOut->numOps = numOpsIn;
+	resultsOut->bulk_nsPerOp = bulk_ns / numOpsIn;
+	resultsOut->perByte_nsPerOp = perByte_ns / numOpsIn;
+
+	return true;
+}
+
+
+void cxa_posix_collections_benchmark_writeFbbResults(const cxa_posix_collections_benchmark_fbbResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(resultsIn);
+	cxa_assert(ioStreamIn);
+
+	cxa_ioStream_writeFormattedString(ioStreamIn, "payload: %zu ", resultsIn->payloadSize_bytes);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "insert: %zu ", resultsIn->insertSize_bytes);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "bulk: %lu ns ", (unsigned long)resultsIn->bulk_nsPerOp);
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "perByte: %lu ns", (unsigned long)resultsIn->perByte_nsPerOp);
+}
+
+
+// ******** local function implementations ********
+static void* fifoProducerThread(void* userVarIn)
+{
+	producer_t* producer = (producer_t*)userVarIn;
+	cxa_assert(producer);
+
+	size_t numBytesSent = 0;
+	while( numBytesSent < producer->numBytes )
+	{
+		uint8_t* elems;
+		size_t numFree = cxa_spscFifo_bulkQueue_reserve(&fifo, (void**)&elems);
+		if( numFree == 0 )
+		{
+			producer->numStalls++;
+			sched_yield();
+			continue;
+		}
+
+		size_t numToSend = producer->numBytes - numBytesSent;
+		if( numToSend > numFree ) numToSend = numFree;
+		if( numToSend > producer->maxChunkSize_bytes ) numToSend = producer->maxChunkSize_bytes;
+
+		for( size_t i = 0; i < numToSend; i++ ) elems[i] = (uint8_t)(numBytesSent + i);
+		cxa_spscFifo_bulkQueue_commit(&fifo, numToSend);
+		numBytesSent += numToSend;
+	}
+
+	return NULL;
+}
+
+
+static uint64_t timeFbbOps(cxa_fixedByteBuffer_t *const fbbIn, uint8_t *const insertBytesIn, size_t insertSize_bytesIn,
+						   size_t numOpsIn, bool isPerByteIn)
+{
+	cxa_assert(fbbIn);
+	cxa_assert(insertBytesIn);
+
+	uint64_t start_ns = cxa_timeBase_getCount64_ns();
+	for( size_t i = 0; i < numOpsIn; i++ )
+	{
+		if( isPerByteIn )
+		{
+			for( size_t j = 0; j < insertSize_bytesIn; j++ ) cxa_fixedByteBuffer_insert(fbbIn, FBB_INSERT_INDEX + j, &insertBytesIn[j], 1);
+			for( size_t j = 0; j < insertSize_bytesIn; j++ ) cxa_fixedByteBuffer_remove(fbbIn, FBB_INSERT_INDEX, 1);
+		}
+		else
+		{
+			cxa_fixedByteBuffer_insert(fbbIn, FBB_INSERT_INDEX, insertBytesIn, insertSize_bytesIn);
+			cxa_fixedByteBuffer_remove(fbbIn, FBB_INSERT_INDEX, insertSize_bytesIn);
+		}
+	}
+	return cxa_timeBase_getCount64_ns() - start_ns;
+}
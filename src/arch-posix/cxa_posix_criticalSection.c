@@ -19,15 +19,19 @@
 
 
 // ******** local function prototypes ********
+static void initMutex(void);
 
 
 // ********  local variable declarations *********
-pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+// recursive: critical sections can be nested (see cxa_criticalSection.h)
+pthread_mutex_t mutex;
+static pthread_once_t mutexOnce = PTHREAD_ONCE_INIT;
 
 
 // ******** global function implementations ********
 void cxa_criticalSection_enter(void)
 {
+	pthread_once( &mutexOnce, initMutex );
 	pthread_mutex_lock( &mutex );
 }
 
@@ -39,3 +43,11 @@ void cxa_criticalSection_exit(void)
 
 
 // ******** local function implementations ********
+static void initMutex(void)
+{
+	pthread_mutexattr_t attr;
+	pthread_mutexattr_init( &attr );
+	pthread_mutexattr_settype( &attr, PTHREAD_MUTEX_RECURSIVE );
+	pthread_mutex_init( &mutex, &attr );
+	pthread_mutexattr_destroy( &attr );
+}
@@ -0,0 +1,377 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_mqtt_benchmark.h"
+
+
+// ******** includes ********
+#include <stdio.h>
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_mqtt_messageFactory.h>
+#include <cxa_runLoop.h>
+#include <cxa_timeBase.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define TOPIC_PREFIX						"bench/"
+#define PAYLOAD_INDEX_TIMESTAMP				0
+#define PAYLOAD_INDEX_PUBLISHER				8
+
+#define NS_PER_MS							1000000ull
+#define KEEPALIVE_S							60
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool areAllClientsReady(cxa_posix_mqtt_benchmark_t *const benchIn);
+static bool isEverythingReceived(cxa_posix_mqtt_benchmark_t *const benchIn);
+static void publishPending(cxa_posix_mqtt_benchmark_t *const benchIn, uint64_t now_nsIn);
+static void recordLatency(cxa_posix_mqtt_benchmark_t *const benchIn, uint64_t latency_nsIn);
+static void computeResults(cxa_posix_mqtt_benchmark_t *const benchIn, uint64_t start_nsIn);
+static int compareSamples(const void* aIn, const void* bIn);
+
+static void mqttClientCb_onPublish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+								   char* topicNameIn, size_t topicNameLen_bytesIn, void* payloadIn, size_t payloadLen_bytesIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+bool cxa_posix_mqtt_benchmark_init(cxa_posix_mqtt_benchmark_t *const benchIn, const cxa_posix_mqtt_benchmark_config_t *const configIn, int threadIdIn)
+{
+	cxa_assert(benchIn);
+	cxa_assert(configIn);
+
+	cxa_logger_init(&benchIn->logger, "mqttBench");
+
+	// validate our configuration
+	if( (configIn->numClients == 0) || (configIn->numClients > CXA_POSIX_MQTT_BENCHMARK_MAXNUM_CLIENTS) )
+	{
+		cxa_logger_warn(&benchIn->logger, "numClients must be 1-%d", CXA_POSIX_MQTT_BENCHMARK_MAXNUM_CLIENTS);
+		return false;
+	}
+	if( (configIn->payloadSize_bytes < CXA_POSIX_MQTT_BENCHMARK_MINSIZE_PAYLOAD_BYTES) ||
+		(configIn->payloadSize_bytes > CXA_POSIX_MQTT_BENCHMARK_MAXSIZE_PAYLOAD_BYTES) )
+	{
+		cxa_logger_warn(&benchIn->logger, "payloadSize_bytes must be %d-%d", CXA_POSIX_MQTT_BENCHMARK_MINSIZE_PAYLOAD_BYTES, CXA_POSIX_MQTT_BENCHMARK_MAXSIZE_PAYLOAD_BYTES);
+		return false;
+	}
+	if( configIn->duration_ms == 0 )
+	{
+		cxa_logger_warn(&benchIn->logger, "duration_ms must be non-zero");
+		return false;
+	}
+
+	// save our references
+	benchIn->config = *configIn;
+	benchIn->threadId = threadIdIn;
+	benchIn->lastDelivery_ns = 0;
+	benchIn->numLatencySamples = 0;
+	benchIn->latencySum_ns = 0;
+	memset(&benchIn->results, 0, sizeof(benchIn->results));
+
+	// filler so the payload isn't trivially compressible / all zeros
+	for( size_t i = 0; i < sizeof(benchIn->payload); i++ ) benchIn->payload[i] = (uint8_t)i;
+
+	cxa_mqtt_broker_init(&benchIn->broker, NULL, threadIdIn);
+
+	// client i publishes to bench/<i>, client i+1 (wrapping) subscribes to it
+	for( size_t i = 0; i < benchIn->config.numClients; i++ )
+	{
+		cxa_posix_mqtt_benchmark_client_t* currClient = &benchIn->clients[i];
+		size_t publisherIndex = (i + benchIn->config.numClients - 1) % benchIn->config.numClients;
+
+		currClient->index = i;
+		currClient->nextPublish_ns = 0;
+		currClient->numPublished = 0;
+		currClient->numReceivedBySubscriber = 0;
+		snprintf(currClient->clientId, sizeof(currClient->clientId), "bench%zu", i);
+		snprintf(currClient->pubTopic, sizeof(currClient->pubTopic), TOPIC_PREFIX "%zu", i);
+		snprintf(currClient->subTopic, sizeof(currClient->subTopic), TOPIC_PREFIX "%zu", publisherIndex);
+
+		cxa_ioStream_pipe_init(&currClient->pipe);
+		cxa_mqtt_client_init(&currClient->client, cxa_ioStream_pipe_getEndpoint1(&currClient->pipe), KEEPALIVE_S, currClient->clientId, threadIdIn);
+		cxa_mqtt_client_subscribe(&currClient->client, currClient->subTopic, benchIn->config.qos, mqttClientCb_onPublish, benchIn);
+		cxa_assert_msg(cxa_mqtt_broker_attachIoStream(&benchIn->broker, cxa_ioStream_pipe_getEndpoint2(&currClient->pipe)),
+					   "increase CXA_MQTT_BROKER_MAXNUM_CONNECTIONS");
+	}
+
+	return true;
+}
+
+
+bool cxa_posix_mqtt_benchmark_run(cxa_posix_mqtt_benchmark_t *const benchIn)
+{
+	cxa_assert(benchIn);
+
+	// let everything start up before connecting
+	cxa_runLoop_iterate(benchIn->threadId);
+	for( size_t i = 0; i < benchIn->config.numClients; i++ )
+	{
+		cxa_mqtt_client_connect(&benchIn->clients[i].client, NULL, NULL, 0);
+	}
+
+	uint64_t connectStart_ns = cxa_timeBase_getCount64_ns();
+	while( !areAllClientsReady(benchIn) )
+	{
+		if( (cxa_timeBase_getCount64_ns() - connectStart_ns) > (CXA_POSIX_MQTT_BENCHMARK_CONNECT_TIMEOUT_MS * NS_PER_MS) )
+		{
+			cxa_logger_warn(&benchIn->logger, "clients did not connect / subscribe in time");
+			return false;
+		}
+		cxa_runLoop_iterate(benchIn->threadId);
+	}
+	cxa_logger_info(&benchIn->logger, "%zu clients ready, publishing for %lu ms",
+					benchIn->config.numClients, (unsigned long)benchIn->config.duration_ms);
+
+	// publish phase
+	uint64_t start_ns = cxa_timeBase_getCount64_ns();
+	for( size_t i = 0; i < benchIn->config.numClients; i++ ) benchIn->clients[i].nextPublish_ns = start_ns;
+
+	uint64_t now_ns;
+	while( ((now_ns = cxa_timeBase_getCount64_ns()) - start_ns) < (benchIn->config.duration_ms * NS_PER_MS) )
+	{
+		publishPending(benchIn, now_ns);
+		cxa_runLoop_iterate(benchIn->threadId);
+	}
+
+	// drain phase
+	uint64_t drainStart_ns = cxa_timeBase_getCount64_ns();
+	while( !isEverythingReceived(benchIn) &&
+		   ((cxa_timeBase_getCount64_ns() - drainStart_ns) < (CXA_POSIX_MQTT_BENCHMARK_DRAIN_TIMEOUT_MS * NS_PER_MS)) )
+	{
+		cxa_runLoop_iterate(benchIn->threadId);
+	}
+
+	computeResults(benchIn, start_ns);
+	return true;
+}
+
+
+const cxa_posix_mqtt_benchmark_results_t* cxa_posix_mqtt_benchmark_getResults(cxa_posix_mqtt_benchmark_t *const benchIn)
+{
+	cxa_assert(benchIn);
+
+	return &benchIn->results;
+}
+
+
+void cxa_posix_mqtt_benchmark_writeResults(cxa_posix_mqtt_benchmark_t *const benchIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(benchIn);
+	cxa_assert(ioStreamIn);
+
+	cxa_posix_mqtt_benchmark_config_t* config = &benchIn->config;
+	cxa_posix_mqtt_benchmark_results_t* results = &benchIn->results;
+
+	// labels and values are written separately (formatted writes are limited
+	// to CXA_IOSTREAM_FORMATTED_BUFFERLEN_BYTES)
+	cxa_ioStream_writeString(ioStreamIn, "clients:        ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu", config->numClients);
+	cxa_ioStream_writeString(ioStreamIn, "qos:            ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%d", config->qos);
+	cxa_ioStream_writeString(ioStreamIn, "payload:        ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu bytes", config->payloadSize_bytes);
+	cxa_ioStream_writeString(ioStreamIn, "rate:           ");
+	if( config->publishRate_hz != 0 ) cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu Hz/client", (unsigned long)config->publishRate_hz);
+	else cxa_ioStream_writeLine(ioStreamIn, "unlimited");
+	cxa_ioStream_writeString(ioStreamIn, "outstanding:    ");
+	if( config->maxNumOutstanding != 0 ) cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu/client", config->maxNumOutstanding);
+	else cxa_ioStream_writeLine(ioStreamIn, "unlimited");
+	cxa_ioStream_writeString(ioStreamIn, "duration:       ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu ms", (unsigned long)config->duration_ms);
+
+	cxa_ioStream_writeString(ioStreamIn, "published:      ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu", results->numPublished);
+	cxa_ioStream_writeString(ioStreamIn, "throttled:      ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu", results->numThrottled);
+	cxa_ioStream_writeString(ioStreamIn, "received:       ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu", results->numReceived);
+	cxa_ioStream_writeString(ioStreamIn, "lost:           ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu", results->numLost);
+	cxa_ioStream_writeString(ioStreamIn, "elapsed:        ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu ms", (unsigned long)results->elapsed_ms);
+	cxa_ioStream_writeString(ioStreamIn, "throughput:     ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu msgs/s", (unsigned long)results->throughput_msgsPerSec);
+
+	cxa_ioStream_writeString(ioStreamIn, "latency min:    ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%.1f us", results->latencyMin_ns / 1000.0);
+	cxa_ioStream_writeString(ioStreamIn, "latency mean:   ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%.1f us", results->latencyMean_ns / 1000.0);
+	cxa_ioStream_writeString(ioStreamIn, "latency p50:    ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%.1f us", results->latencyP50_ns / 1000.0);
+	cxa_ioStream_writeString(ioStreamIn, "latency p90:    ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%.1f us", results->latencyP90_ns / 1000.0);
+	cxa_ioStream_writeString(ioStreamIn, "latency p99:    ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%.1f us", results->latencyP99_ns / 1000.0);
+	cxa_ioStream_writeString(ioStreamIn, "latency max:    ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%.1f us", results->latencyMax_ns / 1000.0);
+
+	cxa_ioStream_writeString(ioStreamIn, "factory hwm:    ");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%zu msgs", results->factoryHighWaterMark);
+	cxa_ioStream_writeString(ioStreamIn, "factory exhaust:");
+	cxa_ioStream_writeFormattedLine(ioStreamIn, " %zu", results->factoryNumExhausted);
+}
+
+
+// ******** local function implementations ********
+static bool areAllClientsReady(cxa_posix_mqtt_benchmark_t *const benchIn)
+{
+	cxa_assert(benchIn);
+
+	for( size_t i = 0; i < benchIn->config.numClients; i++ )
+	{
+		cxa_mqtt_client_t* currClient = &benchIn->clients[i].client;
+		if( !cxa_mqtt_client_isConnected(currClient) ) return false;
+
+		cxa_array_iterate(&currClient->subscriptions, currSub, cxa_mqtt_client_subscriptionEntry_t)
+		{
+			if( currSub == NULL ) continue;
+			if( currSub->state != CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_ACKNOWLEDGED ) return false;
+		}
+	}
+	return true;
+}
+
+
+static bool isEverythingReceived(cxa_posix_mqtt_benchmark_t *const benchIn)
+{
+	cxa_assert(benchIn);
+
+	for( size_t i = 0; i < benchIn->config.numClients; i++ )
+	{
+		cxa_posix_mqtt_benchmark_client_t* currClient = &benchIn->clients[i];
+		if( currClient->numReceivedBySubscriber < currClient->numPublished ) return false;
+	}
+	return true;
+}
+
+
+static void publishPending(cxa_posix_mqtt_benchmark_t *const benchIn, uint64_t now_nsIn)
+{
+	cxa_assert(benchIn);
+
+	uint64_t period_ns = (benchIn->config.publishRate_hz != 0) ? (1000000000ull / benchIn->config.publishRate_hz) : 0;
+
+	for( size_t i = 0; i < benchIn->config.numClients; i++ )
+	{
+		cxa_posix_mqtt_benchmark_client_t* currClient = &benchIn->clients[i];
+
+		// catch up on any missed slots, but don't publish more than once per
+		// iteration (give the broker / subscriber a chance to keep up)
+		if( now_nsIn < currClient->nextPublish_ns ) continue;
+		if( (benchIn->config.maxNumOutstanding != 0) &&
+			((currClient->numPublished - currClient->numReceivedBySubscriber) >= benchIn->config.maxNumOutstanding) ) continue;
+		// unthrottled: a full in-flight window is the expected steady state
+		if( (period_ns == 0) && (benchIn->config.qos != CXA_MQTT_QOS_ATMOST_ONCE) &&
+			(cxa_mqtt_client_getNumFreeInflightSlots(&currClient->client) == 0) ) continue;
+		currClient->nextPublish_ns += period_ns;
+
+		uint64_t timestamp_ns = cxa_timeBase_getCount64_ns();
+		memcpy(&benchIn->payload[PAYLOAD_INDEX_TIMESTAMP], &timestamp_ns, sizeof(timestamp_ns));
+		benchIn->payload[PAYLOAD_INDEX_PUBLISHER] = currClient->index;
+
+		if( cxa_mqtt_client_publish_withCallback(&currClient->client, benchIn->config.qos, false,
+												 currClient->pubTopic, benchIn->payload, benchIn->config.payloadSize_bytes,
+												 NULL, NULL) )
+		{
+			currClient->numPublished++;
+			benchIn->results.numPublished++;
+		}
+		else benchIn->results.numThrottled++;
+	}
+}
+
+
+static void recordLatency(cxa_posix_mqtt_benchmark_t *const benchIn, uint64_t latency_nsIn)
+{
+	cxa_assert(benchIn);
+
+	uint32_t latency_ns = (latency_nsIn > UINT32_MAX) ? UINT32_MAX : (uint32_t)latency_nsIn;
+	size_t numSeen = benchIn->results.numReceived;
+
+	if( (numSeen == 0) || (latency_ns < benchIn->results.latencyMin_ns) ) benchIn->results.latencyMin_ns = latency_ns;
+	if( latency_ns > benchIn->results.latencyMax_ns ) benchIn->results.latencyMax_ns = latency_ns;
+	benchIn->latencySum_ns += latency_ns;
+
+	// reservoir sampling (numSeen samples came before this one)
+	if( benchIn->numLatencySamples < CXA_POSIX_MQTT_BENCHMARK_MAXNUM_LATENCY_SAMPLES )
+	{
+		benchIn->latencySamples_ns[benchIn->numLatencySamples++] = latency_ns;
+	}
+	else
+	{
+		size_t replaceIndex = (size_t)(((uint64_t)rand() * (numSeen + 1)) / ((uint64_t)RAND_MAX + 1));
+		if( replaceIndex < CXA_POSIX_MQTT_BENCHMARK_MAXNUM_LATENCY_SAMPLES ) benchIn->latencySamples_ns[replaceIndex] = latency_ns;
+	}
+}
+
+
+static void computeResults(cxa_posix_mqtt_benchmark_t *const benchIn, uint64_t start_nsIn)
+{
+	cxa_assert(benchIn);
+
+	cxa_posix_mqtt_benchmark_results_t* results = &benchIn->results;
+
+	results->numLost = results->numPublished - results->numReceived;
+
+	uint64_t elapsed_ns = (benchIn->lastDelivery_ns > start_nsIn) ? (benchIn->lastDelivery_ns - start_nsIn) : 0;
+	results->elapsed_ms = elapsed_ns / NS_PER_MS;
+	results->throughput_msgsPerSec = (elapsed_ns != 0) ? ((results->numReceived * 1000000000ull) / elapsed_ns) : 0;
+
+	if( benchIn->numLatencySamples != 0 )
+	{
+		qsort(benchIn->latencySamples_ns, benchIn->numLatencySamples, sizeof(*benchIn->latencySamples_ns), compareSamples);
+		size_t lastIndex = benchIn->numLatencySamples - 1;
+		results->latencyP50_ns = benchIn->latencySamples_ns[(lastIndex * 50) / 100];
+		results->latencyP90_ns = benchIn->latencySamples_ns[(lastIndex * 90) / 100];
+		results->latencyP99_ns = benchIn->latencySamples_ns[(lastIndex * 99) / 100];
+		results->latencyMean_ns = benchIn->latencySum_ns / results->numReceived;
+	}
+
+	results->factoryHighWaterMark = cxa_mqtt_messageFactory_getHighWaterMark();
+	results->factoryNumExhausted = cxa_mqtt_messageFactory_getNumExhausted();
+}
+
+
+static int compareSamples(const void* aIn, const void* bIn)
+{
+	uint32_t a = *(const uint32_t*)aIn;
+	uint32_t b = *(const uint32_t*)bIn;
+
+	return (a > b) - (a < b);
+}
+
+
+static void mqttClientCb_onPublish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+								   char* topicNameIn, size_t topicNameLen_bytesIn, void* payloadIn, size_t payloadLen_bytesIn, void* userVarIn)
+{
+	cxa_posix_mqtt_benchmark_t* benchIn = (cxa_posix_mqtt_benchmark_t*)userVarIn;
+	cxa_assert(benchIn);
+
+	uint64_t now_ns = cxa_timeBase_getCount64_ns();
+
+	if( payloadLen_bytesIn < CXA_POSIX_MQTT_BENCHMARK_MINSIZE_PAYLOAD_BYTES ) return;
+	uint8_t* payload = (uint8_t*)payloadIn;
+	uint8_t publisherIndex = payload[PAYLOAD_INDEX_PUBLISHER];
+	if( publisherIndex >= benchIn->config.numClients ) return;
+
+	uint64_t timestamp_ns;
+	memcpy(&timestamp_ns, &payload[PAYLOAD_INDEX_TIMESTAMP], sizeof(timestamp_ns));
+
+	recordLatency(benchIn, now_ns - timestamp_ns);
+	benchIn->clients[publisherIndex].numReceivedBySubscriber++;
+	benchIn->results.numReceived++;
+	benchIn->lastDelivery_ns = now_ns;
+}
@@ -0,0 +1,530 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_mqtt_offlineQueue.h"
+
+
+// ******** includes ********
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_mqtt_messageFactory.h>
+#include <cxa_mqtt_message_publish.h>
+#include <cxa_runLoop.h>
+#include <cxa_stringUtils.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define SEGMENT_MAGIC						0x4D514F51		// "MQOQ"
+#define SEGMENT_NAME_FORMAT					"%s/seg_%08u.log"
+#define SEGMENT_NAME_SCAN_FORMAT			"seg_%08u.log"
+#define SEGMENT_HEADER_SIZE_BYTES			sizeof(segmentHeader_t)
+
+#define RECORD_HEADER_SIZE_BYTES			12
+#define RECORD_ALIGN(x)						(((x) + 3) & ~((size_t)3))
+
+
+// ******** local type definitions ********
+/*
+ * Stored at the start of each (mapped) segment file. Records follow, each:
+ *   uint32_t recordLen_bytes (0 marks the end of the segment's records)
+ *   uint8_t qos, uint8_t retain, uint16_t topicLen_bytes
+ *   uint32_t payloadLen_bytes
+ *   topic (null-terminated), payload, padding to 4 bytes
+ */
+typedef struct
+{
+	uint32_t magic;
+	uint32_t readOffset;
+	uint32_t numRecords;
+	uint32_t numRead;
+}segmentHeader_t;
+
+
+typedef struct
+{
+	uint32_t recordLen_bytes;
+	cxa_mqtt_qosLevel_t qos;
+	bool retain;
+	char* topicName;
+	uint8_t* payload;
+	size_t payloadLen_bytes;
+}record_t;
+
+
+// ******** local function prototypes ********
+static bool getSegmentPath(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint32_t idIn, char *const pathOut, size_t maxPathLen_bytesIn);
+static bool openSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint32_t idIn, bool createIn, cxa_posix_mqtt_offlineQueue_segment_t *const segOut);
+static void closeSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, cxa_posix_mqtt_offlineQueue_segment_t *const segIn);
+static bool scanSegments(cxa_posix_mqtt_offlineQueue_t *const oqIn, bool *const foundAnyOut);
+static uint32_t recoverSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint8_t *const mapIn);
+static void syncRange(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint8_t *const mapIn, size_t offsetIn, size_t len_bytesIn);
+
+static bool startNewWriteSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn);
+static bool advanceReadSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, bool isDropIn);
+
+static bool appendRecord(cxa_posix_mqtt_offlineQueue_t *const oqIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+						 char *const topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn);
+static bool peekRecord(cxa_posix_mqtt_offlineQueue_t *const oqIn, record_t *const recOut);
+static void consumeRecord(cxa_posix_mqtt_offlineQueue_t *const oqIn, record_t *const recIn);
+
+static void runLoopCb_drain(void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+bool cxa_posix_mqtt_offlineQueue_init(cxa_posix_mqtt_offlineQueue_t *const oqIn, const char *const dirIn,
+									  size_t segmentSize_bytesIn, size_t maxNumSegmentsIn,
+									  cxa_mqtt_client_t *const clientIn, int threadIdIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(dirIn);
+	cxa_assert(clientIn);
+	cxa_assert(segmentSize_bytesIn > (SEGMENT_HEADER_SIZE_BYTES + RECORD_HEADER_SIZE_BYTES));
+	cxa_assert_msg(maxNumSegmentsIn >= 2, "need at least 2 segments");
+	cxa_assert_msg(strlen(dirIn) < sizeof(oqIn->dir), "offlineQueue directory too long");
+
+	// save our references
+	cxa_stringUtils_copy(oqIn->dir, (char*)dirIn, sizeof(oqIn->dir));
+	oqIn->segmentSize_bytes = segmentSize_bytesIn;
+	oqIn->maxNumSegments = maxNumSegmentsIn;
+	oqIn->client = clientIn;
+
+	// set some defaults
+	oqIn->readSegment.map = NULL;
+	oqIn->writeSegment.map = NULL;
+	oqIn->numQueued = 0;
+	oqIn->numDropped = 0;
+	oqIn->drainMaxNumPerPeriod = CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_MAXNUM_PER_PERIOD;
+
+	cxa_logger_init(&oqIn->logger, "mqttOfflineQ");
+
+	// find any existing segments (from a previous run)
+	if( (mkdir(oqIn->dir, 0755) != 0) && (errno != EEXIST) )
+	{
+		cxa_logger_error(&oqIn->logger, "failed to create '%s': %s", oqIn->dir, strerror(errno));
+		return false;
+	}
+	bool foundAny = false;
+	if( !scanSegments(oqIn, &foundAny) ) return false;
+
+	if( !foundAny )
+	{
+		// fresh queue
+		oqIn->firstSegmentId = 0;
+		oqIn->lastSegmentId = 0;
+		if( !openSegment(oqIn, 0, true, &oqIn->writeSegment) ) return false;
+	}
+	else if( !openSegment(oqIn, oqIn->lastSegmentId, false, &oqIn->writeSegment) ) return false;
+	oqIn->writeOffset = recoverSegment(oqIn, oqIn->writeSegment.map);
+
+	if( !openSegment(oqIn, oqIn->firstSegmentId, false, &oqIn->readSegment) ) return false;
+
+	if( oqIn->numQueued > 0 ) cxa_logger_info(&oqIn->logger, "%d publishes queued from previous run", (int)oqIn->numQueued);
+
+	// drain whenever our client is connected
+	cxa_runLoop_addTimedEntry(threadIdIn, CXA_POSIX_MQTT_OFFLINEQUEUE_DRAIN_PERIOD_MS, NULL, runLoopCb_drain, (void*)oqIn);
+
+	return true;
+}
+
+
+bool cxa_posix_mqtt_offlineQueue_publish(cxa_posix_mqtt_offlineQueue_t *const oqIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+										 char *const topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(topicNameIn);
+
+	// only skip the queue if that won't reorder publishes
+	if( (oqIn->numQueued == 0) && cxa_mqtt_client_isConnected(oqIn->client) &&
+		cxa_mqtt_client_publish(oqIn->client, qosIn, retainIn, topicNameIn, payloadIn, payloadLen_bytesIn) ) return true;
+
+	return appendRecord(oqIn, qosIn, retainIn, topicNameIn, payloadIn, payloadLen_bytesIn);
+}
+
+
+void cxa_posix_mqtt_offlineQueue_setDrainRate(cxa_posix_mqtt_offlineQueue_t *const oqIn, size_t maxNumPerPeriodIn)
+{
+	cxa_assert(oqIn);
+
+	oqIn->drainMaxNumPerPeriod = maxNumPerPeriodIn;
+}
+
+
+size_t cxa_posix_mqtt_offlineQueue_getNumQueued(cxa_posix_mqtt_offlineQueue_t *const oqIn)
+{
+	cxa_assert(oqIn);
+
+	return oqIn->numQueued;
+}
+
+
+size_t cxa_posix_mqtt_offlineQueue_getNumDropped(cxa_posix_mqtt_offlineQueue_t *const oqIn)
+{
+	cxa_assert(oqIn);
+
+	return oqIn->numDropped;
+}
+
+
+// ******** local function implementations ********
+static bool getSegmentPath(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint32_t idIn, char *const pathOut, size_t maxPathLen_bytesIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(pathOut);
+
+	int len = snprintf(pathOut, maxPathLen_bytesIn, SEGMENT_NAME_FORMAT, oqIn->dir, idIn);
+	return (len > 0) && ((size_t)len < maxPathLen_bytesIn);
+}
+
+
+static bool openSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint32_t idIn, bool createIn, cxa_posix_mqtt_offlineQueue_segment_t *const segOut)
+{
+	cxa_assert(oqIn);
+	cxa_assert(segOut);
+
+	char path[CXA_POSIX_MQTT_OFFLINEQUEUE_MAXLEN_DIR_BYTES + 32];
+	if( !getSegmentPath(oqIn, idIn, path, sizeof(path)) ) return false;
+
+	int fd = open(path, O_RDWR | (createIn ? (O_CREAT | O_TRUNC) : 0), 0644);
+	if( fd < 0 )
+	{
+		cxa_logger_error(&oqIn->logger, "failed to open '%s': %s", path, strerror(errno));
+		return false;
+	}
+
+	// new segments are zero-filled (which marks the end of records)
+	struct stat st;
+	if( (createIn && (ftruncate(fd, oqIn->segmentSize_bytes) != 0)) ||
+		(fstat(fd, &st) != 0) || ((size_t)st.st_size != oqIn->segmentSize_bytes) )
+	{
+		cxa_logger_error(&oqIn->logger, "segment '%s' has unexpected size", path);
+		close(fd);
+		return false;
+	}
+
+	uint8_t* map = mmap(NULL, oqIn->segmentSize_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if( map == MAP_FAILED )
+	{
+		cxa_logger_error(&oqIn->logger, "failed to map '%s': %s", path, strerror(errno));
+		close(fd);
+		return false;
+	}
+
+	segmentHeader_t* hdr = (segmentHeader_t*)map;
+	if( createIn )
+	{
+		hdr->readOffset = SEGMENT_HEADER_SIZE_BYTES;
+		hdr->numRecords = 0;
+		hdr->numRead = 0;
+		hdr->magic = SEGMENT_MAGIC;
+	}
+	else if( (hdr->magic != SEGMENT_MAGIC) || (hdr->readOffset < SEGMENT_HEADER_SIZE_BYTES) || (hdr->readOffset > oqIn->segmentSize_bytes) )
+	{
+		cxa_logger_error(&oqIn->logger, "segment '%s' is corrupt", path);
+		munmap(map, oqIn->segmentSize_bytes);
+		close(fd);
+		return false;
+	}
+
+	segOut->id = idIn;
+	segOut->fd = fd;
+	segOut->map = map;
+	return true;
+}
+
+
+static void closeSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, cxa_posix_mqtt_offlineQueue_segment_t *const segIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(segIn);
+
+	if( segIn->map == NULL ) return;
+
+	msync(segIn->map, oqIn->segmentSize_bytes, MS_ASYNC);
+	munmap(segIn->map, oqIn->segmentSize_bytes);
+	close(segIn->fd);
+	segIn->map = NULL;
+}
+
+
+static bool scanSegments(cxa_posix_mqtt_offlineQueue_t *const oqIn, bool *const foundAnyOut)
+{
+	cxa_assert(oqIn);
+	cxa_assert(foundAnyOut);
+
+	DIR* dir = opendir(oqIn->dir);
+	if( dir == NULL )
+	{
+		cxa_logger_error(&oqIn->logger, "failed to open '%s': %s", oqIn->dir, strerror(errno));
+		return false;
+	}
+
+	*foundAnyOut = false;
+	struct dirent* currEntry;
+	while( (currEntry = readdir(dir)) != NULL )
+	{
+		unsigned int currId;
+		if( sscanf(currEntry->d_name, SEGMENT_NAME_SCAN_FORMAT, &currId) != 1 ) continue;
+
+		if( !*foundAnyOut || (currId < oqIn->firstSegmentId) ) oqIn->firstSegmentId = currId;
+		if( !*foundAnyOut || (currId > oqIn->lastSegmentId) ) oqIn->lastSegmentId = currId;
+		*foundAnyOut = true;
+	}
+	closedir(dir);
+
+	// count what's left to send
+	if( *foundAnyOut )
+	{
+		for( uint32_t currId = oqIn->firstSegmentId; currId <= oqIn->lastSegmentId; currId++ )
+		{
+			cxa_posix_mqtt_offlineQueue_segment_t seg;
+			if( !openSegment(oqIn, currId, false, &seg) ) return false;
+
+			recoverSegment(oqIn, seg.map);
+			segmentHeader_t* hdr = (segmentHeader_t*)seg.map;
+			oqIn->numQueued += hdr->numRecords - hdr->numRead;
+			closeSegment(oqIn, &seg);
+		}
+	}
+
+	return true;
+}
+
+
+static uint32_t recoverSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint8_t *const mapIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(mapIn);
+
+	// the header isn't updated atomically with the records (and may not have
+	// made it to disk at all), so rebuild it from the committed records
+	segmentHeader_t* hdr = (segmentHeader_t*)mapIn;
+	uint32_t numRecords = 0;
+	uint32_t numRead = 0;
+	uint32_t readOffset = SEGMENT_HEADER_SIZE_BYTES;
+
+	// a record is only "committed" once its length is written (see appendRecord)
+	uint32_t currOffset = SEGMENT_HEADER_SIZE_BYTES;
+	while( (currOffset + RECORD_HEADER_SIZE_BYTES) <= oqIn->segmentSize_bytes )
+	{
+		uint32_t recordLen_bytes;
+		uint16_t topicLen_bytes;
+		uint32_t payloadLen_bytes;
+		memcpy(&recordLen_bytes, &mapIn[currOffset], sizeof(recordLen_bytes));
+		memcpy(&topicLen_bytes, &mapIn[currOffset + 6], sizeof(topicLen_bytes));
+		memcpy(&payloadLen_bytes, &mapIn[currOffset + 8], sizeof(payloadLen_bytes));
+		if( (recordLen_bytes == 0) || ((currOffset + recordLen_bytes) > oqIn->segmentSize_bytes) ||
+			(recordLen_bytes != RECORD_ALIGN(RECORD_HEADER_SIZE_BYTES + (size_t)topicLen_bytes + 1 + payloadLen_bytes)) ||
+			(mapIn[currOffset + RECORD_HEADER_SIZE_BYTES + topicLen_bytes] != 0) ) break;
+
+		currOffset += recordLen_bytes;
+		numRecords++;
+		if( currOffset <= hdr->readOffset )
+		{
+			numRead++;
+			readOffset = currOffset;
+		}
+	}
+
+	hdr->numRecords = numRecords;
+	hdr->numRead = numRead;
+	hdr->readOffset = readOffset;
+
+	return currOffset;
+}
+
+
+static void syncRange(cxa_posix_mqtt_offlineQueue_t *const oqIn, uint8_t *const mapIn, size_t offsetIn, size_t len_bytesIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(mapIn);
+
+	// msync needs a page-aligned start address
+	size_t pageSize_bytes = (size_t)sysconf(_SC_PAGESIZE);
+	size_t startOffset = offsetIn & ~(pageSize_bytes - 1);
+	if( msync(&mapIn[startOffset], (offsetIn + len_bytesIn) - startOffset, MS_SYNC) != 0 )
+	{
+		cxa_logger_warn(&oqIn->logger, "msync failed: %s", strerror(errno));
+	}
+}
+
+
+static bool startNewWriteSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn)
+{
+	cxa_assert(oqIn);
+
+	// make room (drop-oldest) before creating our new segment
+	if( ((oqIn->lastSegmentId - oqIn->firstSegmentId) + 1) >= oqIn->maxNumSegments )
+	{
+		if( !advanceReadSegment(oqIn, true) ) return false;
+	}
+
+	// (the read segment always has its own mapping)
+	closeSegment(oqIn, &oqIn->writeSegment);
+	if( !openSegment(oqIn, oqIn->lastSegmentId + 1, true, &oqIn->writeSegment) ) return false;
+	oqIn->lastSegmentId++;
+	oqIn->writeOffset = SEGMENT_HEADER_SIZE_BYTES;
+
+	return true;
+}
+
+
+static bool advanceReadSegment(cxa_posix_mqtt_offlineQueue_t *const oqIn, bool isDropIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(oqIn->firstSegmentId < oqIn->lastSegmentId);
+
+	// anything unread in this segment is lost
+	segmentHeader_t* hdr = (segmentHeader_t*)oqIn->readSegment.map;
+	size_t numUnread = hdr->numRecords - hdr->numRead;
+	oqIn->numQueued -= numUnread;
+	if( isDropIn )
+	{
+		oqIn->numDropped += numUnread;
+		cxa_logger_warn(&oqIn->logger, "queue full, dropped %d oldest publishes", (int)numUnread);
+	}
+
+	char path[CXA_POSIX_MQTT_OFFLINEQUEUE_MAXLEN_DIR_BYTES + 32];
+	closeSegment(oqIn, &oqIn->readSegment);
+	if( getSegmentPath(oqIn, oqIn->firstSegmentId, path, sizeof(path)) ) unlink(path);
+	oqIn->firstSegmentId++;
+
+	return openSegment(oqIn, oqIn->firstSegmentId, false, &oqIn->readSegment);
+}
+
+
+static bool appendRecord(cxa_posix_mqtt_offlineQueue_t *const oqIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+						 char *const topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(topicNameIn);
+	if( payloadLen_bytesIn > 0 ) cxa_assert(payloadIn);
+
+	size_t topicLen_bytes = strlen(topicNameIn);
+	size_t recordLen_bytes = RECORD_ALIGN(RECORD_HEADER_SIZE_BYTES + topicLen_bytes + 1 + payloadLen_bytesIn);
+
+	// don't queue anything that could never be sent (it would block the queue)
+	if( (CXA_MQTT_MESSAGE_PUBLISH_MAXSIZE_BYTES(topicLen_bytes, payloadLen_bytesIn) > CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES) ||
+		(recordLen_bytes > (oqIn->segmentSize_bytes - SEGMENT_HEADER_SIZE_BYTES)) )
+	{
+		cxa_logger_warn(&oqIn->logger, "publish too large to queue, dropped");
+		return false;
+	}
+
+	if( ((oqIn->writeOffset + recordLen_bytes) > oqIn->segmentSize_bytes) && !startNewWriteSegment(oqIn) ) return false;
+
+	// write our record body first...
+	uint8_t* record = &oqIn->writeSegment.map[oqIn->writeOffset];
+	record[4] = (uint8_t)qosIn;
+	record[5] = (uint8_t)retainIn;
+	uint16_t topicLen_u16 = (uint16_t)topicLen_bytes;
+	memcpy(&record[6], &topicLen_u16, sizeof(topicLen_u16));
+	uint32_t payloadLen_u32 = (uint32_t)payloadLen_bytesIn;
+	memcpy(&record[8], &payloadLen_u32, sizeof(payloadLen_u32));
+	memcpy(&record[RECORD_HEADER_SIZE_BYTES], topicNameIn, topicLen_bytes + 1);
+	if( payloadLen_bytesIn > 0 ) memcpy(&record[RECORD_HEADER_SIZE_BYTES + topicLen_bytes + 1], payloadIn, payloadLen_bytesIn);
+
+	syncRange(oqIn, oqIn->writeSegment.map, oqIn->writeOffset + sizeof(uint32_t), recordLen_bytes - sizeof(uint32_t));
+
+	// ...then commit it by writing its length (once the body is on disk)
+	uint32_t recordLen_u32 = (uint32_t)recordLen_bytes;
+	memcpy(&record[0], &recordLen_u32, sizeof(recordLen_u32));
+	((segmentHeader_t*)oqIn->writeSegment.map)->numRecords++;
+	syncRange(oqIn, oqIn->writeSegment.map, oqIn->writeOffset, sizeof(recordLen_u32));
+	syncRange(oqIn, oqIn->writeSegment.map, 0, SEGMENT_HEADER_SIZE_BYTES);
+
+	oqIn->writeOffset += recordLen_bytes;
+	oqIn->numQueued++;
+
+	return true;
+}
+
+
+static bool peekRecord(cxa_posix_mqtt_offlineQueue_t *const oqIn, record_t *const recOut)
+{
+	cxa_assert(oqIn);
+	cxa_assert(recOut);
+
+	while( oqIn->numQueued > 0 )
+	{
+		segmentHeader_t* hdr = (segmentHeader_t*)oqIn->readSegment.map;
+
+		uint32_t recordLen_bytes = 0;
+		if( (hdr->readOffset + RECORD_HEADER_SIZE_BYTES) <= oqIn->segmentSize_bytes )
+		{
+			memcpy(&recordLen_bytes, &oqIn->readSegment.map[hdr->readOffset], sizeof(recordLen_bytes));
+		}
+
+		// move on to the next segment once we've read everything in this one
+		if( (recordLen_bytes == 0) || ((hdr->readOffset + recordLen_bytes) > oqIn->segmentSize_bytes) )
+		{
+			if( oqIn->readSegment.id == oqIn->writeSegment.id ) return false;
+			if( !advanceReadSegment(oqIn, false) ) return false;
+			continue;
+		}
+
+		uint8_t* record = &oqIn->readSegment.map[hdr->readOffset];
+		uint16_t topicLen_bytes;
+		uint32_t payloadLen_bytes;
+		memcpy(&topicLen_bytes, &record[6], sizeof(topicLen_bytes));
+		memcpy(&payloadLen_bytes, &record[8], sizeof(payloadLen_bytes));
+
+		recOut->recordLen_bytes = recordLen_bytes;
+		recOut->qos = (cxa_mqtt_qosLevel_t)record[4];
+		recOut->retain = record[5];
+		recOut->topicName = (char*)&record[RECORD_HEADER_SIZE_BYTES];
+		recOut->payload = &record[RECORD_HEADER_SIZE_BYTES + topicLen_bytes + 1];
+		recOut->payloadLen_bytes = payloadLen_bytes;
+		return true;
+	}
+
+	return false;
+}
+
+
+static void consumeRecord(cxa_posix_mqtt_offlineQueue_t *const oqIn, record_t *const recIn)
+{
+	cxa_assert(oqIn);
+	cxa_assert(recIn);
+
+	segmentHeader_t* hdr = (segmentHeader_t*)oqIn->readSegment.map;
+	hdr->readOffset += recIn->recordLen_bytes;
+	hdr->numRead++;
+	oqIn->numQueued--;
+}
+
+
+static void runLoopCb_drain(void* userVarIn)
+{
+	cxa_posix_mqtt_offlineQueue_t* oqIn = (cxa_posix_mqtt_offlineQueue_t*)userVarIn;
+	cxa_assert(oqIn);
+
+	if( (oqIn->numQueued == 0) || !cxa_mqtt_client_isConnected(oqIn->client) ) return;
+
+	for( size_t i = 0; i < oqIn->drainMaxNumPerPeriod; i++ )
+	{
+		record_t currRecord;
+		if( !peekRecord(oqIn, &currRecord) ) break;
+
+		// the client may refuse for now (eg. in-flight window is full)...try again next period
+		if( !cxa_mqtt_client_publish(oqIn->client, currRecord.qos, currRecord.retain, currRecord.topicName,
+									 currRecord.payload, currRecord.payloadLen_bytes) ) break;
+		consumeRecord(oqIn, &currRecord);
+	}
+}
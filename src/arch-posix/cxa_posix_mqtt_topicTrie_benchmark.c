@@ -0,0 +1,102 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_mqtt_topicTrie_benchmark.h"
+
+
+// ******** includes ********
+#include <stdio.h>
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_mqtt_topicTrie.h>
+#include <cxa_timeBase.h>
+
+
+// ******** local macro definitions ********
+#define MAXLEN_TOPIC_BYTES					40
+#define MAXNUM_FILTER_LEVELS				5
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static void trieCb_onMatch(uint16_t entryIndexIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+static cxa_mqtt_topicTrie_t trie;
+static cxa_mqtt_topicTrie_node_t trie_nodes[1 + (MAXNUM_FILTER_LEVELS * CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS)];
+static uint16_t trie_entryNext[CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS];
+
+// the trie doesn't copy filters
+static char filters[CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS][MAXLEN_TOPIC_BYTES];
+static char topics[CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS][MAXLEN_TOPIC_BYTES];
+
+
+// ******** global function implementations ********
+bool cxa_posix_mqtt_topicTrie_benchmark_measureMatch(size_t numSubscriptionsIn, size_t numMatchesIn,
+													 cxa_posix_mqtt_topicTrie_benchmark_results_t *const resultsOut)
+{
+	cxa_assert(resultsOut);
+
+	if( (numSubscriptionsIn == 0) || (numSubscriptionsIn > CXA_POSIX_MQTT_TOPICTRIE_BENCHMARK_MAXNUM_SUBSCRIPTIONS) || (numMatchesIn == 0) ) return false;
+
+	cxa_mqtt_topicTrie_init(&trie, trie_nodes, sizeof(trie_nodes), trie_entryNext, sizeof(trie_entryNext));
+
+	// groups of 4 filters, each topic "site/<n>/dev/<n>/temp" matches 3 of its group (+, # and exact)
+	for( size_t i = 0; i < numSubscriptionsIn; i++ )
+	{
+		switch( i % 4 )
+		{
+			case 0: snprintf(filters[i], sizeof(filters[i]), "site/%zu/dev/+/temp", i / 4); break;
+			case 1: snprintf(filters[i], sizeof(filters[i]), "site/%zu/dev/#", i / 4); break;
+			case 2: snprintf(filters[i], sizeof(filters[i]), "site/%zu/+/%zu/status", i / 4, i); break;
+			default: snprintf(filters[i], sizeof(filters[i]), "site/%zu/dev/%zu/temp", i / 4, i / 4); break;
+		}
+		cxa_assert( cxa_mqtt_topicTrie_insert(&trie, filters[i], i) );
+
+		snprintf(topics[i], sizeof(topics[i]), "site/%zu/dev/%zu/temp", i / 4, i / 4);
+	}
+
+	size_t numMatchedEntries = 0;
+	uint64_t start_ns = cxa_timeBase_getCount64_ns();
+	for( size_t i = 0; i < numMatchesIn; i++ )
+	{
+		const char* currTopic = topics[i % numSubscriptionsIn];
+		numMatchedEntries += cxa_mqtt_topicTrie_match(&trie, currTopic, strlen(currTopic), trieCb_onMatch, NULL);
+	}
+	uint64_t elapsed_ns = cxa_timeBase_getCount64_ns() - start_ns;
+
+	resultsOut->numSubscriptions = numSubscriptionsIn;
+	resultsOut->numMatches = numMatchesIn;
+	resultsOut->numMatchedEntries = numMatchedEntries;
+	resultsOut->match_nsPerCall = elapsed_ns / numMatchesIn;
+
+	return true;
+}
+
+
+void cxa_posix_mqtt_topicTrie_benchmark_writeResults(const cxa_posix_mqtt_topicTrie_benchmark_results_t *const resultsIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(resultsIn);
+	cxa_assert(ioStreamIn);
+
+	// formatted writes are limited to CXA_IOSTREAM_FORMATTED_BUFFERLEN_BYTES
+	cxa_ioStream_writeFormattedString(ioStreamIn, "subs: %zu ", resultsIn->numSubscriptions);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "matches: %zu ", resultsIn->numMatches);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "hits: %zu ", resultsIn->numMatchedEntries);
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu ns/match", (unsigned long)resultsIn->match_nsPerCall);
+}
+
+
+// ******** local function implementations ********
+static void trieCb_onMatch(uint16_t entryIndexIn, void* userVarIn)
+{
+	(void)entryIndexIn;
+	(void)userVarIn;
+}
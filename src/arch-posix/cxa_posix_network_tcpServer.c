@@ -0,0 +1,268 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include <cxa_posix_network_tcpServer.h>
+
+
+// ******** includes ********
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define CONNECTION_BACKLOG			CXA_POSIX_NETWORK_TCPSERVER_MAXCONNECTEDCLIENTS
+
+
+// ******** local type definitions ********
+typedef enum
+{
+	STATE_IDLE,
+	STATE_LISTENING,
+	STATE_LISTENING_FAIL
+}state_t;
+
+
+// ******** local function prototypes ********
+static bool hasFreeConnectedClient(cxa_posix_network_tcpServer_t *const netServerIn);
+static bool reserveAndSetupFreeConnectedClient(cxa_posix_network_tcpServer_t *const netServerIn,
+											   int socketIn, struct sockaddr_in * clientAddressIn);
+static void closeAllSockets(cxa_posix_network_tcpServer_t *const netServerIn);
+
+static bool scm_listen(cxa_network_tcpServer_t *const superIn, uint16_t portNumIn);
+static void scm_stopListening(cxa_network_tcpServer_t *const superIn);
+
+static void stateCb_listen_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
+static void stateCb_listen_state(cxa_stateMachine_t *const smIn, void *userVarIn);
+static void stateCb_listen_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_network_tcpServer_init(cxa_posix_network_tcpServer_t *const netServerIn, bool isLoopbackOnlyIn, int threadIdIn)
+{
+	cxa_assert(netServerIn);
+
+	// save our references
+	netServerIn->isLoopbackOnly = isLoopbackOnlyIn;
+	netServerIn->listenSocket = -1;
+
+	// initialize our client connections
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		cxa_posix_network_tcpServer_connectedClient_initUnbound(&netServerIn->connectedClients[i]);
+	}
+
+	// setup our state machine
+	cxa_stateMachine_init(&netServerIn->stateMachine, "tcpServer", threadIdIn);
+	cxa_stateMachine_addState(&netServerIn->stateMachine, STATE_IDLE, "idle", NULL, NULL, NULL, (void*)netServerIn);
+	cxa_stateMachine_addState(&netServerIn->stateMachine, STATE_LISTENING, "listening", stateCb_listen_enter, stateCb_listen_state, stateCb_listen_leave, (void*)netServerIn);
+	cxa_stateMachine_addState(&netServerIn->stateMachine, STATE_LISTENING_FAIL, "listenFail", NULL, NULL, NULL, (void*)netServerIn);
+	cxa_stateMachine_setInitialState(&netServerIn->stateMachine, STATE_IDLE);
+
+	// initialize our super class
+	cxa_network_tcpServer_init(&netServerIn->super, scm_listen, scm_stopListening);
+}
+
+
+// ******** local function implementations ********
+static bool hasFreeConnectedClient(cxa_posix_network_tcpServer_t *const netServerIn)
+{
+	cxa_assert(netServerIn);
+
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		if( netServerIn->connectedClients[i].socket == -1 ) return true;
+	}
+
+	return false;
+}
+
+
+static bool reserveAndSetupFreeConnectedClient(cxa_posix_network_tcpServer_t *const netServerIn,
+											   int socketIn, struct sockaddr_in * clientAddressIn)
+{
+	cxa_assert(netServerIn);
+	cxa_assert(clientAddressIn);
+
+	// find a free client
+	cxa_posix_network_tcpServer_connectedClient_t* targetClient = NULL;
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		if( !cxa_network_tcpServer_connectedClient_isBound(&netServerIn->connectedClients[i].super) )
+		{
+			targetClient = &netServerIn->connectedClients[i];
+			break;
+		}
+	}
+	if( targetClient == NULL ) return false;
+	// if we made it here, we have a free client to configure
+
+	cxa_posix_network_tcpServer_connectedClient_bindToSocket(targetClient, socketIn, clientAddressIn);
+
+	// notify our listeners
+	cxa_network_tcpServer_notifyConnect(&netServerIn->super, &targetClient->super);
+
+	return true;
+}
+
+
+static void closeAllSockets(cxa_posix_network_tcpServer_t *const netServerIn)
+{
+	cxa_assert(netServerIn);
+
+	// first our clients
+	for( size_t i = 0; i < sizeof(netServerIn->connectedClients)/sizeof(*netServerIn->connectedClients); i++ )
+	{
+		if( netServerIn->connectedClients[i].socket != -1 )
+		{
+			cxa_network_tcpServer_connectedClient_unbindAndClose(&netServerIn->connectedClients[i].super);
+		}
+	}
+
+	// now our server
+	if( netServerIn->listenSocket >= 0 ) close(netServerIn->listenSocket);
+	netServerIn->listenSocket = -1;
+}
+
+
+static bool scm_listen(cxa_network_tcpServer_t *const superIn, uint16_t portNumIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)superIn;
+	cxa_assert(netServerIn);
+
+	// make sure we're able to listen
+	if( cxa_stateMachine_getCurrentState(&netServerIn->stateMachine) != STATE_IDLE )
+	{
+		cxa_logger_warn(&netServerIn->super.logger, "bad state for listening");
+		return false;
+	}
+	// if we made it here, we can listen...
+
+	// save our references
+	netServerIn->portNumber = portNumIn;
+
+	// transition
+	cxa_stateMachine_transition(&netServerIn->stateMachine, STATE_LISTENING);
+	return true;
+}
+
+
+static void scm_stopListening(cxa_network_tcpServer_t *const superIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)superIn;
+	cxa_assert(netServerIn);
+
+	if( cxa_stateMachine_getCurrentState(&netServerIn->stateMachine) == STATE_IDLE ) return;
+
+	cxa_logger_info(&netServerIn->super.logger, "stopping listening");
+	cxa_stateMachine_transition(&netServerIn->stateMachine, STATE_IDLE);
+}
+
+
+static void stateCb_listen_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)userVarIn;
+	cxa_assert(netServerIn);
+
+	struct sockaddr_in serverAddress;
+
+	// create a socket that we will listen upon
+	cxa_logger_debug(&netServerIn->super.logger, "creating socket");
+	netServerIn->listenSocket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	if( netServerIn->listenSocket < 0 )
+	{
+		cxa_logger_error(&netServerIn->super.logger, "error listening socket: %d %s", netServerIn->listenSocket, strerror(errno));
+		cxa_stateMachine_transition(&netServerIn->stateMachine, STATE_LISTENING_FAIL);
+		return;
+	}
+
+	// allow quick restarts (don't wait for TIME_WAIT sockets to expire)
+	int arg_reuseAddr = 1;
+	setsockopt(netServerIn->listenSocket, SOL_SOCKET, SO_REUSEADDR, &arg_reuseAddr, sizeof(arg_reuseAddr));
+
+	// set non-blocking mode on our socket
+	cxa_logger_debug(&netServerIn->super.logger, "setting socket non-blocking");
+	fcntl(netServerIn->listenSocket, F_SETFL, fcntl(netServerIn->listenSocket, F_GETFL, 0) | O_NONBLOCK);
+
+	// bind our server socket to a port
+	cxa_logger_debug(&netServerIn->super.logger, "bind socket to %s address", netServerIn->isLoopbackOnly ? "loopback" : "any");
+	memset(&serverAddress, 0, sizeof(serverAddress));
+	serverAddress.sin_family = AF_INET;
+	serverAddress.sin_addr.s_addr = htonl(netServerIn->isLoopbackOnly ? INADDR_LOOPBACK : INADDR_ANY);
+	serverAddress.sin_port = htons(netServerIn->portNumber);
+	int rc = bind(netServerIn->listenSocket, (struct sockaddr *)&serverAddress, sizeof(serverAddress));
+	if( rc < 0 )
+	{
+		cxa_logger_error(&netServerIn->super.logger, "error listening bind: %d %s", rc, strerror(errno));
+		cxa_stateMachine_transition(&netServerIn->stateMachine, STATE_LISTENING_FAIL);
+		return;
+	}
+
+	// flag the socket as listening for new connections
+	cxa_logger_debug(&netServerIn->super.logger, "flagging socket as listening");
+	rc = listen(netServerIn->listenSocket, CONNECTION_BACKLOG);
+	if( rc < 0 )
+	{
+		cxa_logger_error(&netServerIn->super.logger, "error listening listen: %d %s", rc, strerror(errno));
+		cxa_stateMachine_transition(&netServerIn->stateMachine, STATE_LISTENING_FAIL);
+		return;
+	}
+
+	cxa_logger_info(&netServerIn->super.logger, "listening on port %d", netServerIn->portNumber);
+}
+
+
+static void stateCb_listen_state(cxa_stateMachine_t *const smIn, void *userVarIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)userVarIn;
+	cxa_assert(netServerIn);
+
+	// before we accept, see if we have a connectedClient for a potential connection
+	if( !hasFreeConnectedClient(netServerIn) ) return;
+
+	struct sockaddr_in clientAddress;
+	socklen_t clientAddressLength = sizeof(clientAddress);
+	int clientSock = accept(netServerIn->listenSocket, (struct sockaddr *)&clientAddress, &clientAddressLength);
+	if( clientSock >= 0 )
+	{
+		// got a client connection
+		char str[INET_ADDRSTRLEN];
+		inet_ntop(AF_INET, &clientAddress.sin_addr, str, INET_ADDRSTRLEN);
+		cxa_logger_info(&netServerIn->super.logger, "got connection from %s, configuring client", str);
+
+		reserveAndSetupFreeConnectedClient(netServerIn, clientSock, &clientAddress);
+	}
+	else if( (errno == EWOULDBLOCK) || (errno == EAGAIN) || (errno == EINTR) || (errno == ECONNABORTED) )
+	{
+		// no connection, but keep trying (non-blocking)
+	}
+	else
+	{
+		// error listening
+		cxa_logger_error(&netServerIn->super.logger, "error listening accept: %d %d %s", netServerIn->listenSocket, errno, strerror(errno));
+		cxa_stateMachine_transition(&netServerIn->stateMachine, STATE_LISTENING_FAIL);
+		return;
+	}
+}
+
+
+static void stateCb_listen_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void* userVarIn)
+{
+	cxa_posix_network_tcpServer_t *netServerIn = (cxa_posix_network_tcpServer_t*)userVarIn;
+	cxa_assert(netServerIn);
+
+	closeAllSockets(netServerIn);
+}
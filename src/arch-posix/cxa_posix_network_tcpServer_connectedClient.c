@@ -0,0 +1,277 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include <cxa_posix_network_tcpServer_connectedClient.h>
+
+
+// ******** includes ********
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/tcp.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+#include <cxa_stringUtils.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define WRITE_TIMEOUT_MS				2000
+#define MAXNUM_IOVS						8
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static bool scm_isBound(cxa_network_tcpServer_connectedClient_t *const superIn);
+static void scm_unbindAndClose(cxa_network_tcpServer_connectedClient_t *const superIn);
+static char* scm_getDescriptiveString(cxa_network_tcpServer_connectedClient_t *const superIn);
+
+static bool handleSendResult(cxa_posix_network_tcpServer_connectedClient_t *const ccIn, ssize_t retIn);
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn);
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool cb_ioStream_writeBytesVectored(cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn, void *const userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_network_tcpServer_connectedClient_initUnbound(cxa_posix_network_tcpServer_connectedClient_t *const ccIn)
+{
+	cxa_assert(ccIn);
+
+	cxa_network_tcpServer_connectedClient_initUnbound(&ccIn->super, scm_isBound, scm_unbindAndClose, scm_getDescriptiveString);
+
+	ccIn->socket = -1;
+	ccIn->descriptiveString[0] = 0;
+	cxa_timeDiff_init(&ccIn->td_writeTimeout);
+}
+
+
+void cxa_posix_network_tcpServer_connectedClient_bindToSocket(cxa_posix_network_tcpServer_connectedClient_t *const ccIn,
+															  int socketIn,
+															  struct sockaddr_in * clientAddressIn)
+{
+	cxa_assert(ccIn);
+	cxa_assert(clientAddressIn);
+
+	if( cxa_network_tcpServer_connectedClient_isBound(&ccIn->super) ) return;
+
+	// accepted sockets don't inherit non-blocking mode from the listening socket
+	fcntl(socketIn, F_SETFL, fcntl(socketIn, F_GETFL, 0) | O_NONBLOCK);
+
+	// we send complete packets, so don't hold them back waiting for more data
+	int arg_noDelay = 1;
+	setsockopt(socketIn, IPPROTO_TCP, TCP_NODELAY, &arg_noDelay, sizeof(arg_noDelay));
+
+	ccIn->socket = socketIn;
+	cxa_ioStream_bind(&ccIn->super.ioStream, cb_ioStream_readByte, cb_ioStream_writeBytes, (void*)ccIn);
+	cxa_ioStream_bindVectoredWrite(&ccIn->super.ioStream, cb_ioStream_writeBytesVectored);
+
+	ccIn->descriptiveString[0] = 0;
+	inet_ntop(AF_INET, &clientAddressIn->sin_addr, ccIn->descriptiveString, sizeof(ccIn->descriptiveString));
+	cxa_stringUtils_concat_formattedString(ccIn->descriptiveString, sizeof(ccIn->descriptiveString), "::%d", ntohs(clientAddressIn->sin_port));
+
+	cxa_logger_debug(&ccIn->super.logger, "bound to socket %d", socketIn);
+}
+
+
+// ******** local function implementations ********
+static bool scm_isBound(cxa_network_tcpServer_connectedClient_t *const superIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)superIn;
+	cxa_assert(ccIn);
+
+	return (ccIn->socket >= 0);
+}
+
+
+static void scm_unbindAndClose(cxa_network_tcpServer_connectedClient_t *const superIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)superIn;
+	cxa_assert(ccIn);
+
+	cxa_logger_debug(&ccIn->super.logger, "unbinding and closing");
+
+	cxa_ioStream_unbind(&ccIn->super.ioStream);
+	if( ccIn->socket >= 0 ) close(ccIn->socket);
+	ccIn->socket = -1;
+
+	// notify our listeners
+	cxa_network_tcpServer_connectedClient_notifyDisconnected(&ccIn->super);
+}
+
+
+static char* scm_getDescriptiveString(cxa_network_tcpServer_connectedClient_t *const superIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)superIn;
+	cxa_assert(ccIn);
+
+	return ccIn->descriptiveString;
+}
+
+
+static bool handleSendResult(cxa_posix_network_tcpServer_connectedClient_t *const ccIn, ssize_t retIn)
+{
+	cxa_assert(ccIn);
+
+	if( retIn > 0 )
+	{
+		// we made progress...reset our timeout
+		cxa_timeDiff_setStartTime_now(&ccIn->td_writeTimeout);
+	}
+	else if( (retIn < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR)) )
+	{
+		// still asking for a write...make sure we don't take too long
+		if( cxa_timeDiff_isElapsed_ms(&ccIn->td_writeTimeout, WRITE_TIMEOUT_MS) )
+		{
+			cxa_logger_warn(&ccIn->super.logger, "timeout during write");
+			scm_unbindAndClose(&ccIn->super);
+			return false;
+		}
+	}
+	else if( retIn < 0 )
+	{
+		cxa_logger_warn(&ccIn->super.logger, "error during write: %d %s", errno, strerror(errno));
+		scm_unbindAndClose(&ccIn->super);
+		return false;
+	}
+
+	return true;
+}
+
+
+static cxa_ioStream_readStatus_t cb_ioStream_readByte(uint8_t *const byteOut, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+
+	uint8_t rxByte;
+	ssize_t rc = recv(ccIn->socket, (void*)&rxByte, 1, 0);
+	if( rc == 0 )
+	{
+		// per man page: For TCP sockets, the return value 0 means the peer has closed its half side of the connection.
+		cxa_logger_debug(&ccIn->super.logger, "connection closed");
+		scm_unbindAndClose(&ccIn->super);
+		return CXA_IOSTREAM_READSTAT_ERROR;
+	}
+	if( (rc < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR) )
+	{
+		cxa_logger_warn(&ccIn->super.logger, "unexpected read error: %d %s", errno, strerror(errno));
+		scm_unbindAndClose(&ccIn->super);
+		return CXA_IOSTREAM_READSTAT_ERROR;
+	}
+	// if we made it here one of two things are true: rc==-1 -> no data...rc>0 -> data
+
+	if( (rc > 0) && (byteOut != NULL) ) *byteOut = rxByte;
+
+	return (rc > 0) ? CXA_IOSTREAM_READSTAT_GOTDATA : CXA_IOSTREAM_READSTAT_NODATA;
+}
+
+
+static bool cb_ioStream_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+
+	// handle a zero-size buffer appropriately
+	if( bufferSize_bytesIn != 0 ) { cxa_assert(buffIn); }
+	else { return true; }
+
+	// make sure we are connected
+	if( !scm_isBound(&ccIn->super) ) return false;
+
+	// reset our timeout
+	cxa_timeDiff_setStartTime_now(&ccIn->td_writeTimeout);
+
+	uint8_t* buf = buffIn;
+	do
+	{
+		// MSG_NOSIGNAL: a closed peer should be an error, not a SIGPIPE
+		ssize_t tmpRet = send(ccIn->socket, (void*)buf, bufferSize_bytesIn, MSG_NOSIGNAL);
+		if( !handleSendResult(ccIn, tmpRet) ) return false;
+
+		if( tmpRet > 0 )
+		{
+			buf += tmpRet;
+			bufferSize_bytesIn -= tmpRet;
+		}
+	} while( bufferSize_bytesIn > 0 );
+
+	return true;
+}
+
+
+static bool cb_ioStream_writeBytesVectored(cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn, void *const userVarIn)
+{
+	cxa_posix_network_tcpServer_connectedClient_t* ccIn = (cxa_posix_network_tcpServer_connectedClient_t*)userVarIn;
+	cxa_assert(ccIn);
+	cxa_assert(iovIn);
+
+	// make sure we are connected
+	if( !scm_isBound(&ccIn->super) ) return false;
+
+	// more buffers than we expect...just write them one at a time
+	if( numIovIn > MAXNUM_IOVS )
+	{
+		for( size_t i = 0; i < numIovIn; i++ )
+		{
+			if( !cb_ioStream_writeBytes(iovIn[i].buff, iovIn[i].size_bytes, userVarIn) ) return false;
+		}
+		return true;
+	}
+
+	struct iovec iovs[MAXNUM_IOVS];
+	size_t remainingSize_bytes = 0;
+	for( size_t i = 0; i < numIovIn; i++ )
+	{
+		iovs[i].iov_base = iovIn[i].buff;
+		iovs[i].iov_len = iovIn[i].size_bytes;
+		remainingSize_bytes += iovIn[i].size_bytes;
+	}
+
+	// reset our timeout
+	cxa_timeDiff_setStartTime_now(&ccIn->td_writeTimeout);
+
+	struct iovec* currIov = iovs;
+	size_t numIovsRemaining = numIovIn;
+	while( remainingSize_bytes > 0 )
+	{
+		struct msghdr msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = currIov;
+		msg.msg_iovlen = numIovsRemaining;
+
+		ssize_t tmpRet = sendmsg(ccIn->socket, &msg, MSG_NOSIGNAL);
+		if( !handleSendResult(ccIn, tmpRet) ) return false;
+		if( tmpRet <= 0 ) continue;
+
+		// skip past whatever was sent (possibly partway through a buffer)
+		remainingSize_bytes -= tmpRet;
+		size_t sent_bytes = (size_t)tmpRet;
+		while( (numIovsRemaining > 0) && (sent_bytes >= currIov->iov_len) )
+		{
+			sent_bytes -= currIov->iov_len;
+			currIov++;
+			numIovsRemaining--;
+		}
+		if( numIovsRemaining > 0 )
+		{
+			currIov->iov_base = (uint8_t*)currIov->iov_base + sent_bytes;
+			currIov->iov_len -= sent_bytes;
+		}
+	}
+
+	return true;
+}
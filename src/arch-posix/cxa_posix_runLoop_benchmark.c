@@ -0,0 +1,221 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_posix_runLoop_benchmark.h"
+
+
+// ******** includes ********
+#include <pthread.h>
+#include <sched.h>
+
+#include <cxa_assert.h>
+#include <cxa_timeBase.h>
+
+#define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define NS_PER_MS							1000000ull
+
+
+// ******** local type definitions ********
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+typedef struct
+{
+	cxa_posix_runLoop_benchmark_t* bench;
+	size_t numPosts;
+	size_t numQueueFull;
+	pthread_t thread;
+}producer_t;
+#endif
+
+
+// ******** local function prototypes ********
+static void runLoopCb_idle(void* userVarIn);
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+static void* producerThread(void* userVarIn);
+static void runLoopCb_posted(void* userVarIn);
+#endif
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_posix_runLoop_benchmark_init(cxa_posix_runLoop_benchmark_t *const benchIn, int threadIdIn)
+{
+	cxa_assert(benchIn);
+
+	// save our references
+	benchIn->threadId = threadIdIn;
+	benchIn->numTimedEntries = 0;
+	benchIn->numPostsExecuted = 0;
+
+	cxa_logger_init(&benchIn->logger, "runLoopBench");
+}
+
+
+bool cxa_posix_runLoop_benchmark_measureIterate(cxa_posix_runLoop_benchmark_t *const benchIn, size_t numTimedEntriesIn, size_t numIterationsIn,
+												cxa_posix_runLoop_benchmark_iterateResults_t *const resultsOut)
+{
+	cxa_assert(benchIn);
+	cxa_assert(resultsOut);
+
+	if( numTimedEntriesIn < benchIn->numTimedEntries )
+	{
+		cxa_logger_warn(&benchIn->logger, "already have %zu timed entries", benchIn->numTimedEntries);
+		return false;
+	}
+	if( numIterationsIn == 0 ) return false;
+
+	while( benchIn->numTimedEntries < numTimedEntriesIn )
+	{
+		cxa_runLoop_addTimedEntry(benchIn->threadId, CXA_POSIX_RUNLOOP_BENCHMARK_IDLE_PERIOD_MS, NULL, runLoopCb_idle, (void*)benchIn);
+		benchIn->numTimedEntries++;
+	}
+
+	// let our new entries start (and get scheduled)
+	cxa_runLoop_iterate(benchIn->threadId);
+
+	uint64_t start_ns = cxa_timeBase_getCount64_ns();
+	for( size_t i = 0; i < numIterationsIn; i++ )
+	{
+		cxa_runLoop_iterate(benchIn->threadId);
+	}
+	uint64_t elapsed_ns = cxa_timeBase_getCount64_ns() - start_ns;
+
+	resultsOut->numTimedEntries = benchIn->numTimedEntries;
+	resultsOut->numIterations = numIterationsIn;
+	resultsOut->elapsed_ms = elapsed_ns / NS_PER_MS;
+	resultsOut->iterate_nsPerCall = elapsed_ns / numIterationsIn;
+
+	return true;
+}
+
+
+void cxa_posix_runLoop_benchmark_writeIterateResults(const cxa_posix_runLoop_benchmark_iterateResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(resultsIn);
+	cxa_assert(ioStreamIn);
+
+	// formatted writes are limited to CXA_IOSTREAM_FORMATTED_BUFFERLEN_BYTES
+	cxa_ioStream_writeFormattedString(ioStreamIn, "timed: %zu ", resultsIn->numTimedEntries);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "iters: %zu ", resultsIn->numIterations);
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu ns/iter", (unsigned long)resultsIn->iterate_nsPerCall);
+}
+
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+bool cxa_posix_runLoop_benchmark_measurePost(cxa_posix_runLoop_benchmark_t *const benchIn, size_t numProducersIn, size_t numPostsPerProducerIn,
+											 cxa_posix_runLoop_benchmark_postResults_t *const resultsOut)
+{
+	cxa_assert(benchIn);
+	cxa_assert(resultsOut);
+
+	if( (numProducersIn == 0) || (numProducersIn > CXA_POSIX_RUNLOOP_BENCHMARK_MAXNUM_PRODUCERS) )
+	{
+		cxa_logger_warn(&benchIn->logger, "numProducers must be 1-%d", CXA_POSIX_RUNLOOP_BENCHMARK_MAXNUM_PRODUCERS);
+		return false;
+	}
+
+	// posts are only accepted once the runLoop knows our thread
+	cxa_runLoop_iterate(benchIn->threadId);
+	benchIn->numPostsExecuted = 0;
+
+	producer_t producers[CXA_POSIX_RUNLOOP_BENCHMARK_MAXNUM_PRODUCERS];
+	bool didStartFail = false;
+	uint64_t start_ns = cxa_timeBase_getCount64_ns();
+	for( size_t i = 0; i < numProducersIn; i++ )
+	{
+		producers[i].bench = benchIn;
+		producers[i].numPosts = numPostsPerProducerIn;
+		producers[i].numQueueFull = 0;
+		if( pthread_create(&producers[i].thread, NULL, producerThread, (void*)&producers[i]) != 0 )
+		{
+			// can't stop the threads we already started, let them finish
+			cxa_logger_warn(&benchIn->logger, "failed to start producer thread");
+			numProducersIn = i;
+			didStartFail = true;
+			break;
+		}
+	}
+
+	size_t numExpected = numProducersIn * numPostsPerProducerIn;
+	while( benchIn->numPostsExecuted < numExpected )
+	{
+		// nothing posted yet...let the producers run (like an idle runLoop would)
+		size_t prevNumExecuted = benchIn->numPostsExecuted;
+		cxa_runLoop_iterate(benchIn->threadId);
+		if( benchIn->numPostsExecuted == prevNumExecuted ) sched_yield();
+	}
+	uint64_t elapsed_ns = cxa_timeBase_getCount64_ns() - start_ns;
+
+	resultsOut->numProducers = numProducersIn;
+	resultsOut->numPostsPerProducer = numPostsPerProducerIn;
+	resultsOut->numExecuted = benchIn->numPostsExecuted;
+	resultsOut->numQueueFull = 0;
+	for( size_t i = 0; i < numProducersIn; i++ )
+	{
+		pthread_join(producers[i].thread, NULL);
+		resultsOut->numQueueFull += producers[i].numQueueFull;
+	}
+	resultsOut->elapsed_ms = elapsed_ns / NS_PER_MS;
+	resultsOut->throughput_postsPerSec = (elapsed_ns != 0) ? ((resultsOut->numExecuted * 1000000000ull) / elapsed_ns) : 0;
+
+	return !didStartFail;
+}
+
+
+void cxa_posix_runLoop_benchmark_writePostResults(const cxa_posix_runLoop_benchmark_postResults_t *const resultsIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(resultsIn);
+	cxa_assert(ioStreamIn);
+
+	cxa_ioStream_writeFormattedString(ioStreamIn, "producers: %zu ", resultsIn->numProducers);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "posts: %zu ", resultsIn->numExecuted);
+	cxa_ioStream_writeFormattedString(ioStreamIn, "full: %zu ", resultsIn->numQueueFull);
+	cxa_ioStream_writeFormattedLine(ioStreamIn, "%lu posts/s", (unsigned long)resultsIn->throughput_postsPerSec);
+}
+#endif
+
+
+// ******** local function implementations ********
+static void runLoopCb_idle(void* userVarIn)
+{
+	(void)userVarIn;
+}
+
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+static void* producerThread(void* userVarIn)
+{
+	producer_t* producer = (producer_t*)userVarIn;
+	cxa_assert(producer);
+
+	for( size_t i = 0; i < producer->numPosts; i++ )
+	{
+		// a full queue is expected (we're faster than the consumer)...let it catch up
+		while( !cxa_runLoop_post(producer->bench->threadId, runLoopCb_posted, (void*)producer->bench) )
+		{
+			producer->numQueueFull++;
+			sched_yield();
+		}
+	}
+
+	return NULL;
+}
+
+
+static void runLoopCb_posted(void* userVarIn)
+{
+	cxa_posix_runLoop_benchmark_t* benchIn = (cxa_posix_runLoop_benchmark_t*)userVarIn;
+	cxa_assert(benchIn);
+
+	benchIn->numPostsExecuted++;
+}
+#endif
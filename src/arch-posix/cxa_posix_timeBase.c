@@ -10,7 +10,6 @@
 // ******** includes ********
 #include <cxa_assert.h>
 #include <time.h>
-#include <sys/time.h>
 
 #ifdef __MACH__
 #include <mach/clock.h>
@@ -25,20 +24,17 @@
 
 
 // ******** local function prototypes ********
-static void current_utc_time(struct timeval *ts);
+static void current_monotonic_time(struct timespec *ts);
 
 
 // ********  local variable declarations *********
 
 
 // ******** global function implementations ********
-
-
 uint32_t cxa_timeBase_getCount_us(void)
 {
-	struct timeval ts;
-	current_utc_time(&ts);
-	return (1000000 * ts.tv_sec) + (ts.tv_usec);
+	// truncation keeps us consistent with our 64-bit count (rolls over at UINT32_MAX)
+	return (uint32_t)cxa_timeBase_getCount64_us();
 }
 
 
@@ -48,18 +44,35 @@ uint32_t cxa_timeBase_getMaxCount_us(void)
 }
 
 
+uint64_t cxa_timeBase_getCount64_us(void)
+{
+	struct timespec ts;
+	current_monotonic_time(&ts);
+	return (((uint64_t)ts.tv_sec) * 1000000) + (ts.tv_nsec / 1000);
+}
+
+
+uint64_t cxa_timeBase_getCount64_ns(void)
+{
+	struct timespec ts;
+	current_monotonic_time(&ts);
+	return (((uint64_t)ts.tv_sec) * 1000000000) + ts.tv_nsec;
+}
+
+
 // ******** local function implementations ********
-static void current_utc_time(struct timeval *ts)
+static void current_monotonic_time(struct timespec *ts)
 {
-	#ifdef __MACH__ // OS X does not have clock_gettime, use clock_get_time
+	#ifdef __MACH__ // older OS X does not have clock_gettime, use clock_get_time
 		clock_serv_t cclock;
 		mach_timespec_t mts;
-		host_get_clock_service(mach_host_self(), CALENDAR_CLOCK, &cclock);
+		host_get_clock_service(mach_host_self(), SYSTEM_CLOCK, &cclock);
 		clock_get_time(cclock, &mts);
 		mach_port_deallocate(mach_task_self(), cclock);
 		ts->tv_sec = mts.tv_sec;
-		ts->tv_usec = mts.tv_nsec / 1000;
+		ts->tv_nsec = mts.tv_nsec;
 	#else
-		gettimeofday(ts, NULL);
+		// unlike gettimeofday, not affected by changes to the wall clock (eg. NTP)
+		clock_gettime(CLOCK_MONOTONIC, ts);
 	#endif
 }
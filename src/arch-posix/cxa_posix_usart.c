@@ -15,9 +15,11 @@
 #include <unistd.h>
 #include <fcntl.h>
 #include <string.h>
+#include <sys/uio.h>
 
 
 // ******** local macro definitions ********
+#define MAXNUM_IOVS						8
 
 
 // ******** local type definitions ********
@@ -29,6 +31,7 @@ static bool set_blocking (int fd, int should_block);
 
 static cxa_ioStream_readStatus_t ioStream_cb_readByte(uint8_t *const byteOut, void *const userVarIn);
 static bool ioStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void *const userVarIn);
+static bool ioStream_cb_writeBytesVectored(cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn, void *const userVarIn);
 
 
 // ********  local variable declarations *********
@@ -49,6 +52,7 @@ bool cxa_posix_usart_init_noHH(cxa_posix_usart_t *const usartIn, char *const pat
 	// setup our ioStream (last once everything is setup)
 	cxa_ioStream_init(&usartIn->super.ioStream);
 	cxa_ioStream_bind(&usartIn->super.ioStream, ioStream_cb_readByte, ioStream_cb_writeBytes, (void*)usartIn);
+	cxa_ioStream_bindVectoredWrite(&usartIn->super.ioStream, ioStream_cb_writeBytesVectored);
 
 	return true;
 }
@@ -156,3 +160,55 @@ static bool ioStream_cb_writeBytes(void* buffIn, size_t bufferSize_bytesIn, void
 
 	return true;
 }
+
+
+static bool ioStream_cb_writeBytesVectored(cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn, void *const userVarIn)
+{
+	cxa_posix_usart_t* usartIn = (cxa_posix_usart_t*)userVarIn;
+	cxa_assert(usartIn);
+	cxa_assert(iovIn);
+
+	// more buffers than we expect...just write them one at a time
+	if( numIovIn > MAXNUM_IOVS )
+	{
+		for( size_t i = 0; i < numIovIn; i++ )
+		{
+			if( !ioStream_cb_writeBytes(iovIn[i].buff, iovIn[i].size_bytes, userVarIn) ) return false;
+		}
+		return true;
+	}
+
+	struct iovec iovs[MAXNUM_IOVS];
+	size_t numBytesRemaining = 0;
+	for( size_t i = 0; i < numIovIn; i++ )
+	{
+		iovs[i].iov_base = iovIn[i].buff;
+		iovs[i].iov_len = iovIn[i].size_bytes;
+		numBytesRemaining += iovIn[i].size_bytes;
+	}
+
+	struct iovec* currIov = iovs;
+	size_t numIovsRemaining = numIovIn;
+	while( numBytesRemaining != 0 )
+	{
+		ssize_t retVal_write = writev(usartIn->fd, currIov, (int)numIovsRemaining);
+		if( retVal_write < 0 ) return false;
+
+		// skip past whatever was written (possibly partway through a buffer)
+		numBytesRemaining -= (size_t)retVal_write;
+		size_t numBytesSent = (size_t)retVal_write;
+		while( (numIovsRemaining > 0) && (numBytesSent >= currIov->iov_len) )
+		{
+			numBytesSent -= currIov->iov_len;
+			currIov++;
+			numIovsRemaining--;
+		}
+		if( numIovsRemaining > 0 )
+		{
+			currIov->iov_base = (uint8_t*)currIov->iov_base + numBytesSent;
+			currIov->iov_len -= numBytesSent;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,131 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_wakeableSleep.h"
+
+
+// ******** includes ********
+#include <stdbool.h>
+#include <stddef.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+#ifndef CXA_POSIX_MAXNUM_WAKEABLESLEEPS
+	#define CXA_POSIX_MAXNUM_WAKEABLESLEEPS		4
+#endif
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_wakeableSleep_t super;
+
+	bool isUsed;
+
+	// self-pipe: wake writes a byte, sleep polls the read end
+	int fd_read;
+	int fd_write;
+
+	// the pipe is only written when the owner is (about to be) blocked in poll
+	atomic_bool isSleeping;
+	atomic_bool isWakePending;
+}cxa_posix_wakeableSleep_t;
+
+
+// ******** local function prototypes ********
+
+
+// ********  local variable declarations *********
+static cxa_posix_wakeableSleep_t wakeableSleeps[CXA_POSIX_MAXNUM_WAKEABLESLEEPS];
+
+// not cxa_criticalSection, we may be reserved from within one (eg. runLoop)
+static pthread_mutex_t reserveMutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+// ******** global function implementations ********
+cxa_wakeableSleep_t* cxa_wakeableSleep_reserve(void)
+{
+	cxa_posix_wakeableSleep_t* retVal = NULL;
+
+	pthread_mutex_lock(&reserveMutex);
+	for( size_t i = 0; i < sizeof(wakeableSleeps)/sizeof(*wakeableSleeps); i++ )
+	{
+		if( !wakeableSleeps[i].isUsed )
+		{
+			wakeableSleeps[i].isUsed = true;
+			retVal = &wakeableSleeps[i];
+			break;
+		}
+	}
+	pthread_mutex_unlock(&reserveMutex);
+	if( retVal == NULL ) return NULL;
+
+	int fds[2];
+	cxa_assert(pipe(fds) == 0);
+	fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+	fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+	retVal->fd_read = fds[0];
+	retVal->fd_write = fds[1];
+	atomic_init(&retVal->isSleeping, false);
+	atomic_init(&retVal->isWakePending, false);
+
+	return &retVal->super;
+}
+
+
+void cxa_wakeableSleep_sleep_us(cxa_wakeableSleep_t *const wsIn, uint32_t maxSleep_usIn)
+{
+	cxa_posix_wakeableSleep_t* wsPosix = (cxa_posix_wakeableSleep_t*)wsIn;
+	cxa_assert(wsPosix);
+
+	// announce we're sleeping _before_ checking for a pending wake (pairs with wake)
+	int numReady = 0;
+	atomic_store(&wsPosix->isSleeping, true);
+	if( !atomic_exchange(&wsPosix->isWakePending, false) )
+	{
+		// round up so we never wake _before_ the requested deadline
+		struct pollfd pfd = { .fd = wsPosix->fd_read, .events = POLLIN };
+		int timeout_ms = (int)((maxSleep_usIn / 1000) + ((maxSleep_usIn % 1000) ? 1 : 0));
+		numReady = poll(&pfd, 1, timeout_ms);
+	}
+	atomic_store(&wsPosix->isSleeping, false);
+
+	// we're returning anyways, so any wakeup up to this point has been delivered
+	atomic_store(&wsPosix->isWakePending, false);
+	if( numReady <= 0 ) return;
+
+	// we were woken...drain any pending wakeups
+	uint8_t buffer[16];
+	while( read(wsPosix->fd_read, buffer, sizeof(buffer)) > 0 );
+}
+
+
+void cxa_wakeableSleep_wake(cxa_wakeableSleep_t *const wsIn)
+{
+	cxa_posix_wakeableSleep_t* wsPosix = (cxa_posix_wakeableSleep_t*)wsIn;
+	cxa_assert(wsPosix);
+
+	// already pending: the owner either has a byte to read or will see the flag
+	if( atomic_exchange(&wsPosix->isWakePending, true) ) return;
+
+	// not sleeping: the flag makes the next sleep return immediately, no syscall needed
+	if( !atomic_load(&wsPosix->isSleeping) ) return;
+
+	// a full pipe (EAGAIN) means a wakeup is already pending
+	uint8_t dummy = 0;
+	while( (write(wsPosix->fd_write, &dummy, sizeof(dummy)) < 0) && (errno == EINTR) );
+}
+
+
+// ******** local function implementations ********
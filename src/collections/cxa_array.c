@@ -91,25 +91,28 @@ void* cxa_array_append_empty(cxa_array_t *const arrIn)
 
 
 bool cxa_array_remove_atIndex(cxa_array_t *const arrIn, const size_t indexIn)
+{
+	return cxa_array_removeRange(arrIn, indexIn, 1);
+}
+
+
+bool cxa_array_removeRange(cxa_array_t *const arrIn, const size_t indexIn, const size_t numElemsIn)
 {
 	cxa_assert(arrIn);
 
 	// make sure we're not out of bounds
-	if( indexIn >= arrIn->insertIndex ) return false;
+	if( (indexIn > arrIn->insertIndex) || (numElemsIn > (arrIn->insertIndex - indexIn)) ) return false;
 
-	// if this is the last element in the array, we don't need to do any memmoves
-	if( (indexIn+1) >= arrIn->insertIndex )
+	// if we're removing from the end of the array, we don't need to do any memmoves
+	size_t numTrailing_elems = arrIn->insertIndex - (indexIn + numElemsIn);
+	if( numTrailing_elems > 0 )
 	{
-		arrIn->insertIndex--;
-		return true;
-	}
-
-	// if we made it here, we have some data to move around
-	void *dest = (void*)(((uint8_t*)arrIn->bufferLoc) + (indexIn * arrIn->datatypeSize_bytes));
-	void *src = (void*)(((uint8_t*)arrIn->bufferLoc) + (indexIn+1 * arrIn->datatypeSize_bytes));
+		void *dest = (void*)(((uint8_t*)arrIn->bufferLoc) + (indexIn * arrIn->datatypeSize_bytes));
+		void *src = (void*)(((uint8_t*)arrIn->bufferLoc) + ((indexIn + numElemsIn) * arrIn->datatypeSize_bytes));
 
-	memmove(dest, src, ((arrIn->insertIndex-(indexIn+1)) * arrIn->datatypeSize_bytes));
-	arrIn->insertIndex--;
+		memmove(dest, src, (numTrailing_elems * arrIn->datatypeSize_bytes));
+	}
+	arrIn->insertIndex -= numElemsIn;
 
 	return true;
 }
@@ -171,29 +174,50 @@ bool cxa_array_overwrite(cxa_array_t *const arrIn, const size_t indexIn, void *c
 
 
 bool cxa_array_insert(cxa_array_t *const arrIn, const size_t indexIn, void *const itemLocIn)
+{
+	return cxa_array_insertRange(arrIn, indexIn, itemLocIn, 1);
+}
+
+
+bool cxa_array_insertRange(cxa_array_t *const arrIn, const size_t indexIn, void *const itemsLocIn, const size_t numElemsIn)
+{
+	cxa_assert(arrIn);
+	cxa_assert(itemsLocIn);
+
+	void* dest = cxa_array_insertRange_empty(arrIn, indexIn, numElemsIn);
+	if( dest == NULL ) return false;
+
+	// copy in our new items
+	memcpy(dest, itemsLocIn, numElemsIn * arrIn->datatypeSize_bytes);
+
+	return true;
+}
+
+
+void* cxa_array_insertRange_empty(cxa_array_t *const arrIn, const size_t indexIn, const size_t numElemsIn)
 {
 	cxa_assert(arrIn);
-	cxa_assert(itemLocIn);
 
 	// make sure we have enough space in the array
 	size_t currSize = cxa_array_getSize_elems(arrIn);
-	if( currSize == arrIn->maxNumElements ) return false;
+	if( numElemsIn > (arrIn->maxNumElements - currSize) ) return NULL;
 
 	// make sure the index is within our current data (or just outside for appends)
-	if( indexIn > cxa_array_getSize_elems(arrIn) ) return false;
+	if( indexIn > currSize ) return NULL;
 
-	// increment our insert index (since we're adding an element);
-	arrIn->insertIndex++;
+	// move our other items (if any)
+	void* retVal = (void*)(((uint8_t*)arrIn->bufferLoc) + (indexIn * arrIn->datatypeSize_bytes));
+	if( (currSize > indexIn) && (numElemsIn > 0) )
+	{
+		memmove( (void*)(((uint8_t*)arrIn->bufferLoc) + ((indexIn + numElemsIn) * arrIn->datatypeSize_bytes)),
+				 retVal,
+				 (currSize-indexIn) * arrIn->datatypeSize_bytes );
+	}
 
-	// move our other items
-	memmove( (void*)(((uint8_t*)arrIn->bufferLoc) + ((indexIn+1) * arrIn->datatypeSize_bytes)),
-			 (void*)(((uint8_t*)arrIn->bufferLoc) + (indexIn * arrIn->datatypeSize_bytes)),
-			 (currSize-indexIn) * arrIn->datatypeSize_bytes );
+	// increment our insert index (since we're adding elements)
+	arrIn->insertIndex += numElemsIn;
 
-	// copy in our new item
-	memcpy((void*)(((uint8_t*)arrIn->bufferLoc) + (indexIn * arrIn->datatypeSize_bytes)), itemLocIn, arrIn->datatypeSize_bytes);
-
-	return true;
+	return retVal;
 }
 
 
@@ -0,0 +1,146 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_blockPool.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static inline void* getNextFree(void *const blockIn);
+static inline void setNextFree(void *const blockIn, void *const nextIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_blockPool_init(cxa_blockPool_t *const poolIn, size_t blockSize_bytesIn, void *const bufferLocIn, size_t bufferMaxSize_bytesIn)
+{
+	cxa_assert(poolIn);
+	cxa_assert(bufferLocIn);
+	cxa_assert(blockSize_bytesIn >= CXA_BLOCKPOOL_LINK_SIZE_BYTES);
+	cxa_assert(blockSize_bytesIn <= bufferMaxSize_bytesIn);
+
+	// save our references
+	poolIn->bufferLoc = (uint8_t*)bufferLocIn;
+	poolIn->blockSize_bytes = blockSize_bytesIn;
+	poolIn->maxNumBlocks = bufferMaxSize_bytesIn / blockSize_bytesIn;
+
+	// set some reasonable defaults
+	poolIn->numReserved = 0;
+	poolIn->highWaterMark = 0;
+	poolIn->numExhausted = 0;
+
+	// link all blocks (in order, so blocks are initially handed out in order)
+	poolIn->freeListHead = NULL;
+	for( size_t i = poolIn->maxNumBlocks; i > 0; i-- )
+	{
+		void* currBlock = &poolIn->bufferLoc[(i-1) * poolIn->blockSize_bytes];
+		setNextFree(currBlock, poolIn->freeListHead);
+		poolIn->freeListHead = currBlock;
+	}
+}
+
+
+void* cxa_blockPool_reserve(cxa_blockPool_t *const poolIn)
+{
+	cxa_assert(poolIn);
+
+	void* retVal = poolIn->freeListHead;
+	if( retVal == NULL )
+	{
+		poolIn->numExhausted++;
+		return NULL;
+	}
+
+	poolIn->freeListHead = getNextFree(retVal);
+	poolIn->numReserved++;
+	if( poolIn->numReserved > poolIn->highWaterMark ) poolIn->highWaterMark = poolIn->numReserved;
+
+	return retVal;
+}
+
+
+void cxa_blockPool_release(cxa_blockPool_t *const poolIn, void *const blockIn)
+{
+	cxa_assert(poolIn);
+	cxa_assert_msg(cxa_blockPool_getBlock_byPointer(poolIn, blockIn) == blockIn, "block not from this pool");
+	cxa_assert_msg(poolIn->numReserved > 0, "mismatched release");
+
+	setNextFree(blockIn, poolIn->freeListHead);
+	poolIn->freeListHead = blockIn;
+	poolIn->numReserved--;
+}
+
+
+void* cxa_blockPool_getBlock_byPointer(cxa_blockPool_t *const poolIn, const void *const ptrIn)
+{
+	cxa_assert(poolIn);
+
+	uintptr_t start = (uintptr_t)poolIn->bufferLoc;
+	uintptr_t ptr = (uintptr_t)ptrIn;
+	if( (ptr < start) || (ptr >= (start + (poolIn->maxNumBlocks * poolIn->blockSize_bytes))) ) return NULL;
+
+	size_t blockIndex = (ptr - start) / poolIn->blockSize_bytes;
+	return &poolIn->bufferLoc[blockIndex * poolIn->blockSize_bytes];
+}
+
+
+size_t cxa_blockPool_getNumFree(cxa_blockPool_t *const poolIn)
+{
+	cxa_assert(poolIn);
+
+	return poolIn->maxNumBlocks - poolIn->numReserved;
+}
+
+
+size_t cxa_blockPool_getMaxNumBlocks(cxa_blockPool_t *const poolIn)
+{
+	cxa_assert(poolIn);
+
+	return poolIn->maxNumBlocks;
+}
+
+
+size_t cxa_blockPool_getHighWaterMark(cxa_blockPool_t *const poolIn)
+{
+	cxa_assert(poolIn);
+
+	return poolIn->highWaterMark;
+}
+
+
+size_t cxa_blockPool_getNumExhausted(cxa_blockPool_t *const poolIn)
+{
+	cxa_assert(poolIn);
+
+	return poolIn->numExhausted;
+}
+
+
+// ******** local function implementations ********
+static inline void* getNextFree(void *const blockIn)
+{
+	void* retVal;
+	memcpy(&retVal, blockIn, sizeof(retVal));
+	return retVal;
+}
+
+
+static inline void setNextFree(void *const blockIn, void *const nextIn)
+{
+	memcpy(blockIn, &nextIn, sizeof(nextIn));
+}
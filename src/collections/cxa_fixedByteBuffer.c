@@ -20,6 +20,8 @@
 
 
 // ******** local function prototypes ********
+static uint8_t* openGap(cxa_fixedByteBuffer_t *const fbbIn, const size_t indexIn, const size_t numBytesIn);
+static void setHeadroom(cxa_fixedByteBuffer_t *const fbbIn, const size_t newHeadroom_bytesIn);
 
 
 // ********  local variable declarations *********
@@ -33,6 +35,21 @@ void cxa_fixedByteBuffer_init(cxa_fixedByteBuffer_t *const fbbIn, void *const bu
 
 	// setup our internal state
 	cxa_array_init(&fbbIn->bytes, 1, bufferLocIn, bufferMaxSize_bytesIn);
+	fbbIn->headroom_bytes = 0;
+	fbbIn->initialHeadroom_bytes = 0;
+}
+
+
+void cxa_fixedByteBuffer_init_withHeadroom(cxa_fixedByteBuffer_t *const fbbIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn, const size_t headroom_bytesIn)
+{
+	cxa_assert(fbbIn);
+	cxa_assert(bufferLocIn);
+	cxa_assert(headroom_bytesIn <= bufferMaxSize_bytesIn);
+
+	// setup our internal state (data starts after our headroom)
+	cxa_array_init(&fbbIn->bytes, 1, ((uint8_t*)bufferLocIn) + headroom_bytesIn, bufferMaxSize_bytesIn - headroom_bytesIn);
+	fbbIn->headroom_bytes = headroom_bytesIn;
+	fbbIn->initialHeadroom_bytes = headroom_bytesIn;
 }
 
 
@@ -43,6 +60,8 @@ void cxa_fixedByteBuffer_init_inPlace(cxa_fixedByteBuffer_t *const fbbIn, const
 
 	// setup our internal state
 	cxa_array_init_inPlace(&fbbIn->bytes, 1, currNumElemsIn, bufferLocIn, bufferMaxSize_bytesIn);
+	fbbIn->headroom_bytes = 0;
+	fbbIn->initialHeadroom_bytes = 0;
 }
 
 
@@ -54,6 +73,8 @@ void cxa_fixedByteBuffer_init_subBufferFixedSize(cxa_fixedByteBuffer_t *const su
 
 	// setup our internal state
 	cxa_array_init_inPlace(&subFbbIn->bytes, 1, numBytesIn, cxa_array_get(&parentFbbIn->bytes, startIndexIn), numBytesIn);
+	subFbbIn->headroom_bytes = 0;
+	subFbbIn->initialHeadroom_bytes = 0;
 }
 
 
@@ -66,6 +87,8 @@ void cxa_fixedByteBuffer_init_subBufferRemainingElems(cxa_fixedByteBuffer_t *con
 	// setup our internal state
 	size_t numElems = cxa_fixedByteBuffer_getSize_bytes(parentFbbIn) - startIndexIn;
 	cxa_array_init_inPlace(&subFbbIn->bytes, 1, numElems, cxa_array_get_noBoundsCheck(&parentFbbIn->bytes, startIndexIn), numElems);
+	subFbbIn->headroom_bytes = 0;
+	subFbbIn->initialHeadroom_bytes = 0;
 }
 
 
@@ -73,11 +96,13 @@ void cxa_fixedByteBuffer_init_subBufferParentMaxSize(cxa_fixedByteBuffer_t *cons
 {
 	cxa_assert(subFbbIn);
 	cxa_assert(parentFbbIn);
-	cxa_assert(startIndexIn <= cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn));
+	cxa_assert(startIndexIn <= cxa_array_getMaxSize_elems(&parentFbbIn->bytes));
 
-	// setup our internal state
-	size_t maxSize_bytes = cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn) - startIndexIn;
+	// setup our internal state (parent's headroom, if any, is not available to us)
+	size_t maxSize_bytes = cxa_array_getMaxSize_elems(&parentFbbIn->bytes) - startIndexIn;
 	cxa_array_init_inPlace(&subFbbIn->bytes, 1, 0, cxa_array_get_noBoundsCheck(&parentFbbIn->bytes, startIndexIn), maxSize_bytes);
+	subFbbIn->headroom_bytes = 0;
+	subFbbIn->initialHeadroom_bytes = 0;
 }
 
 
@@ -89,11 +114,10 @@ bool cxa_fixedByteBuffer_append(cxa_fixedByteBuffer_t *const fbbIn, uint8_t *con
 	// make sure we have room for the operation
 	if( cxa_fixedByteBuffer_getFreeSize_bytes(fbbIn) < numBytesIn ) return false;
 
-	for( size_t i = 0; i < numBytesIn; i++ )
-	{
-		if( !cxa_array_append(&fbbIn->bytes, &(ptrIn[i])) ) return false;
-	}
+	uint8_t* dest = openGap(fbbIn, cxa_fixedByteBuffer_getSize_bytes(fbbIn), numBytesIn);
+	if( dest == NULL ) return false;
 
+	memcpy(dest, ptrIn, numBytesIn);
 	return true;
 }
 
@@ -106,9 +130,12 @@ bool cxa_fixedByteBuffer_append_transposed(cxa_fixedByteBuffer_t *const fbbIn, u
 	// make sure we have room for the operation
 	if( cxa_fixedByteBuffer_getFreeSize_bytes(fbbIn) < numBytesIn ) return false;
 
+	uint8_t* dest = openGap(fbbIn, cxa_fixedByteBuffer_getSize_bytes(fbbIn), numBytesIn);
+	if( dest == NULL ) return false;
+
 	for( size_t i = 0; i < numBytesIn; i++ )
 	{
-		if( !cxa_array_append(&fbbIn->bytes, &(ptrIn[numBytesIn-i-1])) ) return false;
+		dest[i] = ptrIn[numBytesIn-i-1];
 	}
 
 	return true;
@@ -138,13 +165,7 @@ void* cxa_fixedByteBuffer_append_emptyBytes(cxa_fixedByteBuffer_t *const fbbIn,
 	// make sure we have room for the operation
 	if( cxa_fixedByteBuffer_getFreeSize_bytes(fbbIn) < numBytesIn ) return NULL;
 
-	void* retVal = cxa_fixedByteBuffer_get_pointerToIndex(fbbIn, cxa_fixedByteBuffer_getSize_bytes(fbbIn));
-	for( size_t i = 0; i < numBytesIn; i++ )
-	{
-		// shouldn't happen, but we should test
-		if( !cxa_array_append_empty(&fbbIn->bytes) ) return NULL;
-	}
-	return retVal;
+	return openGap(fbbIn, cxa_fixedByteBuffer_getSize_bytes(fbbIn), numBytesIn);
 }
 
 
@@ -154,12 +175,10 @@ bool cxa_fixedByteBuffer_append_fbb(cxa_fixedByteBuffer_t *const fbbIn, cxa_fixe
 
 	if( sourceFbbIn == NULL ) return true;
 
-	cxa_array_iterate(&sourceFbbIn->bytes, currByte, uint8_t)
-	{
-		if( !cxa_fixedByteBuffer_append_uint8(fbbIn, *currByte) ) return false;
-	}
+	size_t numSourceBytes = cxa_fixedByteBuffer_getSize_bytes(sourceFbbIn);
+	if( numSourceBytes == 0 ) return true;
 
-	return true;
+	return cxa_fixedByteBuffer_append(fbbIn, cxa_fixedByteBuffer_get_pointerToStartOfData(sourceFbbIn), numSourceBytes);
 }
 
 
@@ -170,12 +189,19 @@ bool cxa_fixedByteBuffer_remove(cxa_fixedByteBuffer_t *const fbbIn, const size_t
 	// make sure we have room for the operation
 	if( (indexIn + numBytesIn) > cxa_fixedByteBuffer_getSize_bytes(fbbIn) ) return false;
 
-	for( size_t i = 0; i < numBytesIn; i++ )
+	// if we have headroom (and fewer bytes before the removal than after),
+	// shift the leading bytes up and grow our headroom instead
+	size_t numTrailingBytes = cxa_fixedByteBuffer_getSize_bytes(fbbIn) - (indexIn + numBytesIn);
+	if( (fbbIn->initialHeadroom_bytes > 0) && (indexIn < numTrailingBytes) )
 	{
-		if( !cxa_array_remove_atIndex(&fbbIn->bytes, indexIn) ) return false;
+		uint8_t* start = (uint8_t*)fbbIn->bytes.bufferLoc;
+		memmove(start + numBytesIn, start, indexIn);
+		setHeadroom(fbbIn, fbbIn->headroom_bytes + numBytesIn);
+		fbbIn->bytes.insertIndex -= numBytesIn;
+		return true;
 	}
 
-	return true;
+	return cxa_array_removeRange(&fbbIn->bytes, indexIn, numBytesIn);
 }
 
 
@@ -354,11 +380,10 @@ bool cxa_fixedByteBuffer_insert(cxa_fixedByteBuffer_t *const fbbIn, const size_t
 	// make sure the index is in bounds
 	if( indexIn > cxa_fixedByteBuffer_getSize_bytes(fbbIn) ) return false;
 
-	for( size_t i = 0; i < numBytesIn; i++ )
-	{
-		if( !cxa_array_insert(&fbbIn->bytes, indexIn+i, (void*)&(ptrIn[i])) ) return false;
-	}
+	uint8_t* dest = openGap(fbbIn, indexIn, numBytesIn);
+	if( dest == NULL ) return false;
 
+	memcpy(dest, ptrIn, numBytesIn);
 	return true;
 }
 
@@ -383,7 +408,7 @@ size_t cxa_fixedByteBuffer_getMaxSize_bytes(cxa_fixedByteBuffer_t *const fbbIn)
 {
 	cxa_assert(fbbIn);
 
-	return cxa_array_getMaxSize_elems(&fbbIn->bytes);
+	return cxa_array_getMaxSize_elems(&fbbIn->bytes) + fbbIn->headroom_bytes;
 }
 
 
@@ -391,7 +416,7 @@ size_t cxa_fixedByteBuffer_getFreeSize_bytes(cxa_fixedByteBuffer_t *const fbbIn)
 {
 	cxa_assert(fbbIn);
 
-	return cxa_array_getFreeSize_elems(&fbbIn->bytes);
+	return cxa_array_getFreeSize_elems(&fbbIn->bytes) + fbbIn->headroom_bytes;
 }
 
 
@@ -414,7 +439,60 @@ void cxa_fixedByteBuffer_clear(cxa_fixedByteBuffer_t *const fbbIn)
 	cxa_assert(fbbIn);
 
 	cxa_array_clear(&fbbIn->bytes);
+	setHeadroom(fbbIn, fbbIn->initialHeadroom_bytes);
+}
+
+
+size_t cxa_fixedByteBuffer_getHeadroom_bytes(cxa_fixedByteBuffer_t *const fbbIn)
+{
+	cxa_assert(fbbIn);
+
+	return fbbIn->headroom_bytes;
 }
 
 
 // ******** local function implementations ********
+static uint8_t* openGap(cxa_fixedByteBuffer_t *const fbbIn, const size_t indexIn, const size_t numBytesIn)
+{
+	cxa_assert(fbbIn);
+
+	size_t currSize_bytes = cxa_fixedByteBuffer_getSize_bytes(fbbIn);
+	if( (indexIn > currSize_bytes) || (numBytesIn > cxa_fixedByteBuffer_getFreeSize_bytes(fbbIn)) ) return NULL;
+
+	// if we have enough headroom (and fewer bytes before the insertion than after),
+	// move the leading bytes down into our headroom rather than moving the tail up
+	if( (fbbIn->headroom_bytes >= numBytesIn) && (indexIn < (currSize_bytes - indexIn)) )
+	{
+		uint8_t* oldStart = (uint8_t*)fbbIn->bytes.bufferLoc;
+		memmove(oldStart - numBytesIn, oldStart, indexIn);
+		setHeadroom(fbbIn, fbbIn->headroom_bytes - numBytesIn);
+		fbbIn->bytes.insertIndex += numBytesIn;
+
+		return ((uint8_t*)fbbIn->bytes.bufferLoc) + indexIn;
+	}
+
+	// otherwise, we grow at the tail...reclaim our headroom if we need the space
+	if( cxa_array_getFreeSize_elems(&fbbIn->bytes) < numBytesIn )
+	{
+		uint8_t* oldStart = (uint8_t*)fbbIn->bytes.bufferLoc;
+		memmove(oldStart - fbbIn->headroom_bytes, oldStart, currSize_bytes);
+		setHeadroom(fbbIn, 0);
+	}
+
+	return cxa_array_insertRange_empty(&fbbIn->bytes, indexIn, numBytesIn);
+}
+
+
+static void setHeadroom(cxa_fixedByteBuffer_t *const fbbIn, const size_t newHeadroom_bytesIn)
+{
+	cxa_assert(fbbIn);
+
+	// moves the start of our data (the data itself must already be in place,
+	// callers are responsible for updating the size)
+	uint8_t* rawStart = ((uint8_t*)fbbIn->bytes.bufferLoc) - fbbIn->headroom_bytes;
+	size_t rawSize_bytes = fbbIn->bytes.maxNumElements + fbbIn->headroom_bytes;
+
+	fbbIn->bytes.bufferLoc = rawStart + newHeadroom_bytesIn;
+	fbbIn->bytes.maxNumElements = rawSize_bytes - newHeadroom_bytesIn;
+	fbbIn->headroom_bytes = newHeadroom_bytesIn;
+}
@@ -20,6 +20,10 @@
 
 
 // ******** local function prototypes ********
+static inline void* getElemAddr(cxa_fixedFifo_t *const fifoIn, size_t indexIn);
+static inline size_t advanceIndex(cxa_fixedFifo_t *const fifoIn, size_t indexIn, size_t numElemsIn);
+static size_t getContiguousFree_elems(cxa_fixedFifo_t *const fifoIn);
+static void notifyNoLongerFull(cxa_fixedFifo_t *const fifoIn);
 
 
 // ********  local variable declarations *********
@@ -160,16 +164,7 @@ bool cxa_fixedFifo_dequeue(cxa_fixedFifo_t *const fifoIn, void *elemOut)
 	fifoIn->removeIndex = (newRemoveIndex >= fifoIn->maxNumElements) ? 0 : newRemoveIndex;
 
 	#if CXA_FF_MAX_LISTENERS > 0
-		// notify our listeners
-		if( wasFull )
-		{
-			cxa_array_iterate(&fifoIn->listeners, currEntry, cxa_fixedFifo_listener_entry_t)
-			{
-				if( currEntry == NULL ) continue;
-
-				if( currEntry->cb_noLongerFull != NULL ) currEntry->cb_noLongerFull(fifoIn, currEntry->userVarIn);
-			}
-		}
+		if( wasFull ) notifyNoLongerFull(fifoIn);
 	#endif
 
 	return true;
@@ -181,12 +176,72 @@ bool cxa_fixedFifo_bulkQueue(cxa_fixedFifo_t *const fifoIn, void *const elemsIn,
 	cxa_assert(fifoIn);
 	cxa_assert(elemsIn);
 
-	// simplistic implementation...we can probably make this more efficient
-	for( size_t i = 0; i < numElemsIn; i++ )
+	uint8_t* srcBytes = (uint8_t*)elemsIn;
+	bool retVal = true;
+
+	// make room (or truncate) if we don't have enough space
+	size_t capacity_elems = fifoIn->maxNumElements - 1;
+	size_t free_elems = capacity_elems - cxa_fixedFifo_getSize_elems(fifoIn);
+	if( numElemsIn > free_elems )
+	{
+		switch( fifoIn->onFullAction )
+		{
+			case CXA_FF_ON_FULL_DEQUEUE:
+				// only the newest elements will survive
+				if( numElemsIn > capacity_elems )
+				{
+					srcBytes += (numElemsIn - capacity_elems) * fifoIn->datatypeSize_bytes;
+					numElemsIn = capacity_elems;
+				}
+				cxa_fixedFifo_bulkDequeue(fifoIn, numElemsIn - free_elems);
+				break;
+
+			case CXA_FF_ON_FULL_DROP:
+				// queue what we can
+				numElemsIn = free_elems;
+				retVal = false;
+				break;
+		}
+	}
+
+	// copy in (at most) two spans: up to the end of the buffer, then from the start
+	while( numElemsIn > 0 )
 	{
-		if( !cxa_fixedFifo_queue(fifoIn, &(((uint8_t*)elemsIn)[i*fifoIn->datatypeSize_bytes])) ) return false;
+		void* dest;
+		size_t numContig_elems = cxa_fixedFifo_bulkQueue_reserve(fifoIn, &dest);
+		if( numContig_elems > numElemsIn ) numContig_elems = numElemsIn;
+
+		size_t numContig_bytes = numContig_elems * fifoIn->datatypeSize_bytes;
+		memcpy(dest, srcBytes, numContig_bytes);
+		cxa_fixedFifo_bulkQueue_commit(fifoIn, numContig_elems);
+
+		srcBytes += numContig_bytes;
+		numElemsIn -= numContig_elems;
 	}
 
+	return retVal;
+}
+
+
+size_t cxa_fixedFifo_bulkQueue_reserve(cxa_fixedFifo_t *const fifoIn, void **const elemsOut)
+{
+	cxa_assert(fifoIn);
+
+	if( elemsOut != NULL ) *elemsOut = getElemAddr(fifoIn, fifoIn->insertIndex);
+
+	return getContiguousFree_elems(fifoIn);
+}
+
+
+bool cxa_fixedFifo_bulkQueue_commit(cxa_fixedFifo_t *const fifoIn, size_t numElemsIn)
+{
+	cxa_assert(fifoIn);
+
+	if( numElemsIn > getContiguousFree_elems(fifoIn) ) return false;
+
+	// data is already in place, just publish it
+	fifoIn->insertIndex = advanceIndex(fifoIn, fifoIn->insertIndex, numElemsIn);
+
 	return true;
 }
 
@@ -195,13 +250,44 @@ bool cxa_fixedFifo_bulkDequeue(cxa_fixedFifo_t *const fifoIn, size_t numElemsIn)
 {
 	cxa_assert(fifoIn);
 
-	// simplistic implementation...we can probably make this more efficient
-	for( size_t i = 0; i < numElemsIn; i++ )
+	bool wasFull = cxa_fixedFifo_isFull(fifoIn);
+
+	size_t currSize_elems = cxa_fixedFifo_getSize_elems(fifoIn);
+	size_t numToRemove_elems = (numElemsIn <= currSize_elems) ? numElemsIn : currSize_elems;
+
+	fifoIn->removeIndex = advanceIndex(fifoIn, fifoIn->removeIndex, numToRemove_elems);
+
+	if( wasFull && (numToRemove_elems > 0) ) notifyNoLongerFull(fifoIn);
+
+	return (numToRemove_elems == numElemsIn);
+}
+
+
+size_t cxa_fixedFifo_bulkDequeue_copy(cxa_fixedFifo_t *const fifoIn, void *const elemsOut, size_t maxNumElemsIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(elemsOut);
+
+	uint8_t* destBytes = (uint8_t*)elemsOut;
+	size_t numCopied_elems = 0;
+
+	// copy out (at most) two spans: up to the end of the buffer, then from the start
+	while( numCopied_elems < maxNumElemsIn )
 	{
-		if( !cxa_fixedFifo_dequeue(fifoIn, NULL) ) return false;
+		void* src;
+		size_t numContig_elems = cxa_fixedFifo_bulkDequeue_peek(fifoIn, &src);
+		if( numContig_elems == 0 ) break;
+		if( numContig_elems > (maxNumElemsIn - numCopied_elems) ) numContig_elems = maxNumElemsIn - numCopied_elems;
+
+		size_t numContig_bytes = numContig_elems * fifoIn->datatypeSize_bytes;
+		memcpy(destBytes, src, numContig_bytes);
+		cxa_fixedFifo_bulkDequeue(fifoIn, numContig_elems);
+
+		destBytes += numContig_bytes;
+		numCopied_elems += numContig_elems;
 	}
 
-	return true;
+	return numCopied_elems;
 }
 
 
@@ -209,11 +295,14 @@ size_t cxa_fixedFifo_bulkDequeue_peek(cxa_fixedFifo_t *const fifoIn, void **cons
 {
 	cxa_assert(fifoIn);
 
-	if( elemsOut != NULL ) *elemsOut = &(((uint8_t*)fifoIn->bufferLoc)[fifoIn->removeIndex*fifoIn->datatypeSize_bytes]);
+	size_t lcl_removeIndex = fifoIn->removeIndex;
+	size_t lcl_insertIndex = fifoIn->insertIndex;
 
-	return (fifoIn->insertIndex >= fifoIn->removeIndex) ?
-			(fifoIn->insertIndex - fifoIn->removeIndex) :
-			(fifoIn->maxNumElements-fifoIn->removeIndex);
+	if( elemsOut != NULL ) *elemsOut = getElemAddr(fifoIn, lcl_removeIndex);
+
+	return (lcl_insertIndex >= lcl_removeIndex) ?
+			(lcl_insertIndex - lcl_removeIndex) :
+			(fifoIn->maxNumElements - lcl_removeIndex);
 }
 
 
@@ -265,3 +354,42 @@ bool cxa_fixedFifo_isEmpty(cxa_fixedFifo_t *const fifoIn)
 
 
 // ******** local function implementations ********
+static inline void* getElemAddr(cxa_fixedFifo_t *const fifoIn, size_t indexIn)
+{
+	return (void*)(((uint8_t*)fifoIn->bufferLoc) + (indexIn * fifoIn->datatypeSize_bytes));
+}
+
+
+static inline size_t advanceIndex(cxa_fixedFifo_t *const fifoIn, size_t indexIn, size_t numElemsIn)
+{
+	size_t retVal = indexIn + numElemsIn;
+	return (retVal >= fifoIn->maxNumElements) ? (retVal - fifoIn->maxNumElements) : retVal;
+}
+
+
+static size_t getContiguousFree_elems(cxa_fixedFifo_t *const fifoIn)
+{
+	size_t lcl_removeIndex = fifoIn->removeIndex;
+	size_t lcl_insertIndex = fifoIn->insertIndex;
+
+	// one slot always stays empty so we can tell full from empty
+	if( lcl_insertIndex < lcl_removeIndex ) return (lcl_removeIndex - lcl_insertIndex - 1);
+	return (lcl_removeIndex == 0) ?
+			(fifoIn->maxNumElements - lcl_insertIndex - 1) :
+			(fifoIn->maxNumElements - lcl_insertIndex);
+}
+
+
+static void notifyNoLongerFull(cxa_fixedFifo_t *const fifoIn)
+{
+	#if CXA_FF_MAX_LISTENERS > 0
+		cxa_array_iterate(&fifoIn->listeners, currEntry, cxa_fixedFifo_listener_entry_t)
+		{
+			if( currEntry == NULL ) continue;
+
+			if( currEntry->cb_noLongerFull != NULL ) currEntry->cb_noLongerFull(fifoIn, currEntry->userVarIn);
+		}
+	#else
+		(void)fifoIn;
+	#endif
+}
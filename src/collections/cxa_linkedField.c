@@ -22,12 +22,12 @@
 
 // ******** local function prototypes ********
 static cxa_fixedByteBuffer_t* getParentBufferFromChild(cxa_linkedField_t *const fbbLfIn);
-static size_t getLengthOfAllFixedFields_bytes(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static size_t getStartIndexInParent(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static cxa_linkedField_t* getEndOfChain(cxa_linkedField_t *const fbbLfIn);
-static bool validateChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static bool isUnfilledFixedLengthFieldUpChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
-static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn);
+static size_t getLengthOfAllFixedFields_bytes(cxa_linkedField_t *const fbbLfIn);
+static bool validateChain(cxa_linkedField_t *const fbbLfIn);
+static bool isUnfilledFixedLengthField(cxa_linkedField_t *const fbbLfIn);
+static void linkToPrevious(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn);
+static void setSize(cxa_linkedField_t *const fbbLfIn, const size_t newSize_bytesIn);
+static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn);
 
 
 // ********  local variable declarations *********
@@ -43,10 +43,14 @@ bool cxa_linkedField_initRoot(cxa_linkedField_t *const fbbLfIn, cxa_fixedByteBuf
 	fbbLfIn->parent = parentFbbIn;
 	fbbLfIn->prev = NULL;
 	fbbLfIn->next = NULL;
+	fbbLfIn->root = fbbLfIn;
+	fbbLfIn->tail = fbbLfIn;
 	fbbLfIn->startIndex = startIndexInParentIn;
 	fbbLfIn->isFixedLength = false;
 	fbbLfIn->maxFixedLength_bytes = 0;
 	fbbLfIn->currSize_bytes = initialSize_bytesIn;
+	fbbLfIn->numUnfilledFixedFieldsUpChain = 0;
+	fbbLfIn->fixedLengthUpChain_bytes = 0;
 
 	// make sure the start index isn't outside the max bounds for the parent
 	if( startIndexInParentIn+initialSize_bytesIn > cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn) ) return false;
@@ -64,10 +68,14 @@ bool cxa_linkedField_initRoot_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_fix
 	fbbLfIn->parent = parentFbbIn;
 	fbbLfIn->prev = NULL;
 	fbbLfIn->next = NULL;
+	fbbLfIn->root = fbbLfIn;
+	fbbLfIn->tail = fbbLfIn;
 	fbbLfIn->startIndex = startIndexInParentIn;
 	fbbLfIn->isFixedLength = true;
 	fbbLfIn->maxFixedLength_bytes = maxLen_bytesIn;
 	fbbLfIn->currSize_bytes = CXA_MIN(maxLen_bytesIn, cxa_fixedByteBuffer_getSize_bytes(parentFbbIn));
+	fbbLfIn->numUnfilledFixedFieldsUpChain = 0;
+	fbbLfIn->fixedLengthUpChain_bytes = maxLen_bytesIn;
 
 	// make sure that our fixed size (with index) isn't bigger than the parent's capacity
 	if( (startIndexInParentIn + maxLen_bytesIn) > cxa_fixedByteBuffer_getMaxSize_bytes(parentFbbIn) ) return false;
@@ -80,15 +88,12 @@ bool cxa_linkedField_initChild(cxa_linkedField_t *const fbbLfIn, cxa_linkedField
 	cxa_assert(fbbLfIn);
 
 	// save our internal state
-	fbbLfIn->prev = prevFbbLfIn;
-	fbbLfIn->next = NULL;
-	prevFbbLfIn->next = fbbLfIn;
-	fbbLfIn->parent = NULL;
-	fbbLfIn->parent = getParentBufferFromChild(fbbLfIn);
+	linkToPrevious(fbbLfIn, prevFbbLfIn);
 	if( fbbLfIn->parent == NULL )
 	{
 		// we failed to initialize properly
 		prevFbbLfIn->next = NULL;
+		fbbLfIn->root->tail = prevFbbLfIn;
 		return false;
 	}
 
@@ -96,10 +101,11 @@ bool cxa_linkedField_initChild(cxa_linkedField_t *const fbbLfIn, cxa_linkedField
 	fbbLfIn->maxFixedLength_bytes = 0;
 	fbbLfIn->currSize_bytes = initialSize_bytesIn;
 
-	if( ((getStartIndexInParent(fbbLfIn, true) + fbbLfIn->currSize_bytes) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) || !validateChain(fbbLfIn, true) )
+	if( ((fbbLfIn->startIndex + fbbLfIn->currSize_bytes) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) || !validateChain(fbbLfIn) )
 	{
 		// we failed to initialize properly
 		prevFbbLfIn->next = NULL;
+		fbbLfIn->root->tail = prevFbbLfIn;
 		return false;
 	}
 
@@ -112,21 +118,18 @@ bool cxa_linkedField_initChild_fixedLen(cxa_linkedField_t *const fbbLfIn, cxa_li
 	cxa_assert(fbbLfIn);
 
 	// save our internal state
-	fbbLfIn->prev = prevFbbLfIn;
-	fbbLfIn->next = NULL;
-	prevFbbLfIn->next = fbbLfIn;
-	fbbLfIn->parent = NULL;
-	fbbLfIn->parent = getParentBufferFromChild(fbbLfIn);
+	linkToPrevious(fbbLfIn, prevFbbLfIn);
 	if( fbbLfIn->parent == NULL ) return false;
 
 	fbbLfIn->isFixedLength = true;
 	fbbLfIn->maxFixedLength_bytes = maxLen_bytesIn;
-	fbbLfIn->currSize_bytes = CXA_MIN(maxLen_bytesIn, (cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent) - getStartIndexInParent(fbbLfIn, true)));
+	fbbLfIn->currSize_bytes = CXA_MIN(maxLen_bytesIn, (cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent) - fbbLfIn->startIndex));
+	fbbLfIn->fixedLengthUpChain_bytes += maxLen_bytesIn;
 
 	// make sure that that sizes of all fixed-length fields aren't too big...
-	if( getLengthOfAllFixedFields_bytes(fbbLfIn, true) > cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) ) return false;
+	if( getLengthOfAllFixedFields_bytes(fbbLfIn) > cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) ) return false;
 
-	return validateChain(fbbLfIn, true);
+	return validateChain(fbbLfIn);
 }
 
 
@@ -156,18 +159,18 @@ bool cxa_linkedField_remove(cxa_linkedField_t *const fbbLfIn, const size_t index
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// we can't be removed if there is stuff after us and we are fixed length...
-	if( fbbLfIn->isFixedLength && isNonEmptyFieldDownChain(fbbLfIn, true) ) return false;
+	if( fbbLfIn->isFixedLength && isNonEmptyFieldDownChain(fbbLfIn) ) return false;
 
 	// make sure the index is in bounds
-	size_t removeIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t removeIndex = fbbLfIn->startIndex + indexIn;
 	if( ((indexIn + numBytesIn) > fbbLfIn->currSize_bytes) || ((removeIndex+ numBytesIn) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) ) return false;
 
 	// if we made it here, we can try the remove
 	if( !cxa_fixedByteBuffer_remove(fbbLfIn->parent, removeIndex , numBytesIn) ) return false;
-	fbbLfIn->currSize_bytes -= numBytesIn;
+	setSize(fbbLfIn, fbbLfIn->currSize_bytes - numBytesIn);
 
 	return true;
 }
@@ -178,7 +181,7 @@ bool cxa_linkedField_remove_cString(cxa_linkedField_t *const fbbLfIn, const size
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// get our target string
 	uint8_t* targetString = cxa_linkedField_get_pointerToIndex(fbbLfIn, indexIn);
@@ -221,10 +224,10 @@ uint8_t* cxa_linkedField_get_pointerToIndex(cxa_linkedField_t *const fbbLfIn, co
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return NULL;
+	if( !validateChain(fbbLfIn) ) return NULL;
 
 	// we need an index
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 
 	return cxa_fixedByteBuffer_get_pointerToIndex(fbbLfIn->parent, parentIndex);
 }
@@ -235,13 +238,13 @@ bool cxa_linkedField_get(cxa_linkedField_t *const fbbLfIn, const size_t indexIn,
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// make sure that we have enough bytes in _our_ buffer
 	if( numBytesIn > fbbLfIn->currSize_bytes ) return false;
 
 	// we need an index
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 
 	return cxa_fixedByteBuffer_get(fbbLfIn->parent, parentIndex, transposeIn, valOut, numBytesIn);
 }
@@ -252,7 +255,7 @@ bool cxa_linkedField_get_cstring(cxa_linkedField_t *const fbbLfIn, const size_t
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// get our target string
 	char* targetString = (char*)cxa_linkedField_get_pointerToIndex(fbbLfIn, indexIn);
@@ -264,7 +267,7 @@ bool cxa_linkedField_get_cstring(cxa_linkedField_t *const fbbLfIn, const size_t
 	// make sure that we have enough bytes in _our_ buffer
 	if( targetStringLen_bytes > fbbLfIn->currSize_bytes ) return false;
 
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	return cxa_fixedByteBuffer_get_cString(fbbLfIn->parent, parentIndex, stringOut, maxOutputSize_bytes);
 }
 
@@ -274,13 +277,13 @@ bool cxa_linkedField_get_cstring_inPlace(cxa_linkedField_t *const fbbLfIn, const
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// get our target string
 	char* targetString = (char*)cxa_linkedField_get_pointerToIndex(fbbLfIn, indexIn);
 	if( targetString == NULL ) return false;
 
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	return cxa_fixedByteBuffer_get_cString_inPlace(fbbLfIn->parent, parentIndex, stringOut, strLen_bytesOut);
 }
 
@@ -310,13 +313,13 @@ bool cxa_linkedField_replace(cxa_linkedField_t *const fbbLfIn, const size_t inde
 	cxa_assert(fbbLfIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// make sure that we have enough bytes in _our_ buffer
 	if( numBytesIn > fbbLfIn->currSize_bytes ) return false;
 
 	// we need an index
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	return cxa_fixedByteBuffer_replace(fbbLfIn->parent, parentIndex, ptrIn, numBytesIn);
 }
 
@@ -354,16 +357,16 @@ bool cxa_linkedField_insert(cxa_linkedField_t *const fbbLfIn, const size_t index
 	cxa_assert(ptrIn);
 
 	// ensure our chain is valid
-	if( !validateChain(fbbLfIn, true) ) return false;
+	if( !validateChain(fbbLfIn) ) return false;
 
 	// make sure there aren't any unfilled fixed-length fields before us
-	if( isUnfilledFixedLengthFieldUpChain(fbbLfIn, true) ) return false;
+	if( fbbLfIn->numUnfilledFixedFieldsUpChain > 0 ) return false;
 
 	// if we made it here, we can at least try to insert the item...
-	size_t parentIndex = getStartIndexInParent(fbbLfIn, true) + indexIn;
+	size_t parentIndex = fbbLfIn->startIndex + indexIn;
 	if( !cxa_fixedByteBuffer_insert(fbbLfIn->parent, parentIndex, ptrIn, numBytesIn) ) return false;
 
-	fbbLfIn->currSize_bytes += numBytesIn;
+	setSize(fbbLfIn, fbbLfIn->currSize_bytes + numBytesIn);
 
 	return true;
 }
@@ -372,7 +375,7 @@ bool cxa_linkedField_insert(cxa_linkedField_t *const fbbLfIn, const size_t index
 size_t cxa_linkedField_getSize_bytes(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
-	if( !validateChain(fbbLfIn, true) ) return 0;
+	if( !validateChain(fbbLfIn) ) return 0;
 
 	return fbbLfIn->currSize_bytes;
 }
@@ -400,12 +403,12 @@ bool cxa_linkedField_prependTo_lengthPrefixedField_uint16BE(cxa_linkedField_t *c
 size_t cxa_linkedField_getMaxSize_bytes(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
-	if( !validateChain(fbbLfIn, true) ) return 0;
+	if( !validateChain(fbbLfIn) ) return 0;
 
 	if( fbbLfIn->isFixedLength ) return fbbLfIn->maxFixedLength_bytes;
 
 	// if we made it here, this is a little more complicated...
-	return cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) - getLengthOfAllFixedFields_bytes(fbbLfIn, true);
+	return cxa_fixedByteBuffer_getMaxSize_bytes(fbbLfIn->parent) - getLengthOfAllFixedFields_bytes(fbbLfIn);
 }
 
 
@@ -421,7 +424,7 @@ size_t cxa_linkedField_getStartIndexInParent(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	return getStartIndexInParent(fbbLfIn, true);
+	return fbbLfIn->startIndex;
 }
 
 
@@ -440,115 +443,99 @@ static cxa_fixedByteBuffer_t* getParentBufferFromChild(cxa_linkedField_t *const
 }
 
 
-static size_t getLengthOfAllFixedFields_bytes(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static size_t getLengthOfAllFixedFields_bytes(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	if( isFirstCallIn )
-	{
-		cxa_linkedField_t *endOfChain = getEndOfChain(fbbLfIn);
-		if( endOfChain == NULL ) return 0;
-
-		return getLengthOfAllFixedFields_bytes(endOfChain, false);
-	}
-
-	// if we made it here, this isn't our first call...
-	size_t retVal = (fbbLfIn->isFixedLength) ? fbbLfIn->maxFixedLength_bytes : 0;
-	if( fbbLfIn->prev != NULL ) retVal += getLengthOfAllFixedFields_bytes(fbbLfIn->prev, false);
-
-	return retVal;
+	// the last field in the chain has the total for the whole chain
+	return fbbLfIn->root->tail->fixedLengthUpChain_bytes;
 }
 
 
-static size_t getStartIndexInParent(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static bool validateChain(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	size_t retVal = 0;
-
-	// add from the previous field
-	if( fbbLfIn->prev != NULL ) retVal += getStartIndexInParent(fbbLfIn->prev, false);
+	// cheap check: we must still fit within our parent
+	if( (fbbLfIn->parent == NULL) || ((fbbLfIn->startIndex + fbbLfIn->currSize_bytes) > cxa_fixedByteBuffer_getSize_bytes(fbbLfIn->parent)) ) return false;
 
-	// now add ourselves
-	if( fbbLfIn->prev == NULL ) retVal += fbbLfIn->startIndex;
-	if( !isFirstCallIn) retVal += fbbLfIn->currSize_bytes;
+#ifdef CXA_LINKEDFIELD_VALIDATECHAIN_ENABLE
+	// debug-only: walk the entire chain and make sure our cached values are consistent
+	cxa_linkedField_t* currField = fbbLfIn;
+	while( currField->prev != NULL ) currField = currField->prev;
+	for( ; currField != NULL; currField = currField->next )
+	{
+		if( currField->parent != fbbLfIn->parent ) return false;
+		if( currField->prev != NULL )
+		{
+			cxa_linkedField_t* prevField = currField->prev;
+			size_t expectedNumUnfilled = prevField->numUnfilledFixedFieldsUpChain + (isUnfilledFixedLengthField(prevField) ? 1 : 0);
+
+			if( currField->startIndex != (prevField->startIndex + prevField->currSize_bytes) ) return false;
+			if( currField->numUnfilledFixedFieldsUpChain != expectedNumUnfilled ) return false;
+			if( currField->fixedLengthUpChain_bytes != (prevField->fixedLengthUpChain_bytes + (currField->isFixedLength ? currField->maxFixedLength_bytes : 0)) ) return false;
+		}
+		if( currField->root != fbbLfIn->root ) return false;
+		if( (currField->next == NULL) &&
+			(((currField->startIndex + currField->currSize_bytes) > cxa_fixedByteBuffer_getSize_bytes(currField->parent)) ||
+			 (currField->root->tail != currField)) ) return false;
+	}
+#endif
 
-	return retVal;
+	return true;
 }
 
 
-static cxa_linkedField_t* getEndOfChain(cxa_linkedField_t *const fbbLfIn)
+static bool isUnfilledFixedLengthField(cxa_linkedField_t *const fbbLfIn)
 {
-	cxa_assert(fbbLfIn);
-
-	return (fbbLfIn->next != NULL) ? getEndOfChain(fbbLfIn->next) : fbbLfIn;
+	return fbbLfIn->isFixedLength && (fbbLfIn->currSize_bytes != fbbLfIn->maxFixedLength_bytes);
 }
 
 
-static bool validateChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static void linkToPrevious(cxa_linkedField_t *const fbbLfIn, cxa_linkedField_t *const prevFbbLfIn)
 {
 	cxa_assert(fbbLfIn);
+	cxa_assert(prevFbbLfIn);
 
-	// if we were the first...
-	if( isFirstCallIn )
-	{
-		// start the recursion from the end of the chain
-		cxa_linkedField_t* endOfChain = getEndOfChain(fbbLfIn);
-		if( endOfChain == NULL ) return false;
-
-		// now that we found the end of the chain, calculate sizes for it
-		size_t calcSize_bytes = getStartIndexInParent(endOfChain, true) + endOfChain->currSize_bytes;
-		size_t actualSize_bytes = cxa_fixedByteBuffer_getSize_bytes(endOfChain->parent);
-
-		if( calcSize_bytes > actualSize_bytes ) return false;
-
-		return validateChain(endOfChain, false);
-	}
-
-	// if we made it here, we're not the first...do basic checks
-	// make sure we have a parent
-	if( fbbLfIn->parent == NULL ) return false;
+	fbbLfIn->prev = prevFbbLfIn;
+	fbbLfIn->next = NULL;
+	prevFbbLfIn->next = fbbLfIn;
+	fbbLfIn->parent = NULL;
+	fbbLfIn->parent = getParentBufferFromChild(fbbLfIn);
+	fbbLfIn->root = prevFbbLfIn->root;
+	fbbLfIn->root->tail = fbbLfIn;
 
-	// now validate the previous field (if applicable)
-	return (fbbLfIn->prev != NULL) ? validateChain(fbbLfIn->prev, false) : true;
+	// we start where our previous field ends
+	fbbLfIn->startIndex = prevFbbLfIn->startIndex + prevFbbLfIn->currSize_bytes;
+	fbbLfIn->numUnfilledFixedFieldsUpChain = prevFbbLfIn->numUnfilledFixedFieldsUpChain + (isUnfilledFixedLengthField(prevFbbLfIn) ? 1 : 0);
+	fbbLfIn->fixedLengthUpChain_bytes = prevFbbLfIn->fixedLengthUpChain_bytes;
 }
 
 
-static bool isUnfilledFixedLengthFieldUpChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static void setSize(cxa_linkedField_t *const fbbLfIn, const size_t newSize_bytesIn)
 {
 	cxa_assert(fbbLfIn);
 
-	// check ourselves (if we're not first)
-	if( !isFirstCallIn )
-	{
-		if( fbbLfIn->isFixedLength && (fbbLfIn->currSize_bytes != fbbLfIn->maxFixedLength_bytes) ) return true;
-	}
+	bool wasUnfilled = isUnfilledFixedLengthField(fbbLfIn);
+	size_t oldSize_bytes = fbbLfIn->currSize_bytes;
+	fbbLfIn->currSize_bytes = newSize_bytesIn;
+	bool isUnfilled = isUnfilledFixedLengthField(fbbLfIn);
 
-	// check the previous field
-	if( fbbLfIn->prev != NULL)
+	// only the fields after us are affected
+	for( cxa_linkedField_t* currField = fbbLfIn->next; currField != NULL; currField = currField->next )
 	{
-		if( isUnfilledFixedLengthFieldUpChain(fbbLfIn->prev, false) ) return true;
+		currField->startIndex = (currField->startIndex - oldSize_bytes) + newSize_bytesIn;
+		if( wasUnfilled && !isUnfilled ) currField->numUnfilledFixedFieldsUpChain--;
+		else if( !wasUnfilled && isUnfilled ) currField->numUnfilledFixedFieldsUpChain++;
 	}
-
-	return false;
 }
 
 
-static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn, bool isFirstCallIn)
+static bool isNonEmptyFieldDownChain(cxa_linkedField_t *const fbbLfIn)
 {
 	cxa_assert(fbbLfIn);
 
-	// check ourselves (if we're not first)
-	if( !isFirstCallIn )
-	{
-		if( fbbLfIn->currSize_bytes != 0 ) return true;
-	}
-
-	// check the next field
-	if( fbbLfIn->next != NULL )
-	{
-		if( isNonEmptyFieldDownChain(fbbLfIn->next, false) ) return true;
-	}
-
-	return false;
+	// fields are contiguous, so anything after us pushes the end of the chain past our end
+	cxa_linkedField_t* tail = fbbLfIn->root->tail;
+	return (tail->startIndex + tail->currSize_bytes) > (fbbLfIn->startIndex + fbbLfIn->currSize_bytes);
 }
@@ -0,0 +1,297 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_spscFifo.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <stdint.h>
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+static inline void* getElemAddr(cxa_spscFifo_t *const fifoIn, size_t indexIn);
+static size_t producer_getFree_elems(cxa_spscFifo_t *const fifoIn, size_t insertIndexIn, size_t numDesiredIn);
+static size_t consumer_getAvailable_elems(cxa_spscFifo_t *const fifoIn, size_t removeIndexIn, size_t numDesiredIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_spscFifo_init(cxa_spscFifo_t *const fifoIn, const size_t datatypeSize_bytesIn, void *const bufferLocIn, const size_t bufferMaxSize_bytesIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(datatypeSize_bytesIn > 0);
+	cxa_assert(datatypeSize_bytesIn <= bufferMaxSize_bytesIn);
+	cxa_assert(bufferLocIn);
+
+	size_t maxNumElements = bufferMaxSize_bytesIn / datatypeSize_bytesIn;
+	cxa_assert_msg((maxNumElements & (maxNumElements - 1)) == 0, "numElements must be a power of 2");
+
+	// save our references
+	fifoIn->bufferLoc = bufferLocIn;
+	fifoIn->datatypeSize_bytes = datatypeSize_bytesIn;
+	fifoIn->maxNumElements = maxNumElements;
+	fifoIn->indexMask = maxNumElements - 1;
+
+	// set some reasonable defaults
+	atomic_init(&fifoIn->insertIndex, 0);
+	atomic_init(&fifoIn->removeIndex, 0);
+	fifoIn->prod_cachedRemoveIndex = 0;
+	fifoIn->cons_cachedInsertIndex = 0;
+}
+
+
+void cxa_spscFifo_clear(cxa_spscFifo_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	atomic_store_explicit(&fifoIn->insertIndex, 0, memory_order_relaxed);
+	atomic_store_explicit(&fifoIn->removeIndex, 0, memory_order_relaxed);
+	fifoIn->prod_cachedRemoveIndex = 0;
+	fifoIn->cons_cachedInsertIndex = 0;
+	atomic_thread_fence(memory_order_seq_cst);
+}
+
+
+bool cxa_spscFifo_queue(cxa_spscFifo_t *const fifoIn, void *const elemIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(elemIn);
+
+	// we are the only writer of insertIndex
+	size_t insertIndex = atomic_load_explicit(&fifoIn->insertIndex, memory_order_relaxed);
+	if( producer_getFree_elems(fifoIn, insertIndex, 1) == 0 ) return false;
+
+	memcpy(getElemAddr(fifoIn, insertIndex), elemIn, fifoIn->datatypeSize_bytes);
+
+	// publish (element contents must be visible before the index)
+	atomic_store_explicit(&fifoIn->insertIndex, insertIndex + 1, memory_order_release);
+
+	return true;
+}
+
+
+bool cxa_spscFifo_bulkQueue(cxa_spscFifo_t *const fifoIn, void *const elemsIn, size_t numElemsIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(elemsIn);
+
+	size_t insertIndex = atomic_load_explicit(&fifoIn->insertIndex, memory_order_relaxed);
+	size_t free_elems = producer_getFree_elems(fifoIn, insertIndex, numElemsIn);
+	size_t numToQueue_elems = (numElemsIn <= free_elems) ? numElemsIn : free_elems;
+	if( numToQueue_elems == 0 ) return (numElemsIn == 0);
+
+	// copy in (at most) two spans: up to the end of the buffer, then from the start
+	size_t insertOffset_elems = insertIndex & fifoIn->indexMask;
+	size_t firstSpan_elems = fifoIn->maxNumElements - insertOffset_elems;
+	if( firstSpan_elems > numToQueue_elems ) firstSpan_elems = numToQueue_elems;
+
+	size_t firstSpan_bytes = firstSpan_elems * fifoIn->datatypeSize_bytes;
+	memcpy(getElemAddr(fifoIn, insertIndex), elemsIn, firstSpan_bytes);
+	if( firstSpan_elems < numToQueue_elems )
+	{
+		memcpy(fifoIn->bufferLoc, ((uint8_t*)elemsIn) + firstSpan_bytes, (numToQueue_elems - firstSpan_elems) * fifoIn->datatypeSize_bytes);
+	}
+
+	// publish all elements at once
+	atomic_store_explicit(&fifoIn->insertIndex, insertIndex + numToQueue_elems, memory_order_release);
+
+	return (numToQueue_elems == numElemsIn);
+}
+
+
+size_t cxa_spscFifo_bulkQueue_reserve(cxa_spscFifo_t *const fifoIn, void **const elemsOut)
+{
+	cxa_assert(fifoIn);
+
+	size_t insertIndex = atomic_load_explicit(&fifoIn->insertIndex, memory_order_relaxed);
+	size_t toEndOfBuffer_elems = fifoIn->maxNumElements - (insertIndex & fifoIn->indexMask);
+	size_t free_elems = producer_getFree_elems(fifoIn, insertIndex, toEndOfBuffer_elems);
+
+	if( elemsOut != NULL ) *elemsOut = getElemAddr(fifoIn, insertIndex);
+
+	return (free_elems < toEndOfBuffer_elems) ? free_elems : toEndOfBuffer_elems;
+}
+
+
+bool cxa_spscFifo_bulkQueue_commit(cxa_spscFifo_t *const fifoIn, size_t numElemsIn)
+{
+	cxa_assert(fifoIn);
+
+	size_t insertIndex = atomic_load_explicit(&fifoIn->insertIndex, memory_order_relaxed);
+	if( numElemsIn > producer_getFree_elems(fifoIn, insertIndex, numElemsIn) ) return false;
+
+	atomic_store_explicit(&fifoIn->insertIndex, insertIndex + numElemsIn, memory_order_release);
+
+	return true;
+}
+
+
+bool cxa_spscFifo_peek(cxa_spscFifo_t *const fifoIn, void *elemOut)
+{
+	cxa_assert(fifoIn);
+
+	size_t removeIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_relaxed);
+	if( consumer_getAvailable_elems(fifoIn, removeIndex, 1) == 0 ) return false;
+
+	if( elemOut != NULL ) memcpy(elemOut, getElemAddr(fifoIn, removeIndex), fifoIn->datatypeSize_bytes);
+
+	return true;
+}
+
+
+bool cxa_spscFifo_dequeue(cxa_spscFifo_t *const fifoIn, void *elemOut)
+{
+	cxa_assert(fifoIn);
+
+	// we are the only writer of removeIndex
+	size_t removeIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_relaxed);
+	if( consumer_getAvailable_elems(fifoIn, removeIndex, 1) == 0 ) return false;
+
+	if( elemOut != NULL ) memcpy(elemOut, getElemAddr(fifoIn, removeIndex), fifoIn->datatypeSize_bytes);
+
+	// release the slot (our read must complete before the producer reuses it)
+	atomic_store_explicit(&fifoIn->removeIndex, removeIndex + 1, memory_order_release);
+
+	return true;
+}
+
+
+size_t cxa_spscFifo_bulkDequeue_copy(cxa_spscFifo_t *const fifoIn, void *const elemsOut, size_t maxNumElemsIn)
+{
+	cxa_assert(fifoIn);
+	cxa_assert(elemsOut);
+
+	size_t removeIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_relaxed);
+	size_t avail_elems = consumer_getAvailable_elems(fifoIn, removeIndex, maxNumElemsIn);
+	size_t numToDequeue_elems = (maxNumElemsIn <= avail_elems) ? maxNumElemsIn : avail_elems;
+	if( numToDequeue_elems == 0 ) return 0;
+
+	// copy out (at most) two spans: up to the end of the buffer, then from the start
+	size_t removeOffset_elems = removeIndex & fifoIn->indexMask;
+	size_t firstSpan_elems = fifoIn->maxNumElements - removeOffset_elems;
+	if( firstSpan_elems > numToDequeue_elems ) firstSpan_elems = numToDequeue_elems;
+
+	size_t firstSpan_bytes = firstSpan_elems * fifoIn->datatypeSize_bytes;
+	memcpy(elemsOut, getElemAddr(fifoIn, removeIndex), firstSpan_bytes);
+	if( firstSpan_elems < numToDequeue_elems )
+	{
+		memcpy(((uint8_t*)elemsOut) + firstSpan_bytes, fifoIn->bufferLoc, (numToDequeue_elems - firstSpan_elems) * fifoIn->datatypeSize_bytes);
+	}
+
+	atomic_store_explicit(&fifoIn->removeIndex, removeIndex + numToDequeue_elems, memory_order_release);
+
+	return numToDequeue_elems;
+}
+
+
+size_t cxa_spscFifo_bulkDequeue_peek(cxa_spscFifo_t *const fifoIn, void **const elemsOut)
+{
+	cxa_assert(fifoIn);
+
+	size_t removeIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_relaxed);
+	size_t toEndOfBuffer_elems = fifoIn->maxNumElements - (removeIndex & fifoIn->indexMask);
+	size_t avail_elems = consumer_getAvailable_elems(fifoIn, removeIndex, toEndOfBuffer_elems);
+
+	if( elemsOut != NULL ) *elemsOut = getElemAddr(fifoIn, removeIndex);
+
+	return (avail_elems < toEndOfBuffer_elems) ? avail_elems : toEndOfBuffer_elems;
+}
+
+
+bool cxa_spscFifo_bulkDequeue(cxa_spscFifo_t *const fifoIn, size_t numElemsIn)
+{
+	cxa_assert(fifoIn);
+
+	size_t removeIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_relaxed);
+	size_t avail_elems = consumer_getAvailable_elems(fifoIn, removeIndex, numElemsIn);
+	size_t numToDequeue_elems = (numElemsIn <= avail_elems) ? numElemsIn : avail_elems;
+
+	atomic_store_explicit(&fifoIn->removeIndex, removeIndex + numToDequeue_elems, memory_order_release);
+
+	return (numToDequeue_elems == numElemsIn);
+}
+
+
+size_t cxa_spscFifo_getSize_elems(cxa_spscFifo_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	size_t removeIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_acquire);
+	size_t insertIndex = atomic_load_explicit(&fifoIn->insertIndex, memory_order_acquire);
+
+	return insertIndex - removeIndex;
+}
+
+
+size_t cxa_spscFifo_getFreeSize_elems(cxa_spscFifo_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	return fifoIn->maxNumElements - cxa_spscFifo_getSize_elems(fifoIn);
+}
+
+
+size_t cxa_spscFifo_getMaxSize_elems(cxa_spscFifo_t *const fifoIn)
+{
+	cxa_assert(fifoIn);
+
+	return fifoIn->maxNumElements;
+}
+
+
+bool cxa_spscFifo_isEmpty(cxa_spscFifo_t *const fifoIn)
+{
+	return (cxa_spscFifo_getSize_elems(fifoIn) == 0);
+}
+
+
+bool cxa_spscFifo_isFull(cxa_spscFifo_t *const fifoIn)
+{
+	return (cxa_spscFifo_getFreeSize_elems(fifoIn) == 0);
+}
+
+
+// ******** local function implementations ********
+static inline void* getElemAddr(cxa_spscFifo_t *const fifoIn, size_t indexIn)
+{
+	return (void*)(((uint8_t*)fifoIn->bufferLoc) + ((indexIn & fifoIn->indexMask) * fifoIn->datatypeSize_bytes));
+}
+
+
+static size_t producer_getFree_elems(cxa_spscFifo_t *const fifoIn, size_t insertIndexIn, size_t numDesiredIn)
+{
+	// only touch the consumer's cache line if our cached view isn't sufficient
+	size_t free_elems = fifoIn->maxNumElements - (insertIndexIn - fifoIn->prod_cachedRemoveIndex);
+	if( free_elems < numDesiredIn )
+	{
+		fifoIn->prod_cachedRemoveIndex = atomic_load_explicit(&fifoIn->removeIndex, memory_order_acquire);
+		free_elems = fifoIn->maxNumElements - (insertIndexIn - fifoIn->prod_cachedRemoveIndex);
+	}
+	return free_elems;
+}
+
+
+static size_t consumer_getAvailable_elems(cxa_spscFifo_t *const fifoIn, size_t removeIndexIn, size_t numDesiredIn)
+{
+	// only touch the producer's cache line if our cached view isn't sufficient
+	size_t avail_elems = fifoIn->cons_cachedInsertIndex - removeIndexIn;
+	if( avail_elems < numDesiredIn )
+	{
+		fifoIn->cons_cachedInsertIndex = atomic_load_explicit(&fifoIn->insertIndex, memory_order_acquire);
+		avail_elems = fifoIn->cons_cachedInsertIndex - removeIndexIn;
+	}
+	return avail_elems;
+}
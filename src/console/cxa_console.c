@@ -33,6 +33,8 @@
 
 #define ESCAPE_SEQUENCE_TIMEOUT_MS		500
 
+#define RUNLOOP_TOP_REFRESH_PERIOD_MS	1000
+
 
 // ******** local type definitions ********
 typedef struct
@@ -60,12 +62,17 @@ static void clearBuffer(void);
 
 static void command_clear(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
 static void command_help(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+static void command_runLoopTop(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
+static void cb_runLoopTop_refresh(void* userVarIn);
+#endif
 
 
 // ********  local variable declarations *********
 static cxa_ioStream_t* ioStream = NULL;
 
 static const char* deviceName = NULL;
+static int threadId;
 
 static cxa_array_t commandBuffer;
 static char commandBuffer_raw[CXA_CONSOLE_COMMAND_BUFFER_LEN_BYTES];
@@ -75,8 +82,13 @@ static char commandBufferHistory_raw[CXA_CONSOLE_MAXLEN_COMMAND_HISTORY*CXA_CONS
 static ssize_t cbhScrollbackIndex = -1;
 
 static cxa_array_t commandEntries;
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+static commandEntry_t commandEntries_raw[CXA_CONSOLE_MAXNUM_COMMANDS+3];
+// add one for 'clear', 'help', and 'rl_top' command
+#else
 static commandEntry_t commandEntries_raw[CXA_CONSOLE_MAXNUM_COMMANDS+2];
 // add one for 'clear' and 'help' command
+#endif
 
 static bool isExecutingCommand = false;
 static bool isPaused = false;
@@ -90,6 +102,7 @@ void cxa_console_init(const char* deviceNameIn, cxa_ioStream_t *const ioStreamIn
 	// save our references
 	ioStream = ioStreamIn;
 	deviceName = deviceNameIn;
+	threadId = threadIdIn;
 
 	// setup our arrays
 	cxa_array_initStd(&commandBuffer, commandBuffer_raw);
@@ -99,6 +112,9 @@ void cxa_console_init(const char* deviceNameIn, cxa_ioStream_t *const ioStreamIn
 	// add our basic console commands
 	cxa_console_addCommand("clear", "clears the console", NULL, 0, command_clear, NULL);
 	cxa_console_addCommand("help", "prints available commands", NULL, 0, command_help, NULL);
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+	cxa_console_addCommand("rl_top", "runLoop entry statistics (any key exits)", NULL, 0, command_runLoopTop, NULL);
+#endif
 
 	// register for our runLoop
 	cxa_runLoop_addEntry(threadIdIn, cb_onRunLoopStart, cb_onRunLoopUpdate, NULL);
@@ -476,3 +492,34 @@ static void command_help(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStre
 		}
 	}
 }
+
+
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+static void command_runLoopTop(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn)
+{
+	// pause so keypresses come to us, then start refreshing
+	cxa_runLoop_stats_reset();
+	cxa_console_pause();
+	cxa_runLoop_dispatchAfter(threadId, RUNLOOP_TOP_REFRESH_PERIOD_MS, cb_runLoopTop_refresh, NULL);
+}
+
+
+static void cb_runLoopTop_refresh(void* userVarIn)
+{
+	// any keypress exits
+	uint8_t rxByte;
+	if( cxa_ioStream_readByte(ioStream, &rxByte) == CXA_IOSTREAM_READSTAT_GOTDATA )
+	{
+		cxa_console_resume();
+		return;
+	}
+
+	// each refresh shows the statistics for the previous period only
+	clearScreenReturnHome();
+	cxa_ioStream_writeLine(ioStream, "runLoop top (any key exits)");
+	cxa_runLoop_stats_writeTable(ioStream);
+	cxa_runLoop_stats_reset();
+
+	cxa_runLoop_dispatchAfter(threadId, RUNLOOP_TOP_REFRESH_PERIOD_MS, cb_runLoopTop_refresh, NULL);
+}
+#endif
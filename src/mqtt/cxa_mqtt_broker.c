@@ -0,0 +1,815 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mqtt_broker.h"
+
+
+// ******** includes ********
+#include <string.h>
+
+#include <cxa_assert.h>
+#include <cxa_mqtt_messageFactory.h>
+#include <cxa_mqtt_message_connack.h>
+#include <cxa_mqtt_message_connect.h>
+#include <cxa_mqtt_message_pingResponse.h>
+#include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_message_publishAck.h>
+#include <cxa_mqtt_message_suback.h>
+#include <cxa_mqtt_message_subscribe.h>
+#include <cxa_runLoop.h>
+
+#define CXA_LOG_LEVEL		CXA_LOG_LEVEL_INFO
+#include <cxa_logger_implementation.h>
+
+
+// ******** local macro definitions ********
+#define PROTOCOL_LEVEL_MQTT311					4
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_mqtt_broker_t* broker;
+
+	const char* topicName;
+	uint16_t topicNameLen_bytes;
+	void* payload;
+	size_t payloadLen_bytes;
+
+	// received packet which can be sent to subscribers as-is (NULL if it can't)
+	cxa_fixedByteBuffer_t* forwardPacket;
+
+	// connections stamped with this have already received this publish
+	uint32_t deliverySeq;
+
+	// otherwise, built on the first delivery to a connection
+	cxa_mqtt_message_t* builtMsg;
+	bool didBuildFail;
+
+	size_t numDeliveries;
+}deliveryContext_t;
+
+
+// ******** local function prototypes ********
+static cxa_mqtt_broker_connection_t* attachConnection(cxa_mqtt_broker_t *const brokerIn, cxa_ioStream_t *const ioStreamIn,
+													  cxa_network_tcpServer_connectedClient_t *const tcpClientIn);
+static void closeConnection(cxa_mqtt_broker_connection_t *const connIn, const char *const reasonIn);
+
+static bool addSubscription(cxa_mqtt_broker_t *const brokerIn, cxa_mqtt_broker_connection_t *const connIn,
+							char *const topicFilterIn, size_t topicFilterLen_bytesIn,
+							cxa_mqtt_broker_cb_onPublish_t cb_onPublishIn, void *const userVarIn);
+static void removeSubscriptions(cxa_mqtt_broker_t *const brokerIn, cxa_mqtt_broker_connection_t *const connIn);
+static void purgeRemovedSubscriptions(cxa_mqtt_broker_t *const brokerIn);
+
+static size_t deliverPublish(cxa_mqtt_broker_t *const brokerIn, const char *const topicNameIn, uint16_t topicNameLen_bytesIn,
+							 void *const payloadIn, size_t payloadLen_bytesIn, cxa_fixedByteBuffer_t *const forwardPacketIn);
+static bool sendMessage(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn);
+static bool sendPublishAck(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn);
+static bool sendConnAck(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_connAck_returnCode_t retCodeIn);
+
+static void handleMessage_connect(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn);
+static void handleMessage_subscribe(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn, const cxa_mqtt_message_view_t *const viewIn);
+static void handleMessage_publish(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn, const cxa_mqtt_message_view_t *const viewIn);
+static void handleMessage_pubRel(cxa_mqtt_broker_connection_t *const connIn, const cxa_mqtt_message_view_t *const viewIn);
+static void handleMessage_pingReq(cxa_mqtt_broker_connection_t *const connIn);
+
+static void trieCb_onPublishMatch(uint16_t entryIndexIn, void* userVarIn);
+static void tcpServerCb_onConnect(cxa_network_tcpServer_t *const serverIn, cxa_network_tcpServer_connectedClient_t* clientIn, void* userVarIn);
+static void protoParseCb_onIoException(void *const userVarIn);
+static void protoParseCb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
+static void cb_onRunLoopUpdate_housekeeping(void* userVarIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_mqtt_broker_init(cxa_mqtt_broker_t *const brokerIn, cxa_network_tcpServer_t *const tcpServerIn, int threadIdIn)
+{
+	cxa_assert(brokerIn);
+
+	// save our references / set some defaults
+	brokerIn->tcpServer = tcpServerIn;
+	brokerIn->cb_authenticate = NULL;
+	brokerIn->authenticateUserVar = NULL;
+	brokerIn->currDeliverySeq = 0;
+	brokerIn->deliveryDepth = 0;
+	brokerIn->isRemovalPending = false;
+
+	cxa_logger_init(&brokerIn->logger, "mqttBroker");
+
+	cxa_array_initStd(&brokerIn->subscriptions, brokerIn->subscriptions_raw);
+	cxa_mqtt_topicTrie_initStd(&brokerIn->subscriptionTrie, brokerIn->subscriptionTrie_nodes_raw, brokerIn->subscriptionTrie_entryNext_raw);
+
+	// setup our connection slots (each keeps its parser + receive buffer for the life of the broker)
+	for( size_t i = 0; i < sizeof(brokerIn->connections)/sizeof(*brokerIn->connections); i++ )
+	{
+		cxa_mqtt_broker_connection_t* currConn = &brokerIn->connections[i];
+
+		currConn->broker = brokerIn;
+		currConn->state = CXA_MQTT_BROKER_CONNSTATE_FREE;
+		currConn->tcpClient = NULL;
+		currConn->clientId[0] = 0;
+		currConn->keepAlive_s = 0;
+		currConn->lastDeliverySeq = 0;
+		cxa_timeDiff_init(&currConn->td_lastRx);
+		cxa_array_initStd(&currConn->inboundQos2PacketIds, currConn->inboundQos2PacketIds_raw);
+
+		cxa_ioStream_nullablePassthrough_init(&currConn->ios);
+		currConn->isParserResetPending = false;
+
+		cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_empty();
+		cxa_assert_msg(msg, "increase CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES");
+		cxa_protocolParser_mqtt_init(&currConn->mpp, cxa_ioStream_nullablePassthrough_getNonullStream(&currConn->ios), msg->buffer, threadIdIn);
+		cxa_protocolParser_addProtocolListener(&currConn->mpp.super, protoParseCb_onIoException, NULL, (void*)currConn);
+		cxa_protocolParser_addPacketListener(&currConn->mpp.super, protoParseCb_onPacketReceived, (void*)currConn);
+	}
+
+	// accept connections from our server (if any)
+	if( brokerIn->tcpServer != NULL ) cxa_network_tcpServer_addListener(brokerIn->tcpServer, tcpServerCb_onConnect, (void*)brokerIn);
+
+	cxa_runLoop_addTimedEntry(threadIdIn, CXA_MQTT_BROKER_HOUSEKEEPING_PERIOD_MS, NULL, cb_onRunLoopUpdate_housekeeping, (void*)brokerIn);
+}
+
+
+void cxa_mqtt_broker_setAuthenticationCallback(cxa_mqtt_broker_t *const brokerIn,
+											   cxa_mqtt_broker_cb_authenticateClient_t cb_authenticateIn, void *const userVarIn)
+{
+	cxa_assert(brokerIn);
+
+	brokerIn->cb_authenticate = cb_authenticateIn;
+	brokerIn->authenticateUserVar = userVarIn;
+}
+
+
+bool cxa_mqtt_broker_attachIoStream(cxa_mqtt_broker_t *const brokerIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(ioStreamIn);
+
+	return (attachConnection(brokerIn, ioStreamIn, NULL) != NULL);
+}
+
+
+void cxa_mqtt_broker_detachIoStream(cxa_mqtt_broker_t *const brokerIn, cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(ioStreamIn);
+
+	for( size_t i = 0; i < sizeof(brokerIn->connections)/sizeof(*brokerIn->connections); i++ )
+	{
+		cxa_mqtt_broker_connection_t* currConn = &brokerIn->connections[i];
+		if( (currConn->state != CXA_MQTT_BROKER_CONNSTATE_FREE) &&
+			(cxa_ioStream_nullablePassthrough_getNullableStream(&currConn->ios) == ioStreamIn) )
+		{
+			closeConnection(currConn, "detached");
+		}
+	}
+}
+
+
+bool cxa_mqtt_broker_subscribe(cxa_mqtt_broker_t *const brokerIn, char *const topicFilterIn,
+							   cxa_mqtt_broker_cb_onPublish_t cb_onPublishIn, void *const userVarIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(topicFilterIn);
+	cxa_assert(cb_onPublishIn);
+
+	return addSubscription(brokerIn, NULL, topicFilterIn, strlen(topicFilterIn), cb_onPublishIn, userVarIn);
+}
+
+
+size_t cxa_mqtt_broker_publish(cxa_mqtt_broker_t *const brokerIn, char *const topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(topicNameIn);
+
+	size_t topicNameLen_bytes = strlen(topicNameIn);
+	if( (topicNameLen_bytes == 0) || (topicNameLen_bytes > UINT16_MAX) ) return 0;
+
+	return deliverPublish(brokerIn, topicNameIn, topicNameLen_bytes, payloadIn, payloadLen_bytesIn, NULL);
+}
+
+
+size_t cxa_mqtt_broker_getNumConnectedClients(cxa_mqtt_broker_t *const brokerIn)
+{
+	cxa_assert(brokerIn);
+
+	size_t retVal = 0;
+	for( size_t i = 0; i < sizeof(brokerIn->connections)/sizeof(*brokerIn->connections); i++ )
+	{
+		if( brokerIn->connections[i].state == CXA_MQTT_BROKER_CONNSTATE_CONNECTED ) retVal++;
+	}
+	return retVal;
+}
+
+
+// ******** local function implementations ********
+static cxa_mqtt_broker_connection_t* attachConnection(cxa_mqtt_broker_t *const brokerIn, cxa_ioStream_t *const ioStreamIn,
+													  cxa_network_tcpServer_connectedClient_t *const tcpClientIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(ioStreamIn);
+
+	// find a free slot
+	cxa_mqtt_broker_connection_t* targetConn = NULL;
+	for( size_t i = 0; i < sizeof(brokerIn->connections)/sizeof(*brokerIn->connections); i++ )
+	{
+		if( brokerIn->connections[i].state == CXA_MQTT_BROKER_CONNSTATE_FREE )
+		{
+			targetConn = &brokerIn->connections[i];
+			break;
+		}
+	}
+	if( targetConn == NULL )
+	{
+		cxa_logger_warn(&brokerIn->logger, "no free connections");
+		return NULL;
+	}
+
+	targetConn->state = CXA_MQTT_BROKER_CONNSTATE_AWAITING_CONNECT;
+	targetConn->tcpClient = tcpClientIn;
+	targetConn->clientId[0] = 0;
+	targetConn->keepAlive_s = 0;
+	cxa_timeDiff_setStartTime_now(&targetConn->td_lastRx);
+	cxa_array_clear(&targetConn->inboundQos2PacketIds);
+
+	// discard anything left over from the previous connection (parser may be in error or mid-packet)
+	cxa_ioStream_nullablePassthrough_setNullableStream(&targetConn->ios, ioStreamIn);
+	if( targetConn->isParserResetPending )
+	{
+		cxa_protocolParser_resetError(&targetConn->mpp.super);
+		targetConn->isParserResetPending = false;
+	}
+
+	cxa_logger_debug(&brokerIn->logger, "new connection @ %p", targetConn);
+	return targetConn;
+}
+
+
+static void closeConnection(cxa_mqtt_broker_connection_t *const connIn, const char *const reasonIn)
+{
+	cxa_assert(connIn);
+
+	if( connIn->state == CXA_MQTT_BROKER_CONNSTATE_FREE ) return;
+
+	cxa_logger_info(&connIn->broker->logger, "closing connection '%s': %s", connIn->clientId, reasonIn);
+
+	removeSubscriptions(connIn->broker, connIn);
+
+	cxa_ioStream_nullablePassthrough_setNullableStream(&connIn->ios, NULL);
+	connIn->isParserResetPending = true;
+	if( (connIn->tcpClient != NULL) && cxa_network_tcpServer_connectedClient_isBound(connIn->tcpClient) )
+	{
+		cxa_network_tcpServer_connectedClient_unbindAndClose(connIn->tcpClient);
+	}
+	connIn->tcpClient = NULL;
+
+	connIn->state = CXA_MQTT_BROKER_CONNSTATE_FREE;
+}
+
+
+static bool addSubscription(cxa_mqtt_broker_t *const brokerIn, cxa_mqtt_broker_connection_t *const connIn,
+							char *const topicFilterIn, size_t topicFilterLen_bytesIn,
+							cxa_mqtt_broker_cb_onPublish_t cb_onPublishIn, void *const userVarIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(topicFilterIn);
+
+	if( (topicFilterLen_bytesIn == 0) || (topicFilterLen_bytesIn > CXA_MQTT_BROKER_MAXLEN_TOPICFILTER_BYTES) ||
+		(memchr(topicFilterIn, 0, topicFilterLen_bytesIn) != NULL) ) return false;
+
+	// everything is delivered at QoS0, so a repeated subscription from the same
+	// connection is already satisfied by the existing one
+	cxa_array_iterate(&brokerIn->subscriptions, currSub, cxa_mqtt_broker_subscription_t)
+	{
+		if( (currSub == NULL) || currSub->isRemoved ) continue;
+
+		if( (currSub->connection == connIn) && (connIn != NULL) &&
+			(strlen(currSub->topicFilter) == topicFilterLen_bytesIn) &&
+			(memcmp(currSub->topicFilter, topicFilterIn, topicFilterLen_bytesIn) == 0) ) return true;
+	}
+
+	cxa_mqtt_broker_subscription_t* newSub = (cxa_mqtt_broker_subscription_t*)cxa_array_append_empty(&brokerIn->subscriptions);
+	if( newSub == NULL )
+	{
+		cxa_logger_warn(&brokerIn->logger, "too many subscriptions");
+		return false;
+	}
+	newSub->connection = connIn;
+	memcpy(newSub->topicFilter, topicFilterIn, topicFilterLen_bytesIn);
+	newSub->topicFilter[topicFilterLen_bytesIn] = 0;
+	newSub->cb_onPublish = cb_onPublishIn;
+	newSub->userVar = userVarIn;
+	newSub->isRemoved = false;
+
+	// our trie is sized for CXA_MQTT_BROKER_MAXNUM_TOPICFILTER_LEVELS, so a filter that passes here will fit
+	size_t newSubIndex = cxa_array_getSize_elems(&brokerIn->subscriptions) - 1;
+	size_t numLevels;
+	if( !cxa_mqtt_topicTrie_validateFilter(newSub->topicFilter, &numLevels) || (numLevels > CXA_MQTT_BROKER_MAXNUM_TOPICFILTER_LEVELS) )
+	{
+		cxa_logger_warn(&brokerIn->logger, "bad topic filter: '%s'", newSub->topicFilter);
+		cxa_array_remove_atIndex(&brokerIn->subscriptions, newSubIndex);
+		return false;
+	}
+	if( !cxa_mqtt_topicTrie_insert(&brokerIn->subscriptionTrie, newSub->topicFilter, newSubIndex) )
+	{
+		cxa_logger_warn(&brokerIn->logger, "topic trie full: '%s'", newSub->topicFilter);
+		cxa_array_remove_atIndex(&brokerIn->subscriptions, newSubIndex);
+		return false;
+	}
+
+	cxa_logger_debug(&brokerIn->logger, "'%s' subscribed to '%s'", (connIn != NULL) ? connIn->clientId : "<local>", newSub->topicFilter);
+	return true;
+}
+
+
+static void removeSubscriptions(cxa_mqtt_broker_t *const brokerIn, cxa_mqtt_broker_connection_t *const connIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(connIn);
+
+	bool didRemove = false;
+	cxa_array_iterate(&brokerIn->subscriptions, currSub, cxa_mqtt_broker_subscription_t)
+	{
+		if( (currSub != NULL) && (currSub->connection == connIn) )
+		{
+			currSub->isRemoved = true;
+			didRemove = true;
+		}
+	}
+	if( !didRemove ) return;
+
+	// removing shifts subscription indices (and rebuilds the trie)...wait until we're done matching
+	if( brokerIn->deliveryDepth > 0 )
+	{
+		brokerIn->isRemovalPending = true;
+		return;
+	}
+	purgeRemovedSubscriptions(brokerIn);
+}
+
+
+static void purgeRemovedSubscriptions(cxa_mqtt_broker_t *const brokerIn)
+{
+	cxa_assert(brokerIn);
+
+	brokerIn->isRemovalPending = false;
+	for( size_t i = cxa_array_getSize_elems(&brokerIn->subscriptions); i > 0; i-- )
+	{
+		cxa_mqtt_broker_subscription_t* currSub = (cxa_mqtt_broker_subscription_t*)cxa_array_get(&brokerIn->subscriptions, i-1);
+		if( (currSub != NULL) && currSub->isRemoved ) cxa_array_remove_atIndex(&brokerIn->subscriptions, i-1);
+	}
+
+	// trie doesn't support removal (and our indices / filter pointers shifted)...rebuild it
+	cxa_mqtt_topicTrie_clear(&brokerIn->subscriptionTrie);
+	for( size_t i = 0; i < cxa_array_getSize_elems(&brokerIn->subscriptions); i++ )
+	{
+		cxa_mqtt_broker_subscription_t* currSub = (cxa_mqtt_broker_subscription_t*)cxa_array_get(&brokerIn->subscriptions, i);
+		cxa_assert(currSub);
+
+		// each of these was inserted before, so they must still fit
+		cxa_assert( cxa_mqtt_topicTrie_insert(&brokerIn->subscriptionTrie, currSub->topicFilter, i) );
+	}
+}
+
+
+static size_t deliverPublish(cxa_mqtt_broker_t *const brokerIn, const char *const topicNameIn, uint16_t topicNameLen_bytesIn,
+							 void *const payloadIn, size_t payloadLen_bytesIn, cxa_fixedByteBuffer_t *const forwardPacketIn)
+{
+	cxa_assert(brokerIn);
+	cxa_assert(topicNameIn);
+
+	// a publish from within a local subscriber's callback (nested delivery) must
+	// leave the stamps of the outer delivery intact when it returns
+	uint32_t outerDeliverySeqs[CXA_MQTT_BROKER_MAXNUM_CONNECTIONS];
+	bool isNested = (brokerIn->deliveryDepth > 0);
+	if( isNested )
+	{
+		for( size_t i = 0; i < CXA_MQTT_BROKER_MAXNUM_CONNECTIONS; i++ ) outerDeliverySeqs[i] = brokerIn->connections[i].lastDeliverySeq;
+	}
+
+	// lets connections with overlapping subscriptions receive this publish only once
+	if( ++brokerIn->currDeliverySeq == 0 ) brokerIn->currDeliverySeq = 1;
+
+	deliveryContext_t ctx;
+	ctx.deliverySeq = brokerIn->currDeliverySeq;
+	ctx.broker = brokerIn;
+	ctx.topicName = topicNameIn;
+	ctx.topicNameLen_bytes = topicNameLen_bytesIn;
+	ctx.payload = payloadIn;
+	ctx.payloadLen_bytes = payloadLen_bytesIn;
+	ctx.forwardPacket = forwardPacketIn;
+	ctx.builtMsg = NULL;
+	ctx.didBuildFail = false;
+	ctx.numDeliveries = 0;
+
+	// local subscribers may publish (or close connections) from within their callbacks
+	brokerIn->deliveryDepth++;
+	cxa_mqtt_topicTrie_match(&brokerIn->subscriptionTrie, topicNameIn, topicNameLen_bytesIn, trieCb_onPublishMatch, (void*)&ctx);
+	brokerIn->deliveryDepth--;
+	if( (brokerIn->deliveryDepth == 0) && brokerIn->isRemovalPending ) purgeRemovedSubscriptions(brokerIn);
+
+	if( isNested )
+	{
+		for( size_t i = 0; i < CXA_MQTT_BROKER_MAXNUM_CONNECTIONS; i++ ) brokerIn->connections[i].lastDeliverySeq = outerDeliverySeqs[i];
+	}
+
+	if( ctx.builtMsg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(ctx.builtMsg);
+	return ctx.numDeliveries;
+}
+
+
+static bool sendMessage(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(connIn);
+
+	bool retVal = (msgIn != NULL) && cxa_protocolParser_writePacket(&connIn->mpp.super, cxa_mqtt_message_getBuffer(msgIn));
+	if( msgIn != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msgIn);
+
+	return retVal;
+}
+
+
+static bool sendPublishAck(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn)
+{
+	cxa_assert(connIn);
+
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_PUBLISHACK_MAXSIZE_BYTES);
+	if( (msg != NULL) && !cxa_mqtt_message_publishAck_init(msg, typeIn, packetIdIn) )
+	{
+		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		msg = NULL;
+	}
+
+	return sendMessage(connIn, msg);
+}
+
+
+static bool sendConnAck(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_connAck_returnCode_t retCodeIn)
+{
+	cxa_assert(connIn);
+
+	// we never keep sessions
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_CONNACK_MAXSIZE_BYTES);
+	if( (msg != NULL) && !cxa_mqtt_message_connack_init(msg, false, retCodeIn) )
+	{
+		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		msg = NULL;
+	}
+
+	return sendMessage(connIn, msg);
+}
+
+
+static void handleMessage_connect(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(connIn);
+	cxa_assert(msgIn);
+
+	cxa_mqtt_broker_t* brokerIn = connIn->broker;
+
+	// a second CONNECT is a protocol violation
+	if( connIn->state != CXA_MQTT_BROKER_CONNSTATE_AWAITING_CONNECT )
+	{
+		closeConnection(connIn, "duplicate CONNECT");
+		return;
+	}
+
+	uint8_t protocolLevel;
+	if( !cxa_mqtt_message_connect_getProtocolLevel(msgIn, &protocolLevel) || (protocolLevel != PROTOCOL_LEVEL_MQTT311) )
+	{
+		sendConnAck(connIn, CXA_MQTT_CONNACK_RETCODE_REFUSED_PROTO);
+		closeConnection(connIn, "unsupported protocol level");
+		return;
+	}
+
+	char* clientId;
+	uint16_t clientIdLen_bytes;
+	if( !cxa_mqtt_message_connect_getClientId(msgIn, &clientId, &clientIdLen_bytes) || (clientIdLen_bytes > CXA_MQTT_BROKER_MAXLEN_CLIENTID_BYTES) )
+	{
+		sendConnAck(connIn, CXA_MQTT_CONNACK_RETCODE_REFUSED_CID);
+		closeConnection(connIn, "bad clientId");
+		return;
+	}
+
+	// authenticate (if desired)
+	if( brokerIn->cb_authenticate != NULL )
+	{
+		char* username = NULL;
+		uint16_t usernameLen_bytes = 0;
+		uint8_t* password = NULL;
+		uint16_t passwordLen_bytes = 0;
+		if( !cxa_mqtt_message_connect_getUsername(msgIn, &username, &usernameLen_bytes) ) { username = NULL; usernameLen_bytes = 0; }
+		if( !cxa_mqtt_message_connect_getPassword(msgIn, &password, &passwordLen_bytes) ) { password = NULL; passwordLen_bytes = 0; }
+
+		if( !brokerIn->cb_authenticate(clientId, clientIdLen_bytes, username, usernameLen_bytes, password, passwordLen_bytes, brokerIn->authenticateUserVar) )
+		{
+			sendConnAck(connIn, CXA_MQTT_CONNACK_RETCODE_REFUSED_BADUSERNAMEPASSWORD);
+			closeConnection(connIn, "authentication failed");
+			return;
+		}
+	}
+
+	memcpy(connIn->clientId, clientId, clientIdLen_bytes);
+	connIn->clientId[clientIdLen_bytes] = 0;
+	if( !cxa_mqtt_message_connect_getKeepAlive_s(msgIn, &connIn->keepAlive_s) ) connIn->keepAlive_s = 0;
+
+	// per spec, an existing connection with the same clientId is disconnected
+	if( clientIdLen_bytes > 0 )
+	{
+		for( size_t i = 0; i < sizeof(brokerIn->connections)/sizeof(*brokerIn->connections); i++ )
+		{
+			cxa_mqtt_broker_connection_t* currConn = &brokerIn->connections[i];
+			if( (currConn != connIn) && (currConn->state == CXA_MQTT_BROKER_CONNSTATE_CONNECTED) &&
+				(strcmp(currConn->clientId, connIn->clientId) == 0) )
+			{
+				closeConnection(currConn, "taken over by new connection");
+			}
+		}
+	}
+
+	if( !sendConnAck(connIn, CXA_MQTT_CONNACK_RETCODE_ACCEPTED) )
+	{
+		closeConnection(connIn, "failed to send CONNACK");
+		return;
+	}
+	connIn->state = CXA_MQTT_BROKER_CONNSTATE_CONNECTED;
+	cxa_logger_info(&brokerIn->logger, "'%s' connected (keepalive %ds)", connIn->clientId, connIn->keepAlive_s);
+}
+
+
+static void handleMessage_subscribe(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn, const cxa_mqtt_message_view_t *const viewIn)
+{
+	cxa_assert(connIn);
+	cxa_assert(msgIn);
+	cxa_assert(viewIn);
+
+	// one return code per topic filter (and a connection can't hold more subscriptions than this anyways)
+	cxa_mqtt_subAck_returnCode_t returnCodes[CXA_MQTT_BROKER_MAXNUM_SUBSCRIPTIONS];
+	if( viewIn->asSubscribe.numTopicFilters > (sizeof(returnCodes)/sizeof(*returnCodes)) )
+	{
+		closeConnection(connIn, "too many topic filters");
+		return;
+	}
+
+	size_t numReturnCodes = 0;
+	char* topicFilter;
+	uint16_t topicFilterLen_bytes;
+	size_t currIndex = 0;
+	while( cxa_mqtt_message_subscribe_getTopicFilter(msgIn, currIndex, &topicFilter, &topicFilterLen_bytes, NULL, &currIndex) )
+	{
+		// all deliveries are QoS0
+		returnCodes[numReturnCodes++] = addSubscription(connIn->broker, connIn, topicFilter, topicFilterLen_bytes, NULL, NULL) ?
+										CXA_MQTT_SUBACK_RETCODE_SUCCESS_MAXQOS0 : CXA_MQTT_SUBACK_RETCODE_FAILURE;
+	}
+
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_SUBACK_MAXSIZE_BYTES(numReturnCodes));
+	if( (msg != NULL) && !cxa_mqtt_message_suback_init(msg, viewIn->asSubscribe.packetId, returnCodes, numReturnCodes) )
+	{
+		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		msg = NULL;
+	}
+	if( !sendMessage(connIn, msg) ) cxa_logger_warn(&connIn->broker->logger, "failed to send SUBACK to '%s'", connIn->clientId);
+}
+
+
+static void handleMessage_publish(cxa_mqtt_broker_connection_t *const connIn, cxa_mqtt_message_t *const msgIn, const cxa_mqtt_message_view_t *const viewIn)
+{
+	cxa_assert(connIn);
+	cxa_assert(msgIn);
+	cxa_assert(viewIn);
+
+	// topic names can't contain wildcards
+	if( (viewIn->asPublish.topicNameLen_bytes == 0) ||
+		(memchr(viewIn->asPublish.topicName, '+', viewIn->asPublish.topicNameLen_bytes) != NULL) ||
+		(memchr(viewIn->asPublish.topicName, '#', viewIn->asPublish.topicNameLen_bytes) != NULL) )
+	{
+		closeConnection(connIn, "bad topic name");
+		return;
+	}
+
+	// QoS2 publishes are delivered when first received, retransmissions are dropped until the PUBREL
+	bool isDuplicate = false;
+	if( viewIn->asPublish.qos == CXA_MQTT_QOS_EXACTLY_ONCE )
+	{
+		cxa_array_iterate(&connIn->inboundQos2PacketIds, currPacketId, uint16_t)
+		{
+			if( (currPacketId != NULL) && (*currPacketId == viewIn->asPublish.packetId) ) { isDuplicate = true; break; }
+		}
+
+		if( !isDuplicate && !cxa_array_append(&connIn->inboundQos2PacketIds, (void*)&viewIn->asPublish.packetId) )
+		{
+			cxa_logger_warn(&connIn->broker->logger, "too many inbound QoS2, duplicates may be delivered");
+		}
+	}
+
+	// a plain QoS0 (non-retained) publish is exactly what we send to subscribers
+	if( !isDuplicate )
+	{
+		bool canForward = (viewIn->asPublish.qos == CXA_MQTT_QOS_ATMOST_ONCE) && !viewIn->asPublish.isRetain;
+		deliverPublish(connIn->broker, viewIn->asPublish.topicName, viewIn->asPublish.topicNameLen_bytes,
+					   viewIn->asPublish.payload, viewIn->asPublish.payloadSize_bytes,
+					   canForward ? cxa_mqtt_message_getBuffer(msgIn) : NULL);
+	}
+
+	// the publisher may have been closed during delivery
+	if( connIn->state != CXA_MQTT_BROKER_CONNSTATE_CONNECTED ) return;
+
+	if( viewIn->asPublish.qos == CXA_MQTT_QOS_ATLEAST_ONCE ) sendPublishAck(connIn, CXA_MQTT_MSGTYPE_PUBACK, viewIn->asPublish.packetId);
+	else if( viewIn->asPublish.qos == CXA_MQTT_QOS_EXACTLY_ONCE ) sendPublishAck(connIn, CXA_MQTT_MSGTYPE_PUBREC, viewIn->asPublish.packetId);
+}
+
+
+static void handleMessage_pubRel(cxa_mqtt_broker_connection_t *const connIn, const cxa_mqtt_message_view_t *const viewIn)
+{
+	cxa_assert(connIn);
+	cxa_assert(viewIn);
+
+	uint16_t* inboundPacketId = NULL;
+	cxa_array_iterate(&connIn->inboundQos2PacketIds, currPacketId, uint16_t)
+	{
+		if( (currPacketId != NULL) && (*currPacketId == viewIn->asPublishAck.packetId) ) { inboundPacketId = currPacketId; break; }
+	}
+	if( inboundPacketId != NULL ) cxa_array_remove(&connIn->inboundQos2PacketIds, inboundPacketId);
+
+	// always complete (the PUBREL may be a retransmission)
+	sendPublishAck(connIn, CXA_MQTT_MSGTYPE_PUBCOMP, viewIn->asPublishAck.packetId);
+}
+
+
+static void handleMessage_pingReq(cxa_mqtt_broker_connection_t *const connIn)
+{
+	cxa_assert(connIn);
+
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES);
+	if( (msg != NULL) && !cxa_mqtt_message_pingResponse_init(msg) )
+	{
+		cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		msg = NULL;
+	}
+	sendMessage(connIn, msg);
+}
+
+
+static void trieCb_onPublishMatch(uint16_t entryIndexIn, void* userVarIn)
+{
+	deliveryContext_t* ctx = (deliveryContext_t*)userVarIn;
+	cxa_assert(ctx);
+
+	cxa_mqtt_broker_subscription_t* sub = (cxa_mqtt_broker_subscription_t*)cxa_array_get(&ctx->broker->subscriptions, entryIndexIn);
+	if( (sub == NULL) || sub->isRemoved ) return;
+
+	// local subscription
+	if( sub->connection == NULL )
+	{
+		if( sub->cb_onPublish != NULL ) sub->cb_onPublish((char*)ctx->topicName, ctx->topicNameLen_bytes, ctx->payload, ctx->payloadLen_bytes, sub->userVar);
+		ctx->numDeliveries++;
+		return;
+	}
+
+	// remote subscription (once per connection)
+	cxa_mqtt_broker_connection_t* conn = sub->connection;
+	if( (conn->state != CXA_MQTT_BROKER_CONNSTATE_CONNECTED) || (conn->lastDeliverySeq == ctx->deliverySeq) ) return;
+	conn->lastDeliverySeq = ctx->deliverySeq;
+
+	if( ctx->forwardPacket != NULL )
+	{
+		if( cxa_ioStream_writeFixedByteBuffer(conn->mpp.super.ioStream, ctx->forwardPacket) ) ctx->numDeliveries++;
+		return;
+	}
+
+	// otherwise we need our own (QoS0) PUBLISH...only build it once
+	if( (ctx->builtMsg == NULL) && !ctx->didBuildFail )
+	{
+		char topicName[CXA_MQTT_BROKER_MAXLEN_TOPICNAME_BYTES+1];
+		if( (ctx->topicNameLen_bytes <= CXA_MQTT_BROKER_MAXLEN_TOPICNAME_BYTES) && (ctx->payloadLen_bytes <= UINT16_MAX) )
+		{
+			memcpy(topicName, ctx->topicName, ctx->topicNameLen_bytes);
+			topicName[ctx->topicNameLen_bytes] = 0;
+
+			ctx->builtMsg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_PUBLISH_MAXSIZE_BYTES(ctx->topicNameLen_bytes, ctx->payloadLen_bytes));
+			if( (ctx->builtMsg != NULL) &&
+				!cxa_mqtt_message_publish_init(ctx->builtMsg, false, CXA_MQTT_QOS_ATMOST_ONCE, false, topicName, 0, ctx->payload, ctx->payloadLen_bytes) )
+			{
+				cxa_mqtt_messageFactory_decrementMessageRefCount(ctx->builtMsg);
+				ctx->builtMsg = NULL;
+			}
+		}
+
+		if( ctx->builtMsg == NULL )
+		{
+			cxa_logger_warn(&ctx->broker->logger, "failed to build PUBLISH for delivery, dropped");
+			ctx->didBuildFail = true;
+		}
+	}
+	if( ctx->builtMsg == NULL ) return;
+
+	if( cxa_protocolParser_writePacket(&conn->mpp.super, cxa_mqtt_message_getBuffer(ctx->builtMsg)) ) ctx->numDeliveries++;
+}
+
+
+static void tcpServerCb_onConnect(cxa_network_tcpServer_t *const serverIn, cxa_network_tcpServer_connectedClient_t* clientIn, void* userVarIn)
+{
+	cxa_mqtt_broker_t* brokerIn = (cxa_mqtt_broker_t*)userVarIn;
+	cxa_assert(brokerIn);
+	cxa_assert(clientIn);
+
+	if( attachConnection(brokerIn, cxa_network_tcpServer_connectedClient_getIoStream(clientIn), clientIn) == NULL )
+	{
+		cxa_network_tcpServer_connectedClient_unbindAndClose(clientIn);
+	}
+}
+
+
+static void protoParseCb_onIoException(void *const userVarIn)
+{
+	cxa_mqtt_broker_connection_t* connIn = (cxa_mqtt_broker_connection_t*)userVarIn;
+	cxa_assert(connIn);
+
+	closeConnection(connIn, "ioException");
+}
+
+
+static void protoParseCb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn)
+{
+	cxa_mqtt_broker_connection_t* connIn = (cxa_mqtt_broker_connection_t*)userVarIn;
+	cxa_assert(connIn);
+
+	if( connIn->state == CXA_MQTT_BROKER_CONNSTATE_FREE ) return;
+
+	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getMessage_byBuffer(packetIn);
+	if( msg == NULL ) return;
+
+	// received messages were already decoded into a flat view during validation
+	const cxa_mqtt_message_view_t* view = cxa_mqtt_message_getView(msg);
+	if( view == NULL ) return;
+
+	cxa_timeDiff_setStartTime_now(&connIn->td_lastRx);
+
+	// the first packet must be a CONNECT
+	if( (view->type != CXA_MQTT_MSGTYPE_CONNECT) && (connIn->state != CXA_MQTT_BROKER_CONNSTATE_CONNECTED) )
+	{
+		closeConnection(connIn, "expected CONNECT");
+		return;
+	}
+
+	switch( view->type )
+	{
+		case CXA_MQTT_MSGTYPE_CONNECT:
+			handleMessage_connect(connIn, msg);
+			break;
+
+		case CXA_MQTT_MSGTYPE_SUBSCRIBE:
+			handleMessage_subscribe(connIn, msg, view);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBLISH:
+			handleMessage_publish(connIn, msg, view);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREL:
+			handleMessage_pubRel(connIn, view);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PINGREQ:
+			handleMessage_pingReq(connIn);
+			break;
+
+		default:
+			// we never send QoS1/2 publishes, so there's nothing to acknowledge
+			cxa_logger_trace(&connIn->broker->logger, "got unhandled msgType: %d", view->type);
+			break;
+	}
+}
+
+
+static void cb_onRunLoopUpdate_housekeeping(void* userVarIn)
+{
+	cxa_mqtt_broker_t* brokerIn = (cxa_mqtt_broker_t*)userVarIn;
+	cxa_assert(brokerIn);
+
+	for( size_t i = 0; i < sizeof(brokerIn->connections)/sizeof(*brokerIn->connections); i++ )
+	{
+		cxa_mqtt_broker_connection_t* currConn = &brokerIn->connections[i];
+		if( currConn->state == CXA_MQTT_BROKER_CONNSTATE_FREE ) continue;
+
+		if( (currConn->tcpClient != NULL) && !cxa_network_tcpServer_connectedClient_isBound(currConn->tcpClient) )
+		{
+			closeConnection(currConn, "socket closed");
+		}
+		else if( (currConn->state == CXA_MQTT_BROKER_CONNSTATE_AWAITING_CONNECT) &&
+				 cxa_timeDiff_isElapsed_ms(&currConn->td_lastRx, CXA_MQTT_BROKER_CONNECT_TIMEOUT_MS) )
+		{
+			closeConnection(currConn, "CONNECT timeout");
+		}
+		else if( (currConn->state == CXA_MQTT_BROKER_CONNSTATE_CONNECTED) && (currConn->keepAlive_s != 0) &&
+				 cxa_timeDiff_isElapsed_ms(&currConn->td_lastRx, ((uint32_t)currConn->keepAlive_s * 1500)) )
+		{
+			closeConnection(currConn, "keepalive timeout");
+		}
+	}
+}
@@ -17,6 +17,8 @@
 #include <cxa_mqtt_message_subscribe.h>
 #include <cxa_mqtt_message_suback.h>
 #include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_message_publishAck.h>
+#include <cxa_runLoop.h>
 #include <cxa_stringUtils.h>
 
 #define CXA_LOG_LEVEL		CXA_LOG_LEVEL_INFO
@@ -28,8 +30,6 @@
 #define CXA_MQTT_CONNACK_TIMEOUT_MS				5000
 #endif
 
-#define SUBACK_TIMEOUT_MS				5000
-
 
 // ******** local type definitions ********
 typedef enum
@@ -41,6 +41,24 @@ typedef enum
 }state_t;
 
 
+typedef struct
+{
+	cxa_mqtt_client_t* client;
+	cxa_mqtt_message_t* msg;
+	const cxa_mqtt_message_view_t* view;
+}publishDispatchContext_t;
+
+
+typedef struct
+{
+	cxa_mqtt_client_t* client;
+	char* topicName;
+	size_t topicNameLen_bytes;
+	size_t payloadLen_bytes;
+	size_t numActive;
+}streamDispatchContext_t;
+
+
 // ******** local function prototypes ********
 static void stateCb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void stateCb_connecting_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
@@ -50,13 +68,44 @@ static void stateCb_connected_state(cxa_stateMachine_t *const smIn, void *userVa
 
 static void protoParseCb_onIoException(void *const userVarIn);
 static void protoParseCb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn, void *const userVarIn);
+static bool protoParseCb_onStreamBegin(cxa_mqtt_qosLevel_t qosIn, uint16_t packetIdIn,
+									   char *const topicNameIn, size_t topicNameLen_bytesIn,
+									   size_t payloadLen_bytesIn, void *const userVarIn);
+static void protoParseCb_onStreamData(uint8_t *const dataIn, size_t dataLen_bytesIn, void *const userVarIn);
+static void protoParseCb_onStreamEnd(bool wasSuccessfulIn, void *const userVarIn);
+
+static void handleMessage_connAck(cxa_mqtt_client_t *const clientIn, const cxa_mqtt_message_view_t *const viewIn);
+static void handleMessage_pingResp(cxa_mqtt_client_t *const clientIn);
+static void handleMessage_subAck(cxa_mqtt_client_t *const clientIn, const cxa_mqtt_message_view_t *const viewIn);
+static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn, const cxa_mqtt_message_view_t *const viewIn);
+static void handleMessage_publishAck(cxa_mqtt_client_t *const clientIn, const cxa_mqtt_message_view_t *const viewIn);
+
+static uint16_t getNextPacketId(cxa_mqtt_client_t *const clientIn);
+static cxa_mqtt_client_inflightEntry_t* getInflightEntry_byPacketId(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn);
+static uint16_t* getInboundQos2PacketId(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn);
+static bool sendInflight(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inflightEntry_t *const entryIn, bool isRetransmitIn);
+static void completeInflight(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inflightEntry_t *const entryIn);
+static bool sendPublishAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn);
+static void acknowledgePublish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, uint16_t packetIdIn, bool isDuplicateIn);
+
+static bool publishMessage(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+						   void *const extPayloadIn, size_t extPayloadLen_bytesIn,
+						   cxa_mqtt_client_cb_onPublishComplete_t cb_onCompleteIn,
+						   cxa_mqtt_client_cb_onPayloadReleased_t cb_onPayloadReleasedIn, void* userVarIn);
+static void releaseExtPayload(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inflightEntry_t *const entryIn);
+static bool isResubscribeNeeded(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_subscriptionEntry_t *const subIn);
+static void sendSubscribeBatch(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn, uint16_t numTopicFiltersIn);
+static bool addSubscription(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_subscriptionEntry_t *const newEntryIn, char *const topicFilterIn);
+
+static bool writePacket(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
+static bool writePacket_withPayload(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn, void *const payloadIn, size_t payloadLen_bytesIn);
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+static void txCoalesce_flushIfDue(cxa_mqtt_client_t *const clientIn);
+#endif
 
-static void handleMessage_connAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
-static void handleMessage_pingResp(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
-static void handleMessage_subAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
-static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn);
-
-static bool doesTopicMatchFilter(char* topicIn, char* filterIn);
+static void trieCb_onPublishMatch(uint16_t entryIndexIn, void* userVarIn);
+static void trieCb_onStreamMatch(uint16_t entryIndexIn, void* userVarIn);
 static void notify_activity(cxa_mqtt_client_t *const clientIn);
 
 
@@ -77,6 +126,7 @@ void cxa_mqtt_client_init(cxa_mqtt_client_t *const clientIn, cxa_ioStream_t *con
 	// setup some initial values
 	clientIn->keepAliveTimeout_s = keepAliveTimeout_sIn;
 	clientIn->scm_onDisconnect = NULL;
+	clientIn->currPacketId = 0;
 	cxa_timeDiff_init(&clientIn->td_timeout);
 	cxa_timeDiff_init(&clientIn->td_sendKeepAlive);
 	cxa_timeDiff_init(&clientIn->td_receiveKeepAlive);
@@ -89,6 +139,7 @@ void cxa_mqtt_client_init(cxa_mqtt_client_t *const clientIn, cxa_ioStream_t *con
 	cxa_protocolParser_mqtt_init(&clientIn->mpp, iosIn, msg->buffer, threadIdIn);
 	cxa_protocolParser_addProtocolListener(&clientIn->mpp.super, protoParseCb_onIoException, NULL, (void*)clientIn);
 	cxa_protocolParser_addPacketListener(&clientIn->mpp.super, protoParseCb_onPacketReceived, (void*)clientIn);
+	cxa_protocolParser_mqtt_setStreamHandler(&clientIn->mpp, protoParseCb_onStreamBegin, protoParseCb_onStreamData, protoParseCb_onStreamEnd, (void*)clientIn);
 
 	// setup our logger
 	cxa_logger_init(&clientIn->logger, "mqttC");
@@ -96,8 +147,28 @@ void cxa_mqtt_client_init(cxa_mqtt_client_t *const clientIn, cxa_ioStream_t *con
 	// setup our listeners array
 	cxa_array_initStd(&clientIn->listeners, clientIn->listeners_raw);
 
-	// setup our subscriptions array
+	// setup our subscriptions array (and the trie used to dispatch to them)
 	cxa_array_initStd(&clientIn->subscriptions, clientIn->subscriptions_raw);
+	cxa_mqtt_topicTrie_initStd(&clientIn->subscriptionTrie, clientIn->subscriptionTrie_nodes_raw, clientIn->subscriptionTrie_entryNext_raw);
+
+	// setup our QoS1/QoS2 tracking
+	cxa_array_initStd(&clientIn->inflight, clientIn->inflight_raw);
+	cxa_array_initStd(&clientIn->inboundQos2PacketIds, clientIn->inboundQos2PacketIds_raw);
+
+	// clean sessions unless told otherwise
+	clientIn->isCleanSession = true;
+	clientIn->isSessionPresent = false;
+	clientIn->inboundStream.qos = CXA_MQTT_QOS_ATMOST_ONCE;
+	clientIn->inboundStream.packetId = 0;
+	clientIn->inboundStream.isDuplicate = false;
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+	// setup our (initially disabled) outgoing buffer
+	clientIn->txCoalesce.isEnabled = false;
+	clientIn->txCoalesce.maxLatency_ms = 0;
+	cxa_timeDiff_init(&clientIn->txCoalesce.td_firstQueued);
+	cxa_fixedByteBuffer_initStd(&clientIn->txCoalesce.fbb, clientIn->txCoalesce.fbb_raw);
+#endif
 
 	// setup our will
 	clientIn->will.topic[0] = 0;
@@ -162,6 +233,14 @@ void cxa_mqtt_client_addListener(cxa_mqtt_client_t *const clientIn,
 }
 
 
+void cxa_mqtt_client_setCleanSession(cxa_mqtt_client_t *const clientIn, bool cleanSessionIn)
+{
+	cxa_assert(clientIn);
+
+	clientIn->isCleanSession = cleanSessionIn;
+}
+
+
 bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const usernameIn, uint8_t *const passwordIn, uint16_t passwordLen_bytesIn)
 {
 	cxa_assert(clientIn);
@@ -173,12 +252,14 @@ bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const user
 	cxa_logger_trace(&clientIn->logger, "sending CONNECT packet");
 
 	// reserve/initialize/send message
+	size_t msgSize_bytes = CXA_MQTT_MESSAGE_CONNECT_MAXSIZE_BYTES(strlen(clientIn->clientId), strlen(clientIn->will.topic), clientIn->will.payloadLen_bytes,
+																  ((usernameIn != NULL) ? strlen(usernameIn) : 0), passwordLen_bytesIn);
 	cxa_mqtt_message_t* msg = NULL;
-	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
+	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(msgSize_bytes)) == NULL) ||
 			!cxa_mqtt_message_connect_init(msg, clientIn->clientId, usernameIn, passwordIn, passwordLen_bytesIn,
 										   clientIn->will.qos, clientIn->will.retain, clientIn->will.topic, clientIn->will.payload, clientIn->will.payloadLen_bytes,
-										   true, clientIn->keepAliveTimeout_s) ||
-			!cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg)) )
+										   clientIn->isCleanSession, clientIn->keepAliveTimeout_s) ||
+			!writePacket(clientIn, msg) )
 	{
 		cxa_logger_warn(&clientIn->logger, "failed to reserve/initialize/send CONNECT ctrlPacket");
 		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
@@ -186,6 +267,9 @@ bool cxa_mqtt_client_connect(cxa_mqtt_client_t *const clientIn, char *const user
 	}
 	if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 
+	// no reason to hold our CONNECT back
+	cxa_mqtt_client_flush(clientIn);
+
 	cxa_stateMachine_transition(&clientIn->stateMachine, MQTT_STATE_CONNECTING);
 	return true;
 }
@@ -199,6 +283,14 @@ bool cxa_mqtt_client_isConnected(cxa_mqtt_client_t *const clientIn)
 }
 
 
+bool cxa_mqtt_client_isSessionPresent(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	return clientIn->isSessionPresent;
+}
+
+
 void cxa_mqtt_client_disconnect(cxa_mqtt_client_t *const clientIn)
 {
 	cxa_assert(clientIn);
@@ -215,53 +307,91 @@ void cxa_mqtt_client_disconnect(cxa_mqtt_client_t *const clientIn)
 
 bool cxa_mqtt_client_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
 							 char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn)
+{
+	return cxa_mqtt_client_publish_withCallback(clientIn, qosIn, retainIn, topicNameIn, payloadIn, payloadLen_bytesIn, NULL, NULL);
+}
+
+
+bool cxa_mqtt_client_publish_message(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	return cxa_mqtt_client_publish_message_withCallback(clientIn, msgIn, NULL, NULL);
+}
+
+
+bool cxa_mqtt_client_publish_withCallback(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+										  char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn,
+										  cxa_mqtt_client_cb_onPublishComplete_t cb_onCompleteIn, void* userVarIn)
 {
 	cxa_assert(clientIn);
 	cxa_assert(topicNameIn);
 
 	if( !cxa_mqtt_client_isConnected(clientIn) ) return false;
 
+	// don't bother building the message if it can't be sent
+	if( (qosIn != CXA_MQTT_QOS_ATMOST_ONCE) && cxa_array_isFull(&clientIn->inflight) ) return false;
+
+	uint16_t packetId = (qosIn != CXA_MQTT_QOS_ATMOST_ONCE) ? getNextPacketId(clientIn) : 0;
 	cxa_mqtt_message_t* msg = NULL;
-	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
-		!cxa_mqtt_message_publish_init(msg, false, qosIn, retainIn, topicNameIn, clientIn->currPacketId++, payloadIn, payloadLen_bytesIn) )
+	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_PUBLISH_MAXSIZE_BYTES(strlen(topicNameIn), payloadLen_bytesIn))) == NULL) ||
+		!cxa_mqtt_message_publish_init(msg, false, qosIn, retainIn, topicNameIn, packetId, payloadIn, payloadLen_bytesIn) )
 	{
 		cxa_logger_warn(&clientIn->logger, "publish reserve/initialize failed, dropped");
 		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 		return false;
 	}
 
-	bool retVal = cxa_mqtt_client_publish_message(clientIn, msg);
+	bool retVal = cxa_mqtt_client_publish_message_withCallback(clientIn, msg, cb_onCompleteIn, userVarIn);
 	cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 	return retVal;
 }
 
 
-bool cxa_mqtt_client_publish_message(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+bool cxa_mqtt_client_publish_message_withCallback(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+												  cxa_mqtt_client_cb_onPublishComplete_t cb_onCompleteIn, void* userVarIn)
+{
+	return publishMessage(clientIn, msgIn, NULL, 0, cb_onCompleteIn, NULL, userVarIn);
+}
+
+
+bool cxa_mqtt_client_publish_zeroCopy(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, bool retainIn,
+									  char* topicNameIn, void *const payloadIn, size_t payloadLen_bytesIn,
+									  cxa_mqtt_client_cb_onPayloadReleased_t cb_onPayloadReleasedIn, void* userVarIn)
 {
 	cxa_assert(clientIn);
-	cxa_assert(msgIn);
+	cxa_assert(topicNameIn);
+	if( payloadLen_bytesIn > 0 ) cxa_assert(payloadIn);
 
 	if( !cxa_mqtt_client_isConnected(clientIn) ) return false;
 
-	char *topicName;
-	uint16_t topicNameLen_bytes;
-	if( !cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) ) return false;
+	// don't bother building the message if it can't be sent
+	if( (qosIn != CXA_MQTT_QOS_ATMOST_ONCE) && cxa_array_isFull(&clientIn->inflight) ) return false;
 
-//	cxa_logger_log_untermString(&clientIn->logger, CXA_LOG_LEVEL_INFO, "publish '", topicName, topicNameLen_bytes, "'");
-	bool retVal = true;
-	if( !cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msgIn)) )
+	// our message only holds everything up to the payload
+	uint16_t packetId = (qosIn != CXA_MQTT_QOS_ATMOST_ONCE) ? getNextPacketId(clientIn) : 0;
+	cxa_mqtt_message_t* msg = NULL;
+	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_PUBLISH_MAXSIZE_BYTES(strlen(topicNameIn), 0))) == NULL) ||
+		!cxa_mqtt_message_publish_init(msg, false, qosIn, retainIn, topicNameIn, packetId, NULL, 0) )
 	{
-		cxa_logger_warn(&clientIn->logger, "publish send failed, dropped");
-		retVal = false;
+		cxa_logger_warn(&clientIn->logger, "publish reserve/initialize failed, dropped");
+		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		return false;
 	}
 
-	if( retVal ) notify_activity(clientIn);
-
+	bool retVal = publishMessage(clientIn, msg, payloadIn, payloadLen_bytesIn, NULL, cb_onPayloadReleasedIn, userVarIn);
+	cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 	return retVal;
 }
 
 
-void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn)
+size_t cxa_mqtt_client_getNumFreeInflightSlots(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	return cxa_array_getFreeSize_elems(&clientIn->inflight);
+}
+
+
+bool cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn, cxa_mqtt_client_cb_onPublish_t cb_onPublishIn, void* userVarIn)
 {
 	cxa_assert(clientIn);
 	cxa_assert(topicFilterIn);
@@ -275,34 +405,84 @@ void cxa_mqtt_client_subscribe(cxa_mqtt_client_t *const clientIn, char *topicFil
 		if( cxa_stringUtils_equals(currSubscription->topicFilter, topicFilterIn) &&
 			(currSubscription->qos == qosIn) &&
 			(currSubscription->cb_onPublish == cb_onPublishIn) &&
-			(currSubscription->userVar == userVarIn) ) return;
+			(currSubscription->userVar == userVarIn) ) return true;
 
 	}
 
 	// create our subscription entry and add to our subscriptions
 	cxa_mqtt_client_subscriptionEntry_t newEntry = {
-			.state=CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED,
-			.packetId=clientIn->currPacketId++,
 			.qos = qosIn,
 			.cb_onPublish=cb_onPublishIn,
 			.userVar=userVarIn
 	};
-	cxa_assert(cxa_stringUtils_copy(newEntry.topicFilter, topicFilterIn, sizeof(newEntry.topicFilter)));
-	cxa_assert( cxa_array_append(&clientIn->subscriptions, &newEntry) );
+	return addSubscription(clientIn, &newEntry, topicFilterIn);
+}
 
-	// try to actually send our subscribe (if we're connected)
-	if( cxa_stateMachine_getCurrentState(&clientIn->stateMachine) == MQTT_STATE_CONNECTED )
+
+bool cxa_mqtt_client_subscribe_streaming(cxa_mqtt_client_t *const clientIn, char *topicFilterIn, cxa_mqtt_qosLevel_t qosIn,
+										 cxa_mqtt_client_cb_onPublishStreamBegin_t cb_onStreamBeginIn,
+										 cxa_mqtt_client_cb_onPublishStreamData_t cb_onStreamDataIn,
+										 cxa_mqtt_client_cb_onPublishStreamEnd_t cb_onStreamEndIn,
+										 void* userVarIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(topicFilterIn);
+	cxa_assert(strlen(topicFilterIn) <= CXA_MQTT_CLIENT_MAXLEN_TOPICFILTER_BYTES);
+	cxa_assert(cb_onStreamBeginIn);
+	cxa_assert(cb_onStreamDataIn);
+
+	// make sure we don't have exact duplicates
+	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
 	{
-		cxa_mqtt_message_t* msg = NULL;
-		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
-				!cxa_mqtt_message_subscribe_init(msg, newEntry.packetId, topicFilterIn, qosIn) ||
-				!cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg)) )
-		{
-			cxa_logger_warn(&clientIn->logger, "subscribe reserve/initialize/send failed, subscription inoperable");
-		}
-		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		if( currSubscription == NULL ) continue;
+		if( cxa_stringUtils_equals(currSubscription->topicFilter, topicFilterIn) &&
+			(currSubscription->qos == qosIn) &&
+			(currSubscription->cb_onStreamBegin == cb_onStreamBeginIn) &&
+			(currSubscription->userVar == userVarIn) ) return true;
 	}
 
+	// create our subscription entry and add to our subscriptions
+	cxa_mqtt_client_subscriptionEntry_t newEntry = {
+			.qos = qosIn,
+			.cb_onStreamBegin=cb_onStreamBeginIn,
+			.cb_onStreamData=cb_onStreamDataIn,
+			.cb_onStreamEnd=cb_onStreamEndIn,
+			.userVar=userVarIn
+	};
+	return addSubscription(clientIn, &newEntry, topicFilterIn);
+}
+
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+void cxa_mqtt_client_setWriteCoalescing(cxa_mqtt_client_t *const clientIn, bool enableIn, uint32_t maxLatency_msIn)
+{
+	cxa_assert(clientIn);
+
+	// don't strand anything that was already buffered
+	if( !enableIn ) cxa_mqtt_client_flush(clientIn);
+
+	clientIn->txCoalesce.isEnabled = enableIn;
+	clientIn->txCoalesce.maxLatency_ms = maxLatency_msIn;
+}
+#endif
+
+
+bool cxa_mqtt_client_flush(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+	if( cxa_fixedByteBuffer_isEmpty(&clientIn->txCoalesce.fbb) ) return true;
+
+	bool retVal = cxa_ioStream_writeFixedByteBuffer(clientIn->mpp.super.ioStream, &clientIn->txCoalesce.fbb);
+	if( !retVal ) cxa_logger_warn(&clientIn->logger, "failed to write %d coalesced bytes", (int)cxa_fixedByteBuffer_getSize_bytes(&clientIn->txCoalesce.fbb));
+
+	// in-flight publishes will be retransmitted, everything else is lost either way
+	cxa_fixedByteBuffer_clear(&clientIn->txCoalesce.fbb);
+	return retVal;
+#else
+	return true;
+#endif
 }
 
 
@@ -349,6 +529,11 @@ static void stateCb_idle_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn
 	cxa_mqtt_client_t *clientIn = (cxa_mqtt_client_t*) userVarIn;
 	cxa_assert(clientIn);
 
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+	// our connection is gone, anything still buffered is stale
+	cxa_fixedByteBuffer_clear(&clientIn->txCoalesce.fbb);
+#endif
+
 	// notify our listeners
 	cxa_array_iterate(&clientIn->listeners, currListener, cxa_mqtt_client_listenerEntry_t)
 	{
@@ -417,23 +602,76 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int prevStat
 	cxa_timeDiff_setStartTime_now(&clientIn->td_sendKeepAlive);
 	cxa_timeDiff_setStartTime_now(&clientIn->td_receiveKeepAlive);
 
-	// re-subscribe to our subscriptions
+	// re-subscribe to our subscriptions...packs as many topic filters as will fit
+	// into each SUBSCRIBE and sends them back-to-back (without waiting for SUBACKs)
+	cxa_mqtt_message_t* msg = NULL;
+	uint16_t msgPacketId = 0;
+	uint16_t numTopicFiltersInMsg = 0;
+
+	// size each SUBSCRIBE for the topic filters left to send (so it comes from the smallest class that fits)
+	size_t unsentTopicFilters_bytes = 0;
 	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
 	{
-		if( currSubscription == NULL ) continue;
+		if( isResubscribeNeeded(clientIn, currSubscription) ) unsentTopicFilters_bytes += CXA_MQTT_MESSAGE_SUBSCRIBE_TOPICFILTER_SIZE_BYTES(strlen(currSubscription->topicFilter));
+	}
 
-		currSubscription->packetId = clientIn->currPacketId++;
-		currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED;
+	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
+	{
+		if( !isResubscribeNeeded(clientIn, currSubscription) ) continue;
+
+		size_t currTopicFilter_bytes = CXA_MQTT_MESSAGE_SUBSCRIBE_TOPICFILTER_SIZE_BYTES(strlen(currSubscription->topicFilter));
+		unsentTopicFilters_bytes -= currTopicFilter_bytes;
 
+		currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED;
 		cxa_logger_trace(&clientIn->logger, "subscribing to stored '%s'", currSubscription->topicFilter);
-		cxa_mqtt_message_t* msg = NULL;
-		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
-				!cxa_mqtt_message_subscribe_init(msg, currSubscription->packetId, currSubscription->topicFilter, currSubscription->qos) ||
-				!cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg)) )
+
+		// if our current SUBSCRIBE is full, send it and start another
+		if( (msg != NULL) && !cxa_mqtt_message_subscribe_appendTopicFilter(msg, currSubscription->topicFilter, currSubscription->qos) )
 		{
-			cxa_logger_warn(&clientIn->logger, "subscribe reserve/initialize/send failed, subscription inoperable");
+			sendSubscribeBatch(clientIn, msg, numTopicFiltersInMsg);
+			msg = NULL;
 		}
-		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+		if( msg == NULL )
+		{
+			msgPacketId = getNextPacketId(clientIn);
+			numTopicFiltersInMsg = 0;
+			// (settle for smaller batches if no message is large enough for everything)
+			size_t minSize_bytes = CXA_MQTT_MESSAGE_SUBSCRIBE_MAXSIZE_BYTES(0) - CXA_MQTT_MESSAGE_SUBSCRIBE_TOPICFILTER_SIZE_BYTES(0) + currTopicFilter_bytes;
+			size_t msgSize_bytes = minSize_bytes + unsentTopicFilters_bytes;
+			if( msgSize_bytes > CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES ) msgSize_bytes = CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES;
+			while( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(msgSize_bytes)) == NULL) && (msgSize_bytes > minSize_bytes) )
+			{
+				msgSize_bytes = ((msgSize_bytes / 2) > minSize_bytes) ? (msgSize_bytes / 2) : minSize_bytes;
+			}
+
+			if( (msg == NULL) ||
+					!cxa_mqtt_message_subscribe_initBatch(msg, msgPacketId) ||
+					!cxa_mqtt_message_subscribe_appendTopicFilter(msg, currSubscription->topicFilter, currSubscription->qos) )
+			{
+				cxa_logger_warn(&clientIn->logger, "subscribe reserve/initialize failed, subscription to '%s' inoperable", currSubscription->topicFilter);
+				if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+				msg = NULL;
+				continue;
+			}
+		}
+
+		// we'll get our return code at this position in the SUBACK
+		currSubscription->packetId = msgPacketId;
+		currSubscription->subAckIndex = numTopicFiltersInMsg++;
+	}
+	if( msg != NULL ) sendSubscribeBatch(clientIn, msg, numTopicFiltersInMsg);
+
+	// without our old session, the server won't be sending PUBRELs for old QoS2 publishes
+	// (with it, we must keep them so redelivered QoS2 publishes aren't delivered twice)
+	if( !clientIn->isSessionPresent ) cxa_array_clear(&clientIn->inboundQos2PacketIds);
+
+	// resend anything that was in-flight when we lost our connection
+	cxa_array_iterate(&clientIn->inflight, currEntry, cxa_mqtt_client_inflightEntry_t)
+	{
+		if( currEntry == NULL ) continue;
+
+		cxa_logger_debug(&clientIn->logger, "resending in-flight packetId %d", currEntry->packetId);
+		if( !sendInflight(clientIn, currEntry, true) ) cxa_logger_warn(&clientIn->logger, "failed to resend in-flight packetId %d", currEntry->packetId);
 	}
 
 	// notify our listeners
@@ -456,15 +694,30 @@ static void stateCb_connected_state(cxa_stateMachine_t *const smIn, void *userVa
 	{
 		cxa_logger_trace(&clientIn->logger, "sending PINGREQ");
 		cxa_mqtt_message_t* msg = NULL;
-		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
+		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_PINGREQUEST_MAXSIZE_BYTES)) == NULL) ||
 				!cxa_mqtt_message_pingRequest_init(msg) ||
-				!cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msg)) )
+				!writePacket(clientIn, msg) )
 		{
 			cxa_logger_warn(&clientIn->logger, "failed to reserve/initialize/send PINGREQ ctrlPacket");
 		}
 		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
 	}
 
+	// retransmit any in-flight publishes which haven't been acknowledged in time
+	cxa_array_iterate(&clientIn->inflight, currEntry, cxa_mqtt_client_inflightEntry_t)
+	{
+		if( currEntry == NULL ) continue;
+		if( !cxa_timeDiff_isElapsed_ms(&currEntry->td_lastSent, CXA_MQTT_CLIENT_INFLIGHT_RETRANSMIT_MS) ) continue;
+
+		cxa_logger_debug(&clientIn->logger, "retransmitting in-flight packetId %d", currEntry->packetId);
+		if( !sendInflight(clientIn, currEntry, true) ) cxa_logger_warn(&clientIn->logger, "failed to retransmit in-flight packetId %d", currEntry->packetId);
+	}
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+	// write out anything we've been holding long enough
+	txCoalesce_flushIfDue(clientIn);
+#endif
+
 	// make sure we are receiving pings
 	if( (clientIn->keepAliveTimeout_s != 0) && cxa_timeDiff_isElapsed_recurring_ms(&clientIn->td_receiveKeepAlive, (clientIn->keepAliveTimeout_s * 1000 * 2)) )
 	{
@@ -509,44 +762,125 @@ static void protoParseCb_onPacketReceived(cxa_fixedByteBuffer_t *const packetIn,
 	cxa_mqtt_message_t* msg = cxa_mqtt_messageFactory_getMessage_byBuffer(packetIn);
 	if( msg == NULL ) return;
 
-	cxa_mqtt_message_type_t msgType = cxa_mqtt_message_getType(msg);
-	switch( msgType )
+	// received messages were already decoded into a flat view during validation
+	const cxa_mqtt_message_view_t* view = cxa_mqtt_message_getView(msg);
+	if( view == NULL ) return;
+
+	switch( view->type )
 	{
 		case CXA_MQTT_MSGTYPE_CONNACK:
-			handleMessage_connAck(clientIn, msg);
+			handleMessage_connAck(clientIn, view);
 			break;
 
 		case CXA_MQTT_MSGTYPE_PINGRESP:
-			handleMessage_pingResp(clientIn, msg);
+			handleMessage_pingResp(clientIn);
 			break;
 
 		case CXA_MQTT_MSGTYPE_SUBACK:
-			handleMessage_subAck(clientIn, msg);
+			handleMessage_subAck(clientIn, view);
 			break;
 
 		case CXA_MQTT_MSGTYPE_PUBLISH:
-			handleMessage_publish(clientIn, msg);
+			handleMessage_publish(clientIn, msg, view);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBACK:
+		case CXA_MQTT_MSGTYPE_PUBREC:
+		case CXA_MQTT_MSGTYPE_PUBREL:
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			handleMessage_publishAck(clientIn, view);
 			break;
 
 		default:
-			cxa_logger_trace(&clientIn->logger, "got unknown msgType: %d", msgType);
+			cxa_logger_trace(&clientIn->logger, "got unknown msgType: %d", view->type);
 			break;
 	}
 }
 
 
-static void handleMessage_connAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+static bool protoParseCb_onStreamBegin(cxa_mqtt_qosLevel_t qosIn, uint16_t packetIdIn,
+									   char *const topicNameIn, size_t topicNameLen_bytesIn,
+									   size_t payloadLen_bytesIn, void *const userVarIn)
 {
+	cxa_mqtt_client_t *clientIn = (cxa_mqtt_client_t*) userVarIn;
 	cxa_assert(clientIn);
-	cxa_assert(msgIn);
+
+	// if we're not supposed to be processing data, don't do it
+	if( cxa_stateMachine_getCurrentState(&clientIn->stateMachine) == MQTT_STATE_IDLE ) return false;
+
+	cxa_logger_info_untermString(&clientIn->logger, "got streamed PUBLISH '", topicNameIn, topicNameLen_bytesIn, "'");
+
+	clientIn->inboundStream.qos = qosIn;
+	clientIn->inboundStream.packetId = packetIdIn;
+	clientIn->inboundStream.isDuplicate = (qosIn == CXA_MQTT_QOS_EXACTLY_ONCE) && (getInboundQos2PacketId(clientIn, packetIdIn) != NULL);
+
+	streamDispatchContext_t ctx = {
+			.client = clientIn,
+			.topicName = topicNameIn,
+			.topicNameLen_bytes = topicNameLen_bytesIn,
+			.payloadLen_bytes = payloadLen_bytesIn,
+			.numActive = 0
+	};
+	if( !clientIn->inboundStream.isDuplicate )
+	{
+		cxa_mqtt_topicTrie_match(&clientIn->subscriptionTrie, topicNameIn, topicNameLen_bytesIn, trieCb_onStreamMatch, (void*)&ctx);
+		if( ctx.numActive == 0 ) cxa_logger_warn(&clientIn->logger, "no streaming subscription for %d byte PUBLISH, discarding", (int)payloadLen_bytesIn);
+	}
+
+	// always receive the payload (even if no-one wants it) so we can acknowledge it
+	return true;
+}
+
+
+static void protoParseCb_onStreamData(uint8_t *const dataIn, size_t dataLen_bytesIn, void *const userVarIn)
+{
+	cxa_mqtt_client_t *clientIn = (cxa_mqtt_client_t*) userVarIn;
+	cxa_assert(clientIn);
+
+	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
+	{
+		if( (currSubscription == NULL) || !currSubscription->isStreamActive ) continue;
+		currSubscription->cb_onStreamData(clientIn, dataIn, dataLen_bytesIn, currSubscription->userVar);
+	}
+}
+
+
+static void protoParseCb_onStreamEnd(bool wasSuccessfulIn, void *const userVarIn)
+{
+	cxa_mqtt_client_t *clientIn = (cxa_mqtt_client_t*) userVarIn;
+	cxa_assert(clientIn);
+
+	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
+	{
+		if( (currSubscription == NULL) || !currSubscription->isStreamActive ) continue;
+		currSubscription->isStreamActive = false;
+		if( currSubscription->cb_onStreamEnd != NULL ) currSubscription->cb_onStreamEnd(clientIn, wasSuccessfulIn, currSubscription->userVar);
+	}
+
+	// incomplete publishes aren't acknowledged (the server will redeliver QoS1/QoS2)
+	if( !wasSuccessfulIn || (cxa_stateMachine_getCurrentState(&clientIn->stateMachine) == MQTT_STATE_IDLE) ) return;
+
+	acknowledgePublish(clientIn, clientIn->inboundStream.qos, clientIn->inboundStream.packetId, clientIn->inboundStream.isDuplicate);
+
+	// notify our listeners
+	notify_activity(clientIn);
+}
+
+
+static void handleMessage_connAck(cxa_mqtt_client_t *const clientIn, const cxa_mqtt_message_view_t *const viewIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(viewIn);
 
 	// only handle if we are in the appropriate state
 	if( cxa_stateMachine_getCurrentState(&clientIn->stateMachine) != MQTT_STATE_CONNECTING ) return;
 
-	cxa_mqtt_connAck_returnCode_t retCode = CXA_MQTT_CONNACK_RETCODE_UNKNOWN;
-	if( cxa_mqtt_message_connack_getReturnCode(msgIn, &retCode ) && (retCode == CXA_MQTT_CONNACK_RETCODE_ACCEPTED) )
+	cxa_mqtt_connAck_returnCode_t retCode = (cxa_mqtt_connAck_returnCode_t)viewIn->asConnAck.returnCode;
+	if( retCode == CXA_MQTT_CONNACK_RETCODE_ACCEPTED )
 	{
-		cxa_logger_trace(&clientIn->logger, "got CONNACK");
+		// the server can't have a session for us if we asked for a clean one
+		clientIn->isSessionPresent = !clientIn->isCleanSession && viewIn->asConnAck.isSessionPresent;
+		cxa_logger_trace(&clientIn->logger, "got CONNACK (session present: %d)", clientIn->isSessionPresent);
 
 		cxa_stateMachine_transition(&clientIn->stateMachine, MQTT_STATE_CONNECTED);
 		return;
@@ -566,10 +900,9 @@ static void handleMessage_connAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_me
 }
 
 
-static void handleMessage_pingResp(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+static void handleMessage_pingResp(cxa_mqtt_client_t *const clientIn)
 {
 	cxa_assert(clientIn);
-	cxa_assert(msgIn);
 
 	cxa_logger_trace(&clientIn->logger, "got PINGRESP");
 	cxa_timeDiff_setStartTime_now(&clientIn->td_receiveKeepAlive);
@@ -579,122 +912,509 @@ static void handleMessage_pingResp(cxa_mqtt_client_t *const clientIn, cxa_mqtt_m
 }
 
 
-static void handleMessage_subAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+static void handleMessage_subAck(cxa_mqtt_client_t *const clientIn, const cxa_mqtt_message_view_t *const viewIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(viewIn);
+
+	uint16_t packetId = viewIn->asSubAck.packetId;
+
+	cxa_logger_trace(&clientIn->logger, "got SUBACK for packetId %d: %d return codes", packetId, (int)viewIn->asSubAck.numReturnCodes);
+
+	cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
+	{
+		if( currSubscription == NULL ) continue;
+		if( (currSubscription->state == CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED) && (currSubscription->packetId == packetId) )
+		{
+			// a SUBACK missing our return code is treated as a refusal
+			cxa_mqtt_subAck_returnCode_t retCode = (currSubscription->subAckIndex < viewIn->asSubAck.numReturnCodes) ?
+					(cxa_mqtt_subAck_returnCode_t)viewIn->asSubAck.returnCodes[currSubscription->subAckIndex] :
+					CXA_MQTT_SUBACK_RETCODE_FAILURE;
+
+			// found our subscription...what we do now depends on whether it was successful
+			if( retCode == CXA_MQTT_SUBACK_RETCODE_FAILURE )
+			{
+				currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_REFUSED;
+				cxa_logger_warn(&clientIn->logger, "server refused subscription to '%s'", currSubscription->topicFilter);
+			}
+			else
+			{
+				currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_ACKNOWLEDGED;
+				cxa_logger_info(&clientIn->logger, "subscription to '%s' successful", currSubscription->topicFilter);
+			}
+		}
+	}
+}
+
+
+static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn, const cxa_mqtt_message_view_t *const viewIn)
 {
 	cxa_assert(clientIn);
 	cxa_assert(msgIn);
+	cxa_assert(viewIn);
+
+	cxa_logger_info_untermString(&clientIn->logger, "got PUBLISH '", viewIn->asPublish.topicName, viewIn->asPublish.topicNameLen_bytes, "'");
 
-	cxa_mqtt_subAck_returnCode_t retCode;
-	uint16_t packetId;
-	if( cxa_mqtt_message_suback_getPacketId(msgIn, &packetId) && cxa_mqtt_message_suback_getReturnCode(msgIn, &retCode) )
+	// QoS2 publishes we've already delivered (awaiting PUBREL) are only acknowledged again
+	cxa_mqtt_qosLevel_t qos = viewIn->asPublish.qos;
+	uint16_t packetId = viewIn->asPublish.packetId;
+	bool isDuplicate = (qos == CXA_MQTT_QOS_EXACTLY_ONCE) && (getInboundQos2PacketId(clientIn, packetId) != NULL);
+
+	if( !isDuplicate )
 	{
-		cxa_logger_trace(&clientIn->logger, "got SUBACK for packetId %d: %d", packetId, retCode);
+		// let our trie figure out which subscriptions this goes to
+		publishDispatchContext_t ctx = {
+				.client = clientIn,
+				.msg = msgIn,
+				.view = viewIn
+		};
+		cxa_mqtt_topicTrie_match(&clientIn->subscriptionTrie, viewIn->asPublish.topicName, viewIn->asPublish.topicNameLen_bytes, trieCb_onPublishMatch, (void*)&ctx);
+	}
 
-		cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
-		{
-			if( currSubscription == NULL ) continue;
-			if( (currSubscription->state == CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED) && (currSubscription->packetId == packetId) )
+	acknowledgePublish(clientIn, qos, packetId, isDuplicate);
+
+	// notify our listeners
+	notify_activity(clientIn);
+}
+
+
+static void handleMessage_publishAck(cxa_mqtt_client_t *const clientIn, const cxa_mqtt_message_view_t *const viewIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(viewIn);
+
+	uint16_t packetId = viewIn->asPublishAck.packetId;
+	cxa_mqtt_client_inflightEntry_t* entry = getInflightEntry_byPacketId(clientIn, packetId);
+
+	switch( viewIn->type )
+	{
+		case CXA_MQTT_MSGTYPE_PUBACK:
+			cxa_logger_trace(&clientIn->logger, "got PUBACK for packetId %d", packetId);
+			if( (entry != NULL) && (entry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK) ) completeInflight(clientIn, entry);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREC:
+			cxa_logger_trace(&clientIn->logger, "got PUBREC for packetId %d", packetId);
+			if( entry == NULL ) break;
+
+			// the server has the publish, we no longer need to hold it
+			if( entry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBREC )
+			{
+				cxa_mqtt_messageFactory_decrementMessageRefCount(entry->msg);
+				entry->msg = NULL;
+				entry->state = CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP;
+				releaseExtPayload(clientIn, entry);
+			}
+
+			// (re)send our PUBREL
+			if( (entry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP) && !sendInflight(clientIn, entry, false) )
 			{
-				// found our subscription...what we do now depends on whether it was successful
-				if( retCode == CXA_MQTT_SUBACK_RETCODE_FAILURE )
-				{
-					currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_REFUSED;
-					cxa_logger_warn(&clientIn->logger, "server refused subscription to '%s'", currSubscription->topicFilter);
-				}
-				else
-				{
-					currSubscription->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_ACKNOWLEDGED;
-					cxa_logger_info(&clientIn->logger, "subscription to '%s' successful", currSubscription->topicFilter);
-				}
+				cxa_logger_warn(&clientIn->logger, "failed to send PUBREL, will retransmit");
 			}
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			cxa_logger_trace(&clientIn->logger, "got PUBCOMP for packetId %d", packetId);
+			if( (entry != NULL) && (entry->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP) ) completeInflight(clientIn, entry);
+			break;
+
+		case CXA_MQTT_MSGTYPE_PUBREL:
+		{
+			cxa_logger_trace(&clientIn->logger, "got PUBREL for packetId %d", packetId);
+
+			// the server won't resend this QoS2 publish, so we can forget it
+			uint16_t* inboundPacketId = getInboundQos2PacketId(clientIn, packetId);
+			if( inboundPacketId != NULL ) cxa_array_remove(&clientIn->inboundQos2PacketIds, inboundPacketId);
+
+			if( !sendPublishAck(clientIn, CXA_MQTT_MSGTYPE_PUBCOMP, packetId) ) cxa_logger_warn(&clientIn->logger, "failed to send PUBCOMP");
+			break;
 		}
-	} else cxa_logger_warn(&clientIn->logger, "malformed SUBACK");
+
+		default:
+			break;
+	}
+
+	// notify our listeners
+	notify_activity(clientIn);
 }
 
 
-static void handleMessage_publish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+static void trieCb_onPublishMatch(uint16_t entryIndexIn, void* userVarIn)
+{
+	publishDispatchContext_t* ctx = (publishDispatchContext_t*)userVarIn;
+	cxa_assert(ctx);
+
+	cxa_mqtt_client_subscriptionEntry_t* subscription = (cxa_mqtt_client_subscriptionEntry_t*)cxa_array_get(&ctx->client->subscriptions, entryIndexIn);
+	if( subscription == NULL ) return;
+
+	if( subscription->cb_onPublish != NULL )
+	{
+		subscription->cb_onPublish(ctx->client, ctx->msg, ctx->view->asPublish.topicName, ctx->view->asPublish.topicNameLen_bytes,
+								   ctx->view->asPublish.payload, ctx->view->asPublish.payloadSize_bytes, subscription->userVar);
+	}
+	else if( subscription->cb_onStreamBegin != NULL )
+	{
+		// publish fit in our buffer, stream it as a single chunk
+		if( !subscription->cb_onStreamBegin(ctx->client, ctx->view->asPublish.topicName, ctx->view->asPublish.topicNameLen_bytes,
+											ctx->view->asPublish.payloadSize_bytes, subscription->userVar) ) return;
+		if( ctx->view->asPublish.payloadSize_bytes > 0 )
+		{
+			subscription->cb_onStreamData(ctx->client, ctx->view->asPublish.payload, ctx->view->asPublish.payloadSize_bytes, subscription->userVar);
+		}
+		if( subscription->cb_onStreamEnd != NULL ) subscription->cb_onStreamEnd(ctx->client, true, subscription->userVar);
+	}
+}
+
+
+static void trieCb_onStreamMatch(uint16_t entryIndexIn, void* userVarIn)
+{
+	streamDispatchContext_t* ctx = (streamDispatchContext_t*)userVarIn;
+	cxa_assert(ctx);
+
+	cxa_mqtt_client_subscriptionEntry_t* subscription = (cxa_mqtt_client_subscriptionEntry_t*)cxa_array_get(&ctx->client->subscriptions, entryIndexIn);
+	if( (subscription == NULL) || (subscription->cb_onStreamBegin == NULL) ) return;
+
+	subscription->isStreamActive = subscription->cb_onStreamBegin(ctx->client, ctx->topicName, ctx->topicNameLen_bytes,
+																  ctx->payloadLen_bytes, subscription->userVar);
+	if( subscription->isStreamActive ) ctx->numActive++;
+}
+
+
+static bool publishMessage(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn,
+						   void *const extPayloadIn, size_t extPayloadLen_bytesIn,
+						   cxa_mqtt_client_cb_onPublishComplete_t cb_onCompleteIn,
+						   cxa_mqtt_client_cb_onPayloadReleased_t cb_onPayloadReleasedIn, void* userVarIn)
 {
 	cxa_assert(clientIn);
 	cxa_assert(msgIn);
 
-	// iterate through our subscriptions to figure out where this goes
+	if( !cxa_mqtt_client_isConnected(clientIn) ) return false;
+
 	char *topicName;
 	uint16_t topicNameLen_bytes;
-	cxa_linkedField_t* lf_payload;
-	void *payload;
-	size_t payloadSize_bytes;
-	if( cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) && cxa_mqtt_message_publish_getPayload(msgIn, &lf_payload) )
+	cxa_mqtt_qosLevel_t qos;
+	if( !cxa_mqtt_message_publish_getTopicName(msgIn, &topicName, &topicNameLen_bytes) ||
+		!cxa_mqtt_message_publish_getQos(msgIn, &qos) ) return false;
+
+	// QoS1/QoS2 publishes are held (by packetId) until they are acknowledged
+	cxa_mqtt_client_inflightEntry_t* newEntry = NULL;
+	if( qos != CXA_MQTT_QOS_ATMOST_ONCE )
+	{
+		uint16_t packetId;
+		if( !cxa_mqtt_message_publish_getPacketId(msgIn, &packetId) ) return false;
+		if( cxa_array_isFull(&clientIn->inflight) )
+		{
+			cxa_logger_debug(&clientIn->logger, "in-flight window full, publish refused");
+			return false;
+		}
+		if( getInflightEntry_byPacketId(clientIn, packetId) != NULL )
+		{
+			cxa_logger_warn(&clientIn->logger, "packetId %d already in-flight, publish refused", packetId);
+			return false;
+		}
+		// we still need a message to send acknowledgements and pings
+		if( cxa_mqtt_messageFactory_getNumFreeMessages() == 0 )
+		{
+			cxa_logger_warn(&clientIn->logger, "no free messages to hold in-flight publish, increase CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES");
+			return false;
+		}
+
+		newEntry = (cxa_mqtt_client_inflightEntry_t*)cxa_array_append_empty(&clientIn->inflight);
+		cxa_assert(newEntry);
+		newEntry->packetId = packetId;
+		newEntry->state = (qos == CXA_MQTT_QOS_ATLEAST_ONCE) ? CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBACK : CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBREC;
+		newEntry->msg = msgIn;
+		cxa_mqtt_messageFactory_incrementMessageRefCount(msgIn);
+		cxa_timeDiff_init(&newEntry->td_lastSent);
+		newEntry->extPayload = extPayloadIn;
+		newEntry->extPayloadLen_bytes = extPayloadLen_bytesIn;
+		newEntry->cb_onPayloadReleased = cb_onPayloadReleasedIn;
+		newEntry->cb_onComplete = cb_onCompleteIn;
+		newEntry->userVar = userVarIn;
+	}
+
+//	cxa_logger_log_untermString(&clientIn->logger, CXA_LOG_LEVEL_INFO, "publish '", topicName, topicNameLen_bytes, "'");
+	bool retVal = true;
+	if( newEntry != NULL )
+	{
+		// failed sends are retransmitted with the rest of the window
+		if( !sendInflight(clientIn, newEntry, false) ) cxa_logger_warn(&clientIn->logger, "publish send failed, will retransmit");
+	}
+	else if( !writePacket_withPayload(clientIn, msgIn, extPayloadIn, extPayloadLen_bytesIn) )
 	{
-		cxa_logger_info_untermString(&clientIn->logger, "got PUBLISH '", topicName, topicNameLen_bytes, "'");
+		cxa_logger_warn(&clientIn->logger, "publish send failed, dropped");
+		retVal = false;
+	}
+	else if( (extPayloadIn != NULL) && (cb_onPayloadReleasedIn != NULL) ) cb_onPayloadReleasedIn(clientIn, extPayloadIn, userVarIn);
 
-		payloadSize_bytes = cxa_linkedField_getSize_bytes(lf_payload);
-		payload = (payloadSize_bytes > 0) ? cxa_linkedField_get_pointerToIndex(lf_payload, 0) : NULL;
+	if( retVal ) notify_activity(clientIn);
+
+	return retVal;
+}
+
+
+static uint16_t getNextPacketId(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	// packet ids must be non-zero and can't be reused while in-flight
+	do
+	{
+		clientIn->currPacketId++;
+	} while( (clientIn->currPacketId == 0) || (getInflightEntry_byPacketId(clientIn, clientIn->currPacketId) != NULL) );
+
+	return clientIn->currPacketId;
+}
+
+
+static cxa_mqtt_client_inflightEntry_t* getInflightEntry_byPacketId(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
 
-		cxa_array_iterate(&clientIn->subscriptions, currSubscription, cxa_mqtt_client_subscriptionEntry_t)
+	cxa_array_iterate(&clientIn->inflight, currEntry, cxa_mqtt_client_inflightEntry_t)
+	{
+		if( currEntry == NULL ) continue;
+		if( currEntry->packetId == packetIdIn ) return currEntry;
+	}
+	return NULL;
+}
+
+
+static uint16_t* getInboundQos2PacketId(cxa_mqtt_client_t *const clientIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
+
+	cxa_array_iterate(&clientIn->inboundQos2PacketIds, currPacketId, uint16_t)
+	{
+		if( currPacketId == NULL ) continue;
+		if( *currPacketId == packetIdIn ) return currPacketId;
+	}
+	return NULL;
+}
+
+
+static bool sendInflight(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inflightEntry_t *const entryIn, bool isRetransmitIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(entryIn);
+
+	cxa_timeDiff_setStartTime_now(&entryIn->td_lastSent);
+
+	// once the server has received a QoS2 publish, we only need to (re)send the PUBREL
+	if( entryIn->state == CXA_MQTT_CLIENT_INFLIGHT_STATE_AWAIT_PUBCOMP ) return sendPublishAck(clientIn, CXA_MQTT_MSGTYPE_PUBREL, entryIn->packetId);
+
+	cxa_assert(entryIn->msg);
+	if( isRetransmitIn && !cxa_mqtt_message_publish_setDup(entryIn->msg, true) ) return false;
+	return writePacket_withPayload(clientIn, entryIn->msg, entryIn->extPayload, entryIn->extPayloadLen_bytes);
+}
+
+
+static void completeInflight(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inflightEntry_t *const entryIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(entryIn);
+
+	// remove before notifying (the callback may publish again)
+	cxa_mqtt_client_inflightEntry_t completedEntry = *entryIn;
+	cxa_assert(cxa_array_remove(&clientIn->inflight, entryIn));
+
+	if( completedEntry.msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(completedEntry.msg);
+	releaseExtPayload(clientIn, &completedEntry);
+	if( completedEntry.cb_onComplete != NULL ) completedEntry.cb_onComplete(clientIn, completedEntry.packetId, completedEntry.userVar);
+}
+
+
+static void releaseExtPayload(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_inflightEntry_t *const entryIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(entryIn);
+
+	if( entryIn->extPayload == NULL ) return;
+
+	void* extPayload = entryIn->extPayload;
+	entryIn->extPayload = NULL;
+	entryIn->extPayloadLen_bytes = 0;
+	if( entryIn->cb_onPayloadReleased != NULL ) entryIn->cb_onPayloadReleased(clientIn, extPayload, entryIn->userVar);
+}
+
+
+static bool isResubscribeNeeded(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_subscriptionEntry_t *const subIn)
+{
+	cxa_assert(clientIn);
+
+	// if the server kept our session, it still has everything it acknowledged
+	return (subIn != NULL) && !(clientIn->isSessionPresent && (subIn->state == CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_ACKNOWLEDGED));
+}
+
+
+static void sendSubscribeBatch(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn, uint16_t numTopicFiltersIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	cxa_logger_debug(&clientIn->logger, "sending SUBSCRIBE with %d topic filters", numTopicFiltersIn);
+	if( !writePacket(clientIn, msgIn) ) cxa_logger_warn(&clientIn->logger, "subscribe send failed, %d subscriptions inoperable", numTopicFiltersIn);
+	cxa_mqtt_messageFactory_decrementMessageRefCount(msgIn);
+}
+
+
+static bool addSubscription(cxa_mqtt_client_t *const clientIn, cxa_mqtt_client_subscriptionEntry_t *const newEntryIn, char *const topicFilterIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(newEntryIn);
+	cxa_assert(topicFilterIn);
+
+	// our trie is sized for CXA_MQTT_CLIENT_MAXNUM_TOPICFILTER_LEVELS, so a filter that passes here will fit
+	size_t numLevels;
+	if( !cxa_mqtt_topicTrie_validateFilter(topicFilterIn, &numLevels) || (numLevels > CXA_MQTT_CLIENT_MAXNUM_TOPICFILTER_LEVELS) )
+	{
+		cxa_logger_warn(&clientIn->logger, "bad topic filter: '%s'", topicFilterIn);
+		return false;
+	}
+	if( cxa_array_isFull(&clientIn->subscriptions) )
+	{
+		cxa_logger_warn(&clientIn->logger, "too many subscriptions");
+		return false;
+	}
+
+	newEntryIn->state = CXA_MQTT_CLIENT_SUBSCRIPTION_STATE_UNACKNOWLEDGED;
+	newEntryIn->packetId = getNextPacketId(clientIn);
+	newEntryIn->subAckIndex = 0;
+	newEntryIn->isStreamActive = false;
+	cxa_assert(cxa_stringUtils_copy(newEntryIn->topicFilter, topicFilterIn, sizeof(newEntryIn->topicFilter)));
+	cxa_assert( cxa_array_append(&clientIn->subscriptions, newEntryIn) );
+
+	// the trie references the topic filter stored in our subscriptions array
+	size_t newEntryIndex = cxa_array_getSize_elems(&clientIn->subscriptions) - 1;
+	cxa_mqtt_client_subscriptionEntry_t* addedEntry = (cxa_mqtt_client_subscriptionEntry_t*)cxa_array_get(&clientIn->subscriptions, newEntryIndex);
+	if( !cxa_mqtt_topicTrie_insert(&clientIn->subscriptionTrie, addedEntry->topicFilter, newEntryIndex) )
+	{
+		cxa_logger_warn(&clientIn->logger, "topic trie full: '%s'", addedEntry->topicFilter);
+		cxa_array_remove_atIndex(&clientIn->subscriptions, newEntryIndex);
+		return false;
+	}
+
+	// try to actually send our subscribe (if we're connected)
+	if( cxa_stateMachine_getCurrentState(&clientIn->stateMachine) == MQTT_STATE_CONNECTED )
+	{
+		cxa_mqtt_message_t* msg = NULL;
+		if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_SUBSCRIBE_MAXSIZE_BYTES(strlen(topicFilterIn)))) == NULL) ||
+				!cxa_mqtt_message_subscribe_init(msg, addedEntry->packetId, topicFilterIn, addedEntry->qos) ||
+				!writePacket(clientIn, msg) )
 		{
-			if( currSubscription == NULL ) continue;
+			cxa_logger_warn(&clientIn->logger, "subscribe reserve/initialize/send failed, subscription inoperable");
+		}
+		if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+	}
 
-			// @TODO this is a hack...I'm using paho's topic matching code...but it expects a null-terminated string
-			// MQTT spec says all string are not null-terminated...I don't want to change the message data (add null)
-			// so we'll null term for the check, then un-null term
+	return true;
+}
 
-			char oldVal = topicName[topicNameLen_bytes];
-			topicName[topicNameLen_bytes] = 0;
-			bool doesTopicMatch = doesTopicMatchFilter(topicName, currSubscription->topicFilter);
-			topicName[topicNameLen_bytes] = oldVal;
 
-			if( doesTopicMatch && currSubscription->cb_onPublish )
-			{
-				currSubscription->cb_onPublish(clientIn, msgIn, topicName, topicNameLen_bytes, payload, payloadSize_bytes, currSubscription->userVar);
-			}
+static void acknowledgePublish(cxa_mqtt_client_t *const clientIn, cxa_mqtt_qosLevel_t qosIn, uint16_t packetIdIn, bool isDuplicateIn)
+{
+	cxa_assert(clientIn);
+
+	if( qosIn == CXA_MQTT_QOS_ATLEAST_ONCE )
+	{
+		if( !sendPublishAck(clientIn, CXA_MQTT_MSGTYPE_PUBACK, packetIdIn) ) cxa_logger_warn(&clientIn->logger, "failed to send PUBACK");
+	}
+	else if( qosIn == CXA_MQTT_QOS_EXACTLY_ONCE )
+	{
+		if( !isDuplicateIn && !cxa_array_append(&clientIn->inboundQos2PacketIds, &packetIdIn) )
+		{
+			cxa_logger_warn(&clientIn->logger, "too many QoS2 publishes awaiting PUBREL, increase CXA_MQTT_CLIENT_MAXNUM_INBOUND_QOS2");
+		}
+		if( !sendPublishAck(clientIn, CXA_MQTT_MSGTYPE_PUBREC, packetIdIn) ) cxa_logger_warn(&clientIn->logger, "failed to send PUBREC");
+	}
+}
+
+
+static bool sendPublishAck(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn)
+{
+	cxa_assert(clientIn);
+
+	bool retVal = true;
+	cxa_mqtt_message_t* msg = NULL;
+	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_PUBLISHACK_MAXSIZE_BYTES)) == NULL) ||
+			!cxa_mqtt_message_publishAck_init(msg, typeIn, packetIdIn) ||
+			!writePacket(clientIn, msg) )
+	{
+		retVal = false;
+	}
+	if( msg != NULL ) cxa_mqtt_messageFactory_decrementMessageRefCount(msg);
+
+	return retVal;
+}
+
+
+static bool writePacket(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+	if( clientIn->txCoalesce.isEnabled )
+	{
+		cxa_fixedByteBuffer_t* packet = cxa_mqtt_message_getBuffer(msgIn);
+		if( !cxa_mqtt_message_updateVariableLengthField(msgIn) ) return false;
+
+		// flush on size
+		size_t packetSize_bytes = cxa_fixedByteBuffer_getSize_bytes(packet);
+		if( (packetSize_bytes > cxa_fixedByteBuffer_getFreeSize_bytes(&clientIn->txCoalesce.fbb)) && !cxa_mqtt_client_flush(clientIn) ) return false;
+
+		// packets that will never fit go straight out
+		if( packetSize_bytes > cxa_fixedByteBuffer_getFreeSize_bytes(&clientIn->txCoalesce.fbb) ) return cxa_ioStream_writeFixedByteBuffer(clientIn->mpp.super.ioStream, packet);
+
+		// the deadline starts with the first buffered packet
+		if( cxa_fixedByteBuffer_isEmpty(&clientIn->txCoalesce.fbb) )
+		{
+			cxa_timeDiff_setStartTime_now(&clientIn->txCoalesce.td_firstQueued);
+			cxa_runLoop_requestWakeWithin_ms(clientIn->threadId, clientIn->txCoalesce.maxLatency_ms);
 		}
+		return cxa_fixedByteBuffer_append_fbb(&clientIn->txCoalesce.fbb, packet);
+	}
+#endif
+
+	return cxa_protocolParser_writePacket(&clientIn->mpp.super, cxa_mqtt_message_getBuffer(msgIn));
+}
+
+
+static bool writePacket_withPayload(cxa_mqtt_client_t *const clientIn, cxa_mqtt_message_t *const msgIn, void *const payloadIn, size_t payloadLen_bytesIn)
+{
+	cxa_assert(clientIn);
+	cxa_assert(msgIn);
+
+	if( (payloadIn == NULL) || (payloadLen_bytesIn == 0) ) return writePacket(clientIn, msgIn);
+
+	// the payload isn't in our message, but it is part of the packet
+	if( !cxa_mqtt_message_updateVariableLengthField_withTrailingBytes(msgIn, payloadLen_bytesIn) ) return false;
+
+	// anything already buffered must go out first
+	if( !cxa_mqtt_client_flush(clientIn) ) return false;
 
-		// notify our listeners
-		notify_activity(clientIn);
-	} else cxa_logger_warn(&clientIn->logger, "malformed PUBLISH");
-}
-
-
-
-// taken from: http://git.eclipse.org/c/paho/org.eclipse.paho.mqtt.embedded-c.git/tree/MQTTClient-C/src/MQTTClient.c
-// assume topic filter and name is in correct format
-// # can only be at end
-// + and # can only be next to separator
-// modified to more-fully match specification
-static bool doesTopicMatchFilter(char* topicIn, char* filterIn)
-{
-    char* curf = filterIn;
-    char* curn = topicIn;
-    char* curn_end = curn + strlen(topicIn);
-
-    while (*curf && curn < curn_end)
-    {
-        if (*curn == '/' && *curf != '/')
-            break;
-        if (*curf != '+' && *curf != '#' && *curf != *curn)
-            break;
-        if (*curf == '+')
-        {   // skip until we meet the next separator, or end of string
-            char* nextpos = curn + 1;
-            while (nextpos < curn_end && *nextpos != '/')
-                nextpos = ++curn + 1;
-        }
-        else if (*curf == '#')
-        {
-            curn = curn_end - 1;    // skip until end of string
-        }
-        curf++;
-        curn++;
-    };
-
-    // special case...look for remaining /# in filter
-    if( *curf == '/' ) curf++;
-    if( *curf == '#' ) curf++;
-
-    return (curn == curn_end) && (*curf == '\0');
+	cxa_fixedByteBuffer_t* header = cxa_mqtt_message_getBuffer(msgIn);
+	cxa_ioStream_ioVec_t iov[] = {
+		{ .buff = cxa_fixedByteBuffer_get_pointerToIndex(header, 0), .size_bytes = cxa_fixedByteBuffer_getSize_bytes(header) },
+		{ .buff = payloadIn, .size_bytes = payloadLen_bytesIn }
+	};
+	return cxa_ioStream_writeBytes_vectored(clientIn->mpp.super.ioStream, iov, (sizeof(iov)/sizeof(*iov)));
 }
 
 
+#ifdef CXA_MQTT_CLIENT_TXCOALESCE_ENABLE
+static void txCoalesce_flushIfDue(cxa_mqtt_client_t *const clientIn)
+{
+	cxa_assert(clientIn);
+
+	if( cxa_fixedByteBuffer_isEmpty(&clientIn->txCoalesce.fbb) ) return;
+	if( !cxa_timeDiff_isElapsed_ms(&clientIn->txCoalesce.td_firstQueued, clientIn->txCoalesce.maxLatency_ms) ) return;
+
+	cxa_mqtt_client_flush(clientIn);
+}
+#endif
+
+
 static void notify_activity(cxa_mqtt_client_t *const clientIn)
 {
 	cxa_assert(clientIn);
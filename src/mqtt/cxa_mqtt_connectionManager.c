@@ -34,9 +34,6 @@
 #define NVSKEY_CLIENT_CERT					"clientCert"
 #define NVSKEY_CLIENT_KEY					"clientKey"
 
-#define STANDOFF_MAX_MS						10000
-#define STANDOFF_MIN_MS						5000
-
 
 // ******** local type definitions ********
 typedef enum
@@ -58,6 +55,8 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int nextStat
 static void stateCb_connectStandOff_enter(cxa_stateMachine_t *const smIn, int nextStateIdIn, void *userVarIn);
 static void stateCb_connectStandOff_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 
+static uint32_t getStandoff_ms(void);
+
 #ifdef CXA_CONSOLE_ENABLE
 static void consoleCb_areCredentialsSet(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
 static void consoleCb_clearCredentials(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn);
@@ -148,6 +147,12 @@ void cxa_mqtt_connManager_setStandoffManagementCbs(cxa_mqtt_connManager_entering
 }
 
 
+void cxa_mqtt_connManager_setPersistentSession(bool persistentSessionIn)
+{
+	cxa_mqtt_client_setCleanSession(&mqttClient.super, !persistentSessionIn);
+}
+
+
 bool cxa_mqtt_connManager_areCredentialsSet(void)
 {
 	return (isSet_clientCert && isSet_clientPrivateKey && isSet_serverRootCert);
@@ -255,7 +260,7 @@ static void stateCb_connected_enter(cxa_stateMachine_t *const smIn, int nextStat
 
 static void stateCb_connectStandOff_enter(cxa_stateMachine_t *const smIn, int nextStateIdIn, void *userVarIn)
 {
-	connStandoff_ms = rand() % (STANDOFF_MAX_MS - STANDOFF_MIN_MS) + STANDOFF_MIN_MS;
+	connStandoff_ms = getStandoff_ms();
 	cxa_logger_info(&logger, "retry connection after %d ms", connStandoff_ms);
 	if( cb_enteringStandoff != NULL ) cb_enteringStandoff(userVar);
 	cxa_timeDiff_setStartTime_now(&td_connStandoff);
@@ -280,6 +285,23 @@ static void stateCb_connectStandOff_state(cxa_stateMachine_t *const smIn, void *
 }
 
 
+static uint32_t getStandoff_ms(void)
+{
+	// jitter window doubles with each consecutive failure after the first (up to our max)
+	// (a disconnect, or the first failure, uses the initial window)
+	uint32_t jitterWindow_ms = CXA_MQTT_CONNMAN_STANDOFF_INITIALJITTER_MS;
+	for( uint32_t i = 1; (i < numFailedConnects) && (jitterWindow_ms < CXA_MQTT_CONNMAN_STANDOFF_MAXJITTER_MS); i++ )
+	{
+		jitterWindow_ms *= 2;
+	}
+	if( jitterWindow_ms > CXA_MQTT_CONNMAN_STANDOFF_MAXJITTER_MS ) jitterWindow_ms = CXA_MQTT_CONNMAN_STANDOFF_MAXJITTER_MS;
+
+	// RAND_MAX may be as small as 32767
+	uint32_t randVal = (((uint32_t)rand()) << 16) ^ ((uint32_t)rand());
+	return CXA_MQTT_CONNMAN_STANDOFF_MIN_MS + (randVal % (jitterWindow_ms + 1));
+}
+
+
 #ifdef CXA_CONSOLE_ENABLE
 static void consoleCb_areCredentialsSet(cxa_array_t *const argsIn, cxa_ioStream_t *const ioStreamIn, void* userVarIn)
 {
@@ -9,38 +9,67 @@
 
 // ******** includes ********
 #include <stddef.h>
-#include <cxa_array.h>
 #include <cxa_assert.h>
+#include <cxa_blockPool.h>
 
 #define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
 #include <cxa_logger_implementation.h>
 
 
 // ******** local macro definitions ********
+#define NUM_SIZE_CLASSES				(1 + (CXA_MQTT_MESSAGEFACTORY_SMALL_NUM_MESSAGES > 0) + \
+										 (CXA_MQTT_MESSAGEFACTORY_MEDIUM_NUM_MESSAGES > 0) + \
+										 (CXA_MQTT_MESSAGEFACTORY_LARGE_NUM_MESSAGES > 0))
+
+// a message entry immediately followed by its buffer
+#define MESSAGE_BLOCK_TYPE(msgSize_bytesIn)			struct { messageEntry_t entry; uint8_t msgBuffer_raw[msgSize_bytesIn]; }
+
+#define initSizeClass_std(blocksIn)		initSizeClass((blocksIn), sizeof(*(blocksIn)), sizeof(blocksIn), sizeof((blocksIn)->msgBuffer_raw))
 
 
 // ******** local type definitions ********
 typedef struct
 {
+	void* poolLink;				// used by our size class' pool while free
 	uint8_t refCount;
+	uint8_t sizeClassIndex;
 
 	cxa_mqtt_message_t msg;
 
 	cxa_fixedByteBuffer_t msgFbb;
-	uint8_t msgBuffer_raw[CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES];
 }messageEntry_t;
 
 
+typedef struct
+{
+	cxa_blockPool_t pool;
+	size_t msgSize_bytes;
+}sizeClass_t;
+
+
 // ******** local function prototypes ********
 static void initIfNeeded(void);
+static void initSizeClass(void *const blocksIn, size_t blockSize_bytesIn, size_t blocksSize_bytesIn, size_t msgSize_bytesIn);
 static messageEntry_t* getMsgEntryFromMessage(cxa_mqtt_message_t *const msgIn);
 
 
 // ********  local variable declarations *********
 static bool isInit = false;
 
-static cxa_array_t msgEntries;
-static messageEntry_t msgEntries_raw[CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES];
+// ordered smallest to largest
+static sizeClass_t sizeClasses[NUM_SIZE_CLASSES];
+static size_t numSizeClasses = 0;
+
+#if CXA_MQTT_MESSAGEFACTORY_SMALL_NUM_MESSAGES > 0
+static MESSAGE_BLOCK_TYPE(CXA_MQTT_MESSAGEFACTORY_SMALL_MESSAGE_SIZE_BYTES) msgBlocks_small[CXA_MQTT_MESSAGEFACTORY_SMALL_NUM_MESSAGES];
+#endif
+#if CXA_MQTT_MESSAGEFACTORY_MEDIUM_NUM_MESSAGES > 0
+static MESSAGE_BLOCK_TYPE(CXA_MQTT_MESSAGEFACTORY_MEDIUM_MESSAGE_SIZE_BYTES) msgBlocks_medium[CXA_MQTT_MESSAGEFACTORY_MEDIUM_NUM_MESSAGES];
+#endif
+#if CXA_MQTT_MESSAGEFACTORY_LARGE_NUM_MESSAGES > 0
+static MESSAGE_BLOCK_TYPE(CXA_MQTT_MESSAGEFACTORY_LARGE_MESSAGE_SIZE_BYTES) msgBlocks_large[CXA_MQTT_MESSAGEFACTORY_LARGE_NUM_MESSAGES];
+#endif
+static MESSAGE_BLOCK_TYPE(CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES) msgBlocks_max[CXA_MQTT_MESSAGEFACTORY_NUM_MESSAGES];
 
 static cxa_logger_t logger;
 
@@ -50,39 +79,83 @@ size_t cxa_mqtt_messageFactory_getNumFreeMessages(void)
 {
 	initIfNeeded();
 
-	size_t numFreeMessages = 0;
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	size_t retVal = 0;
+	for( size_t i = 0; i < numSizeClasses; i++ )
 	{
-		if( currEntry == NULL ) continue;
+		retVal += cxa_blockPool_getNumFree(&sizeClasses[i].pool);
+	}
+	return retVal;
+}
+
+
+size_t cxa_mqtt_messageFactory_getHighWaterMark(void)
+{
+	initIfNeeded();
 
-		if( currEntry->refCount == 0 ) numFreeMessages++;
+	size_t retVal = 0;
+	for( size_t i = 0; i < numSizeClasses; i++ )
+	{
+		retVal += cxa_blockPool_getHighWaterMark(&sizeClasses[i].pool);
 	}
+	return retVal;
+}
+
+
+size_t cxa_mqtt_messageFactory_getNumExhausted(void)
+{
+	initIfNeeded();
 
-	return numFreeMessages;
+	size_t retVal = 0;
+	for( size_t i = 0; i < numSizeClasses; i++ )
+	{
+		retVal += cxa_blockPool_getNumExhausted(&sizeClasses[i].pool);
+	}
+	return retVal;
 }
 
 
 cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_empty(void)
+{
+	return cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES);
+}
+
+
+cxa_mqtt_message_t* cxa_mqtt_messageFactory_getFreeMessage_withCapacity(size_t capacity_bytesIn)
 {
 	initIfNeeded();
 
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	// smallest class that fits first
+	messageEntry_t* newEntry = NULL;
+	for( size_t i = 0; (i < numSizeClasses) && (newEntry == NULL); i++ )
 	{
-		if( currEntry == NULL) continue;
-
-		if( currEntry->refCount == 0 )
-		{
-			currEntry->refCount = 1;
-			cxa_logger_trace(&logger, "message %p newly reserved", &currEntry->msg);
+		if( sizeClasses[i].msgSize_bytes < capacity_bytesIn ) continue;
 
-			cxa_fixedByteBuffer_clear(&currEntry->msgFbb);
-			cxa_mqtt_message_initEmpty(&currEntry->msg, &currEntry->msgFbb);
-			return &currEntry->msg;
-		}
+		newEntry = (messageEntry_t*)cxa_blockPool_reserve(&sizeClasses[i].pool);
+	}
+	if( newEntry == NULL )
+	{
+		if( capacity_bytesIn > CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES ) cxa_logger_warn(&logger, "no messages large enough for %d bytes", (int)capacity_bytesIn);
+		else cxa_logger_warn(&logger, "no free messages!");
+		return NULL;
 	}
 
-	cxa_logger_warn(&logger, "no free messages!");
-	return NULL;
+	newEntry->refCount = 1;
+	cxa_logger_trace(&logger, "message %p newly reserved (%d bytes)", &newEntry->msg, (int)sizeClasses[newEntry->sizeClassIndex].msgSize_bytes);
+
+	cxa_fixedByteBuffer_clear(&newEntry->msgFbb);
+	cxa_mqtt_message_initEmpty(&newEntry->msg, &newEntry->msgFbb);
+	return &newEntry->msg;
+}
+
+
+size_t cxa_mqtt_messageFactory_getCapacity_bytes(cxa_mqtt_message_t *const msgIn)
+{
+	initIfNeeded();
+
+	messageEntry_t* targetEntry = getMsgEntryFromMessage(msgIn);
+	cxa_assert(targetEntry);
+
+	return sizeClasses[targetEntry->sizeClassIndex].msgSize_bytes;
 }
 
 
@@ -93,11 +166,12 @@ cxa_mqtt_message_t* cxa_mqtt_messageFactory_getMessage_byBuffer(cxa_fixedByteBuf
 	// simple case (better than an assert in this case)
 	if( fbbIn == NULL) return NULL;
 
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	for( size_t i = 0; i < numSizeClasses; i++ )
 	{
-		if( currEntry == NULL) continue;
+		messageEntry_t* targetEntry = (messageEntry_t*)cxa_blockPool_getBlock_byPointer(&sizeClasses[i].pool, fbbIn);
+		if( targetEntry == NULL ) continue;
 
-		if( (currEntry->refCount != 0) && (&currEntry->msgFbb == fbbIn) ) return &currEntry->msg;
+		return ((targetEntry->refCount != 0) && (&targetEntry->msgFbb == fbbIn)) ? &targetEntry->msg : NULL;
 	}
 
 	// if we made it here, we couldn't find a match
@@ -110,7 +184,7 @@ void cxa_mqtt_messageFactory_incrementMessageRefCount(cxa_mqtt_message_t *const
 	initIfNeeded();
 
 	messageEntry_t* targetEntry = getMsgEntryFromMessage(msgIn);
-	cxa_assert( targetEntry && (targetEntry->refCount < UINT8_MAX) );
+	cxa_assert( targetEntry && (targetEntry->refCount > 0) && (targetEntry->refCount < UINT8_MAX) );
 
 	targetEntry->refCount++;
 	cxa_logger_trace(&logger, "message %p referenced (%d)", &targetEntry->msg, targetEntry->refCount);
@@ -129,6 +203,8 @@ void cxa_mqtt_messageFactory_decrementMessageRefCount(cxa_mqtt_message_t *const
 	{
 		targetEntry->refCount--;
 		cxa_logger_trace(&logger, "message %p dereferenced (%d)", &targetEntry->msg, targetEntry->refCount);
+
+		if( targetEntry->refCount == 0 ) cxa_blockPool_release(&sizeClasses[targetEntry->sizeClassIndex].pool, targetEntry);
 	}
 	else cxa_logger_warn(&logger, "mismatched decrement call for %p", &targetEntry->msg);
 }
@@ -153,28 +229,52 @@ static void initIfNeeded(void)
 	// initialize our logger
 	cxa_logger_init(&logger, "mqttMsgFactory");
 
-	// initialize our messages
-	cxa_array_init_inPlace(&msgEntries, sizeof(*msgEntries_raw), (sizeof(msgEntries_raw)/sizeof(*msgEntries_raw)), (void*)msgEntries_raw, sizeof(msgEntries_raw));
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	// initialize our size classes (smallest first)
+#if CXA_MQTT_MESSAGEFACTORY_SMALL_NUM_MESSAGES > 0
+	initSizeClass_std(msgBlocks_small);
+#endif
+#if CXA_MQTT_MESSAGEFACTORY_MEDIUM_NUM_MESSAGES > 0
+	initSizeClass_std(msgBlocks_medium);
+#endif
+#if CXA_MQTT_MESSAGEFACTORY_LARGE_NUM_MESSAGES > 0
+	initSizeClass_std(msgBlocks_large);
+#endif
+	initSizeClass_std(msgBlocks_max);
+
+	isInit = true;
+}
+
+
+static void initSizeClass(void *const blocksIn, size_t blockSize_bytesIn, size_t blocksSize_bytesIn, size_t msgSize_bytesIn)
+{
+	cxa_assert(numSizeClasses < NUM_SIZE_CLASSES);
+	cxa_assert_msg((numSizeClasses == 0) || (sizeClasses[numSizeClasses-1].msgSize_bytes < msgSize_bytesIn), "size classes must increase in size");
+
+	sizeClass_t* newClass = &sizeClasses[numSizeClasses];
+	newClass->msgSize_bytes = msgSize_bytesIn;
+
+	// each buffer directly follows its entry (see MESSAGE_BLOCK_TYPE)
+	for( size_t i = 0; i < (blocksSize_bytesIn / blockSize_bytesIn); i++ )
 	{
-		cxa_assert(currEntry);
-		cxa_fixedByteBuffer_initStd(&currEntry->msgFbb, currEntry->msgBuffer_raw);
+		messageEntry_t* currEntry = (messageEntry_t*)&((uint8_t*)blocksIn)[i * blockSize_bytesIn];
+		size_t headroom_bytes = (msgSize_bytesIn * CXA_MQTT_MESSAGEFACTORY_HEADROOM_BYTES) / CXA_MQTT_MESSAGEFACTORY_MESSAGE_SIZE_BYTES;
+		cxa_fixedByteBuffer_init_withHeadroom(&currEntry->msgFbb, (uint8_t*)(currEntry + 1), msgSize_bytesIn, headroom_bytes);
 
 		currEntry->refCount = 0;
+		currEntry->sizeClassIndex = numSizeClasses;
 	}
+	cxa_blockPool_init(&newClass->pool, blockSize_bytesIn, blocksIn, blocksSize_bytesIn);
 
-
-	isInit = true;
+	numSizeClasses++;
 }
 
 
 static messageEntry_t* getMsgEntryFromMessage(cxa_mqtt_message_t *const msgIn)
 {
-	cxa_array_iterate(&msgEntries, currEntry, messageEntry_t)
+	for( size_t i = 0; i < numSizeClasses; i++ )
 	{
-		if( currEntry == NULL ) continue;
-
-		if( &currEntry->msg == msgIn ) return currEntry;
+		messageEntry_t* targetEntry = (messageEntry_t*)cxa_blockPool_getBlock_byPointer(&sizeClasses[i].pool, msgIn);
+		if( targetEntry != NULL ) return (&targetEntry->msg == msgIn) ? targetEntry : NULL;
 	}
 
 	return NULL;
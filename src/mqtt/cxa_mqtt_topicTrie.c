@@ -0,0 +1,290 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mqtt_topicTrie.h"
+
+
+// ******** includes ********
+#include <string.h>
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+#define ROOT_NODE_INDEX						0
+
+
+// ******** local type definitions ********
+typedef struct
+{
+	cxa_mqtt_topicTrie_t* trie;
+	const char* topicEnd;
+
+	cxa_mqtt_topicTrie_cb_onMatch_t cb_onMatch;
+	void* userVar;
+}matchContext_t;
+
+
+// ******** local function prototypes ********
+static uint16_t addNode(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn);
+static uint16_t getOrAddChild(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn);
+static uint16_t getExactChild(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn);
+static uint16_t getBucketIndex(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn);
+static size_t matchNode(matchContext_t *const ctxIn, uint16_t nodeIndexIn, const char* levelIn, bool hasLevelIn, bool isFirstLevelIn);
+static size_t reportEntries(matchContext_t *const ctxIn, uint16_t nodeIndexIn);
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+void cxa_mqtt_topicTrie_init(cxa_mqtt_topicTrie_t *const trieIn,
+							 cxa_mqtt_topicTrie_node_t *const nodesIn, size_t nodesSize_bytesIn,
+							 uint16_t *const entryNextIn, size_t entryNextSize_bytesIn)
+{
+	cxa_assert(trieIn);
+	cxa_assert(nodesIn);
+	cxa_assert(entryNextIn);
+
+	// save our references
+	trieIn->nodes = nodesIn;
+	trieIn->maxNumNodes = nodesSize_bytesIn / sizeof(*nodesIn);
+	trieIn->entryNext = entryNextIn;
+	trieIn->maxNumEntries = entryNextSize_bytesIn / sizeof(*entryNextIn);
+	cxa_assert( (trieIn->maxNumNodes > 0) && (trieIn->maxNumNodes < CXA_MQTT_TOPICTRIE_INDEX_NONE) );
+	cxa_assert( trieIn->maxNumEntries < CXA_MQTT_TOPICTRIE_INDEX_NONE );
+
+	cxa_mqtt_topicTrie_clear(trieIn);
+}
+
+
+void cxa_mqtt_topicTrie_clear(cxa_mqtt_topicTrie_t *const trieIn)
+{
+	cxa_assert(trieIn);
+
+	// every node slot doubles as a hash bucket, so they all need to be reset
+	for( size_t i = 0; i < trieIn->maxNumNodes; i++ )
+	{
+		trieIn->nodes[i].bucketHead = CXA_MQTT_TOPICTRIE_INDEX_NONE;
+	}
+	trieIn->numNodes = 0;
+
+	// add our root node
+	addNode(trieIn, CXA_MQTT_TOPICTRIE_INDEX_NONE, NULL, 0);
+}
+
+
+bool cxa_mqtt_topicTrie_insert(cxa_mqtt_topicTrie_t *const trieIn, const char *const filterIn, uint16_t entryIndexIn)
+{
+	cxa_assert(trieIn);
+	cxa_assert(filterIn);
+
+	// validate up-front so a malformed filter doesn't leave orphaned nodes behind
+	if( (entryIndexIn >= trieIn->maxNumEntries) || !cxa_mqtt_topicTrie_validateFilter(filterIn, NULL) ) return false;
+
+	// walk (and build) the path for each level of the filter
+	uint16_t currNodeIndex = ROOT_NODE_INDEX;
+	const char* currLevel = filterIn;
+	while( true )
+	{
+		const char* levelEnd = strchr(currLevel, '/');
+		if( levelEnd == NULL ) levelEnd = currLevel + strlen(currLevel);
+		size_t levelLen_bytes = levelEnd - currLevel;
+
+		currNodeIndex = getOrAddChild(trieIn, currNodeIndex, currLevel, levelLen_bytes);
+		if( currNodeIndex == CXA_MQTT_TOPICTRIE_INDEX_NONE ) return false;
+
+		if( *levelEnd == 0 ) break;
+		currLevel = levelEnd + 1;
+	}
+
+	// append our entry to the end of this node's entries (preserves insertion order)
+	cxa_mqtt_topicTrie_node_t* node = &trieIn->nodes[currNodeIndex];
+	trieIn->entryNext[entryIndexIn] = CXA_MQTT_TOPICTRIE_INDEX_NONE;
+	if( node->firstEntry == CXA_MQTT_TOPICTRIE_INDEX_NONE )
+	{
+		node->firstEntry = entryIndexIn;
+	}
+	else
+	{
+		uint16_t lastEntry = node->firstEntry;
+		while( trieIn->entryNext[lastEntry] != CXA_MQTT_TOPICTRIE_INDEX_NONE ) lastEntry = trieIn->entryNext[lastEntry];
+		trieIn->entryNext[lastEntry] = entryIndexIn;
+	}
+
+	return true;
+}
+
+
+bool cxa_mqtt_topicTrie_validateFilter(const char *const filterIn, size_t *const numLevelsOut)
+{
+	cxa_assert(filterIn);
+
+	// topic filters must be at least one character
+	if( *filterIn == 0 ) return false;
+
+	size_t numLevels = 0;
+	const char* currLevel = filterIn;
+	while( true )
+	{
+		const char* levelEnd = strchr(currLevel, '/');
+		if( levelEnd == NULL ) levelEnd = currLevel + strlen(currLevel);
+		size_t levelLen_bytes = levelEnd - currLevel;
+		numLevels++;
+
+		// '#' must occupy an entire level and must be the last level
+		if( (memchr(currLevel, '#', levelLen_bytes) != NULL) && ((levelLen_bytes != 1) || (*levelEnd != 0)) ) return false;
+		// '+' must occupy an entire level
+		if( (memchr(currLevel, '+', levelLen_bytes) != NULL) && (levelLen_bytes != 1) ) return false;
+
+		if( *levelEnd == 0 ) break;
+		currLevel = levelEnd + 1;
+	}
+
+	if( numLevelsOut != NULL ) *numLevelsOut = numLevels;
+	return true;
+}
+
+
+size_t cxa_mqtt_topicTrie_match(cxa_mqtt_topicTrie_t *const trieIn, const char *const topicIn, size_t topicLen_bytesIn,
+								cxa_mqtt_topicTrie_cb_onMatch_t cb_onMatchIn, void *const userVarIn)
+{
+	cxa_assert(trieIn);
+
+	// topic names must be at least one character
+	if( (topicIn == NULL) || (topicLen_bytesIn == 0) ) return 0;
+
+	matchContext_t ctx = {
+			.trie = trieIn,
+			.topicEnd = topicIn + topicLen_bytesIn,
+			.cb_onMatch = cb_onMatchIn,
+			.userVar = userVarIn
+	};
+	return matchNode(&ctx, ROOT_NODE_INDEX, topicIn, true, true);
+}
+
+
+// ******** local function implementations ********
+static uint16_t addNode(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	if( (trieIn->numNodes >= trieIn->maxNumNodes) || (levelLen_bytesIn >= CXA_MQTT_TOPICTRIE_INDEX_NONE) ) return CXA_MQTT_TOPICTRIE_INDEX_NONE;
+
+	uint16_t newNodeIndex = trieIn->numNodes++;
+	cxa_mqtt_topicTrie_node_t* newNode = &trieIn->nodes[newNodeIndex];
+
+	// don't touch bucketHead...it belongs to the hash table, not this node
+	newNode->level = levelIn;
+	newNode->levelLen_bytes = levelLen_bytesIn;
+	newNode->parent = parentIndexIn;
+	newNode->nextInBucket = CXA_MQTT_TOPICTRIE_INDEX_NONE;
+	newNode->plusChild = CXA_MQTT_TOPICTRIE_INDEX_NONE;
+	newNode->hashChild = CXA_MQTT_TOPICTRIE_INDEX_NONE;
+	newNode->firstEntry = CXA_MQTT_TOPICTRIE_INDEX_NONE;
+
+	return newNodeIndex;
+}
+
+
+static uint16_t getOrAddChild(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	// wildcards are linked directly from their parent
+	uint16_t* wildcardChild = NULL;
+	if( (levelLen_bytesIn == 1) && (*levelIn == '+') ) wildcardChild = &trieIn->nodes[parentIndexIn].plusChild;
+	else if( (levelLen_bytesIn == 1) && (*levelIn == '#') ) wildcardChild = &trieIn->nodes[parentIndexIn].hashChild;
+
+	if( wildcardChild != NULL )
+	{
+		if( *wildcardChild == CXA_MQTT_TOPICTRIE_INDEX_NONE ) *wildcardChild = addNode(trieIn, parentIndexIn, levelIn, levelLen_bytesIn);
+		return *wildcardChild;
+	}
+
+	// exact levels are found via the hash table
+	uint16_t childIndex = getExactChild(trieIn, parentIndexIn, levelIn, levelLen_bytesIn);
+	if( childIndex != CXA_MQTT_TOPICTRIE_INDEX_NONE ) return childIndex;
+
+	childIndex = addNode(trieIn, parentIndexIn, levelIn, levelLen_bytesIn);
+	if( childIndex == CXA_MQTT_TOPICTRIE_INDEX_NONE ) return CXA_MQTT_TOPICTRIE_INDEX_NONE;
+
+	cxa_mqtt_topicTrie_node_t* bucket = &trieIn->nodes[getBucketIndex(trieIn, parentIndexIn, levelIn, levelLen_bytesIn)];
+	trieIn->nodes[childIndex].nextInBucket = bucket->bucketHead;
+	bucket->bucketHead = childIndex;
+
+	return childIndex;
+}
+
+
+static uint16_t getExactChild(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	uint16_t currIndex = trieIn->nodes[getBucketIndex(trieIn, parentIndexIn, levelIn, levelLen_bytesIn)].bucketHead;
+	while( currIndex != CXA_MQTT_TOPICTRIE_INDEX_NONE )
+	{
+		cxa_mqtt_topicTrie_node_t* currNode = &trieIn->nodes[currIndex];
+		if( (currNode->parent == parentIndexIn) &&
+			(currNode->levelLen_bytes == levelLen_bytesIn) &&
+			(memcmp(currNode->level, levelIn, levelLen_bytesIn) == 0) ) return currIndex;
+
+		currIndex = currNode->nextInBucket;
+	}
+
+	return CXA_MQTT_TOPICTRIE_INDEX_NONE;
+}
+
+
+static uint16_t getBucketIndex(cxa_mqtt_topicTrie_t *const trieIn, uint16_t parentIndexIn, const char *const levelIn, size_t levelLen_bytesIn)
+{
+	// FNV-1a over the parent index and level
+	uint32_t hash = 2166136261u;
+	hash = (hash ^ (parentIndexIn & 0xFF)) * 16777619u;
+	hash = (hash ^ (parentIndexIn >> 8)) * 16777619u;
+	for( size_t i = 0; i < levelLen_bytesIn; i++ )
+	{
+		hash = (hash ^ (uint8_t)levelIn[i]) * 16777619u;
+	}
+
+	return hash % trieIn->maxNumNodes;
+}
+
+
+static size_t matchNode(matchContext_t *const ctxIn, uint16_t nodeIndexIn, const char* levelIn, bool hasLevelIn, bool isFirstLevelIn)
+{
+	cxa_mqtt_topicTrie_node_t* node = &ctxIn->trie->nodes[nodeIndexIn];
+	size_t numMatches = 0;
+
+	// if we've consumed the entire topic, this node is a match
+	if( !hasLevelIn ) numMatches += reportEntries(ctxIn, nodeIndexIn);
+
+	// wildcards don't match topics starting with '$' (at the first level)
+	bool canMatchWildcards = !(isFirstLevelIn && (levelIn < ctxIn->topicEnd) && (*levelIn == '$'));
+
+	// '#' matches this level (if any) and everything below it
+	if( canMatchWildcards && (node->hashChild != CXA_MQTT_TOPICTRIE_INDEX_NONE) ) numMatches += reportEntries(ctxIn, node->hashChild);
+
+	if( !hasLevelIn ) return numMatches;
+
+	// figure out where our current topic level ends (and whether there is another)
+	const char* levelEnd = memchr(levelIn, '/', ctxIn->topicEnd - levelIn);
+	bool hasNextLevel = (levelEnd != NULL);
+	if( levelEnd == NULL ) levelEnd = ctxIn->topicEnd;
+	const char* nextLevel = hasNextLevel ? (levelEnd + 1) : NULL;
+
+	uint16_t exactChild = getExactChild(ctxIn->trie, nodeIndexIn, levelIn, levelEnd - levelIn);
+	if( exactChild != CXA_MQTT_TOPICTRIE_INDEX_NONE ) numMatches += matchNode(ctxIn, exactChild, nextLevel, hasNextLevel, false);
+
+	if( canMatchWildcards && (node->plusChild != CXA_MQTT_TOPICTRIE_INDEX_NONE) ) numMatches += matchNode(ctxIn, node->plusChild, nextLevel, hasNextLevel, false);
+
+	return numMatches;
+}
+
+
+static size_t reportEntries(matchContext_t *const ctxIn, uint16_t nodeIndexIn)
+{
+	size_t numEntries = 0;
+	for( uint16_t currEntry = ctxIn->trie->nodes[nodeIndexIn].firstEntry; currEntry != CXA_MQTT_TOPICTRIE_INDEX_NONE; currEntry = ctxIn->trie->entryNext[currEntry] )
+	{
+		if( ctxIn->cb_onMatch != NULL ) ctxIn->cb_onMatch(currEntry, ctxIn->userVar);
+		numEntries++;
+	}
+	return numEntries;
+}
@@ -12,6 +12,7 @@
 #include <cxa_assert.h>
 #include <cxa_mqtt_message.h>
 #include <cxa_mqtt_messageFactory.h>
+#include <cxa_numberUtils.h>
 
 #define CXA_LOG_LEVEL			CXA_LOG_LEVEL_INFO
 #include <cxa_logger_implementation.h>
@@ -24,6 +25,7 @@
 #define ERR_MALFORMED_PACKET		"malformed packet"
 #define ERR_MALFORMED_HEADER		"malformed header"
 #define ERR_INTERBYTE_TIMEOUT		"inter-byte timeout"
+#define ERR_TOO_LARGE				"packet too large, discarding"
 
 
 // ******** local type definitions ********
@@ -33,6 +35,9 @@ typedef enum
 	RX_STATE_WAIT_FIXEDHEADER_1,
 	RX_STATE_WAIT_REMAINING_LEN,
 	RX_STATE_WAIT_DATABYTES,
+	RX_STATE_WAIT_STREAM_HEADER,
+	RX_STATE_STREAM_PAYLOAD,
+	RX_STATE_DISCARD,
 	RX_STATE_PROCESS_PACKET,
 	RX_STATE_ERROR
 }rxState_t;
@@ -51,6 +56,10 @@ static void rxState_cb_idle_leave(cxa_stateMachine_t *const smIn, int nextStateI
 static void rxStateCb_waitFixedHeader1_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void rxStateCb_waitRemainingLen_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void rxStateCb_waitDataBytes_state(cxa_stateMachine_t *const smIn, void *userVarIn);
+static void rxStateCb_waitStreamHeader_state(cxa_stateMachine_t *const smIn, void *userVarIn);
+static void rxStateCb_streamPayload_state(cxa_stateMachine_t *const smIn, void *userVarIn);
+static void rxStateCb_streamPayload_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void *userVarIn);
+static void rxStateCb_discard_state(cxa_stateMachine_t *const smIn, void *userVarIn);
 static void rxStateCb_processPacket_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 static void rxState_cb_error_enter(cxa_stateMachine_t *const smIn, int prevStateIdIn, void *userVarIn);
 
@@ -69,6 +78,11 @@ void cxa_protocolParser_mqtt_init(cxa_protocolParser_mqtt_t *const mppIn, cxa_io
 
 	// set some default values
 	mppIn->remainingBytesToReceive = 0;
+	mppIn->stream.cb_onBegin = NULL;
+	mppIn->stream.cb_onData = NULL;
+	mppIn->stream.cb_onEnd = NULL;
+	mppIn->stream.userVar = NULL;
+	mppIn->stream.headerLen_bytes = 0;
 
 	// setup our state machine
 	cxa_stateMachine_init(&mppIn->stateMachine, "mqttProtoParser", threadIdIn);
@@ -76,12 +90,32 @@ void cxa_protocolParser_mqtt_init(cxa_protocolParser_mqtt_t *const mppIn, cxa_io
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1, "wait_fh1", NULL, rxStateCb_waitFixedHeader1_state, NULL, (void*)mppIn);
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_WAIT_REMAINING_LEN, "wait_remLen", NULL, rxStateCb_waitRemainingLen_state, NULL, (void*)mppIn);
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_WAIT_DATABYTES, "wait_dataBytes", NULL, rxStateCb_waitDataBytes_state, NULL, (void*)mppIn);
+	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_WAIT_STREAM_HEADER, "wait_streamHeader", NULL, rxStateCb_waitStreamHeader_state, NULL, (void*)mppIn);
+	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_STREAM_PAYLOAD, "streamPayload", NULL, rxStateCb_streamPayload_state, rxStateCb_streamPayload_leave, (void*)mppIn);
+	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_DISCARD, "discard", NULL, rxStateCb_discard_state, NULL, (void*)mppIn);
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_PROCESS_PACKET, "processPacket", rxStateCb_processPacket_enter, NULL, NULL, (void*)mppIn);
 	cxa_stateMachine_addState(&mppIn->stateMachine, RX_STATE_ERROR, "error", rxState_cb_error_enter, NULL, NULL, (void*)mppIn);
 	cxa_stateMachine_setInitialState(&mppIn->stateMachine, RX_STATE_IDLE);
 }
 
 
+void cxa_protocolParser_mqtt_setStreamHandler(cxa_protocolParser_mqtt_t *const mppIn,
+											  cxa_protocolParser_mqtt_cb_onStreamBegin_t cb_onBeginIn,
+											  cxa_protocolParser_mqtt_cb_onStreamData_t cb_onDataIn,
+											  cxa_protocolParser_mqtt_cb_onStreamEnd_t cb_onEndIn,
+											  void *const userVarIn)
+{
+	cxa_assert(mppIn);
+	cxa_assert(cb_onBeginIn);
+	cxa_assert(cb_onDataIn);
+
+	mppIn->stream.cb_onBegin = cb_onBeginIn;
+	mppIn->stream.cb_onData = cb_onDataIn;
+	mppIn->stream.cb_onEnd = cb_onEndIn;
+	mppIn->stream.userVar = userVarIn;
+}
+
+
 // ******** local function implementations ********
 static bool scm_isInErrorState(cxa_protocolParser_t *const superIn)
 {
@@ -189,11 +223,15 @@ static void rxStateCb_waitFixedHeader1_state(cxa_stateMachine_t *const smIn, voi
 			case CXA_MQTT_MSGTYPE_PINGREQ:
 			case CXA_MQTT_MSGTYPE_PINGRESP:
 			case CXA_MQTT_MSGTYPE_SUBACK:
+			case CXA_MQTT_MSGTYPE_PUBACK:
+			case CXA_MQTT_MSGTYPE_PUBREC:
+			case CXA_MQTT_MSGTYPE_PUBCOMP:
 				// make sure the flags match
 				doFlagsMatch = (rxByte & 0x0F) == 0;
 				break;
 
 			case CXA_MQTT_MSGTYPE_SUBSCRIBE:
+			case CXA_MQTT_MSGTYPE_PUBREL:
 				// make sure the flags match
 				doFlagsMatch = (rxByte & 0x0F) == 0x02;
 				break;
@@ -267,6 +305,22 @@ static void rxStateCb_waitRemainingLen_state(cxa_stateMachine_t *const smIn, voi
 		{
 			mppIn->remainingBytesToReceive = actualLength;
 			cxa_logger_trace(&mppIn->super.logger, "waiting for %d bytes", mppIn->remainingBytesToReceive);
+
+			// packets that won't fit in our buffer are either streamed (PUBLISH) or skipped
+			if( actualLength > cxa_fixedByteBuffer_getFreeSize_bytes(mppIn->super.currBuffer) )
+			{
+				uint8_t headerByte = *cxa_fixedByteBuffer_get_pointerToIndex(mppIn->super.currBuffer, 0);
+				if( (mppIn->stream.cb_onBegin != NULL) && (cxa_mqtt_message_rxBytes_getType(headerByte) == CXA_MQTT_MSGTYPE_PUBLISH) )
+				{
+					cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_STREAM_HEADER);
+					return;
+				}
+
+				cxa_logger_warn(&mppIn->super.logger, ERR_TOO_LARGE);
+				cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_DISCARD);
+				return;
+			}
+
 			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_DATABYTES);
 			return;
 		}
@@ -308,14 +362,194 @@ static void rxStateCb_waitDataBytes_state(cxa_stateMachine_t *const smIn, void *
 		cxa_timeDiff_setStartTime_now(&mppIn->super.td_timeout);
 
 		// add to our buffer
+		mppIn->remainingBytesToReceive--;
 		if( !cxa_fixedByteBuffer_append_uint8(mppIn->super.currBuffer, rxByte) )
 		{
+			// don't try to interpret the rest of this packet as new packets
 			cxa_logger_warn(&mppIn->super.logger, ERR_FBB_OVERFLOW);
+			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_DISCARD);
+			return;
+		}
+	}
+	else if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
+	{
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
+		return;
+	}
+
+	// check to see if we've had a reception timeout
+	if( cxa_timeDiff_isElapsed_ms(&mppIn->super.td_timeout, RECEPTION_TIMEOUT_MS) )
+	{
+		cxa_protocolParser_notify_receptionTimeout(&mppIn->super);
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+		return;
+	}
+}
+
+
+static void rxStateCb_waitStreamHeader_state(cxa_stateMachine_t *const smIn, void *userVarIn)
+{
+	cxa_protocolParser_mqtt_t *mppIn = (cxa_protocolParser_mqtt_t*)userVarIn;
+	cxa_assert(mppIn);
+
+	uint8_t rxByte;
+	cxa_ioStream_readStatus_t readStat = cxa_ioStream_readByte(mppIn->super.ioStream, &rxByte);
+	if( readStat == CXA_IOSTREAM_READSTAT_GOTDATA )
+	{
+		// reset our reception timeout timeDiff
+		cxa_timeDiff_setStartTime_now(&mppIn->super.td_timeout);
+
+		// add to our buffer (the variable header must fit, even if the payload doesn't)
+		mppIn->remainingBytesToReceive--;
+		if( !cxa_fixedByteBuffer_append_uint8(mppIn->super.currBuffer, rxByte) )
+		{
+			cxa_logger_warn(&mppIn->super.logger, ERR_TOO_LARGE);
+			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_DISCARD);
+			return;
+		}
+
+		// variable header is: topic name (length-prefixed), packetId (QoS1/QoS2 only)
+		size_t remLenField_bytes;
+		cxa_mqtt_message_rxBytes_parseVariableLengthField(mppIn->super.currBuffer, NULL, NULL, &remLenField_bytes);
+		size_t varHeaderStartIndex = 1 + remLenField_bytes;
+		size_t numVarHeaderBytes = cxa_fixedByteBuffer_getSize_bytes(mppIn->super.currBuffer) - varHeaderStartIndex;
+		if( numVarHeaderBytes < 2 ) return;
+
+		uint8_t* varHeader = cxa_fixedByteBuffer_get_pointerToIndex(mppIn->super.currBuffer, varHeaderStartIndex);
+		cxa_mqtt_qosLevel_t qos = (cxa_mqtt_qosLevel_t)((*cxa_fixedByteBuffer_get_pointerToIndex(mppIn->super.currBuffer, 0) >> 1) & 0x03);
+		uint16_t topicNameLen_bytes = (varHeader[0] << 8) | varHeader[1];
+		size_t varHeaderLen_bytes = 2 + topicNameLen_bytes + ((qos != CXA_MQTT_QOS_ATMOST_ONCE) ? 2 : 0);
+
+		if( (qos > CXA_MQTT_QOS_EXACTLY_ONCE) || (varHeaderLen_bytes > (numVarHeaderBytes + mppIn->remainingBytesToReceive)) )
+		{
+			cxa_logger_debug(&mppIn->super.logger, ERR_MALFORMED_PACKET);
+			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_DISCARD);
+			return;
+		}
+		if( numVarHeaderBytes < varHeaderLen_bytes ) return;
+
+		// we have our entire variable header
+		if( cxa_fixedByteBuffer_getFreeSize_bytes(mppIn->super.currBuffer) < CXA_PROTOCOLPARSER_MQTT_MINSIZE_STREAMCHUNK_BYTES )
+		{
+			cxa_logger_warn(&mppIn->super.logger, ERR_TOO_LARGE);
+			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_DISCARD);
+			return;
+		}
+
+		uint16_t packetId = (qos != CXA_MQTT_QOS_ATMOST_ONCE) ? ((varHeader[2 + topicNameLen_bytes] << 8) | varHeader[3 + topicNameLen_bytes]) : 0;
+		mppIn->stream.headerLen_bytes = cxa_fixedByteBuffer_getSize_bytes(mppIn->super.currBuffer);
+		if( (mppIn->remainingBytesToReceive != 0) &&
+			mppIn->stream.cb_onBegin(qos, packetId, (char*)&varHeader[2], topicNameLen_bytes, mppIn->remainingBytesToReceive, mppIn->stream.userVar) )
+		{
+			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_STREAM_PAYLOAD);
+			return;
+		}
+
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_DISCARD);
+		return;
+	}
+	else if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
+	{
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
+		return;
+	}
+
+	// check to see if we've had a reception timeout
+	if( cxa_timeDiff_isElapsed_ms(&mppIn->super.td_timeout, RECEPTION_TIMEOUT_MS) )
+	{
+		cxa_protocolParser_notify_receptionTimeout(&mppIn->super);
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+		return;
+	}
+}
+
+
+static void rxStateCb_streamPayload_state(cxa_stateMachine_t *const smIn, void *userVarIn)
+{
+	cxa_protocolParser_mqtt_t *mppIn = (cxa_protocolParser_mqtt_t*)userVarIn;
+	cxa_assert(mppIn);
+
+	if( mppIn->remainingBytesToReceive == 0 )
+	{
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+		return;
+	}
+
+	// read whatever is available (up to the free space after our headers) so
+	// large payloads don't take one iteration per byte
+	size_t maxChunkSize_bytes = CXA_MIN(cxa_fixedByteBuffer_getFreeSize_bytes(mppIn->super.currBuffer), mppIn->remainingBytesToReceive);
+	size_t numBytesRead = 0;
+	uint8_t rxByte;
+	cxa_ioStream_readStatus_t readStat = CXA_IOSTREAM_READSTAT_NODATA;
+	while( (numBytesRead < maxChunkSize_bytes) &&
+		   ((readStat = cxa_ioStream_readByte(mppIn->super.ioStream, &rxByte)) == CXA_IOSTREAM_READSTAT_GOTDATA) )
+	{
+		cxa_fixedByteBuffer_append_uint8(mppIn->super.currBuffer, rxByte);
+		numBytesRead++;
+	}
+
+	if( numBytesRead > 0 )
+	{
+		// reset our reception timeout timeDiff
+		cxa_timeDiff_setStartTime_now(&mppIn->super.td_timeout);
+
+		mppIn->remainingBytesToReceive -= numBytesRead;
+		mppIn->stream.cb_onData(cxa_fixedByteBuffer_get_pointerToIndex(mppIn->super.currBuffer, mppIn->stream.headerLen_bytes), numBytesRead, mppIn->stream.userVar);
+		cxa_fixedByteBuffer_remove(mppIn->super.currBuffer, mppIn->stream.headerLen_bytes, numBytesRead);
+
+		if( mppIn->remainingBytesToReceive == 0 )
+		{
 			cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
 			return;
 		}
+	}
+
+	if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
+	{
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
+		return;
+	}
+
+	// check to see if we've had a reception timeout
+	if( cxa_timeDiff_isElapsed_ms(&mppIn->super.td_timeout, RECEPTION_TIMEOUT_MS) )
+	{
+		cxa_protocolParser_notify_receptionTimeout(&mppIn->super);
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+		return;
+	}
+}
+
+
+static void rxStateCb_streamPayload_leave(cxa_stateMachine_t *const smIn, int nextStateIdIn, void *userVarIn)
+{
+	cxa_protocolParser_mqtt_t *mppIn = (cxa_protocolParser_mqtt_t*)userVarIn;
+	cxa_assert(mppIn);
+
+	// anything left means we were interrupted (timeout, ioException, reset)
+	if( mppIn->stream.cb_onEnd != NULL ) mppIn->stream.cb_onEnd((mppIn->remainingBytesToReceive == 0), mppIn->stream.userVar);
+}
+
+
+static void rxStateCb_discard_state(cxa_stateMachine_t *const smIn, void *userVarIn)
+{
+	cxa_protocolParser_mqtt_t *mppIn = (cxa_protocolParser_mqtt_t*)userVarIn;
+	cxa_assert(mppIn);
+
+	// drop the rest of the packet (whatever is available)
+	uint8_t rxByte;
+	cxa_ioStream_readStatus_t readStat = CXA_IOSTREAM_READSTAT_NODATA;
+	while( (mppIn->remainingBytesToReceive > 0) &&
+		   ((readStat = cxa_ioStream_readByte(mppIn->super.ioStream, &rxByte)) == CXA_IOSTREAM_READSTAT_GOTDATA) )
+	{
+		cxa_timeDiff_setStartTime_now(&mppIn->super.td_timeout);
 		mppIn->remainingBytesToReceive--;
 	}
+
+	if( mppIn->remainingBytesToReceive == 0 )
+	{
+		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_WAIT_FIXEDHEADER_1);
+		return;
+	}
 	else if( readStat == CXA_IOSTREAM_READSTAT_ERROR )
 	{
 		cxa_stateMachine_transition(&mppIn->stateMachine, RX_STATE_ERROR);
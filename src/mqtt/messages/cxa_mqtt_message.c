@@ -16,6 +16,7 @@
 #include <cxa_mqtt_message_suback.h>
 #include <cxa_mqtt_message_subscribe.h>
 #include <cxa_mqtt_message_publish.h>
+#include <cxa_mqtt_message_publishAck.h>
 
 #define CXA_LOG_LEVEL				CXA_LOG_LEVEL_TRACE
 #include <cxa_logger_implementation.h>
@@ -29,6 +30,7 @@
 
 
 // ******** local function prototypes ********
+static bool parseView(cxa_mqtt_message_t *const msgIn);
 
 
 // ********  local variable declarations *********
@@ -38,6 +40,7 @@
 cxa_mqtt_message_type_t cxa_mqtt_message_getType(cxa_mqtt_message_t *const msgIn)
 {
 	if( !msgIn->areFieldsConfigured ) return CXA_MQTT_MSGTYPE_UNKNOWN;
+	if( msgIn->isViewValid ) return msgIn->view.type;
 
 	uint8_t type_raw;
 	if( !cxa_linkedField_get_uint8(&msgIn->field_packetTypeAndFlags, 0, type_raw) ) return CXA_MQTT_MSGTYPE_UNKNOWN;
@@ -46,6 +49,14 @@ cxa_mqtt_message_type_t cxa_mqtt_message_getType(cxa_mqtt_message_t *const msgIn
 }
 
 
+const cxa_mqtt_message_view_t* cxa_mqtt_message_getView(cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(msgIn);
+
+	return msgIn->isViewValid ? &msgIn->view : NULL;
+}
+
+
 cxa_fixedByteBuffer_t* cxa_mqtt_message_getBuffer(cxa_mqtt_message_t *const msgIn)
 {
 	cxa_assert(msgIn);
@@ -62,6 +73,7 @@ void cxa_mqtt_message_initEmpty(cxa_mqtt_message_t *const msgIn, cxa_fixedByteBu
 
 	// set some defaults
 	msgIn->areFieldsConfigured = false;
+	msgIn->isViewValid = false;
 }
 
 
@@ -69,6 +81,10 @@ bool cxa_mqtt_message_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
 {
 	cxa_assert(msgIn);
 
+	// decode our flat view first (this also validates the framing)
+	msgIn->isViewValid = false;
+	if( !parseView(msgIn) ) return false;
+
 	// we need to set this temporarily so we can parse our fields as we go
 	msgIn->areFieldsConfigured = true;
 
@@ -101,6 +117,13 @@ bool cxa_mqtt_message_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
 			didMsgValidate = cxa_mqtt_message_publish_validateReceivedBytes(msgIn);
 			break;
 
+		case CXA_MQTT_MSGTYPE_PUBACK:
+		case CXA_MQTT_MSGTYPE_PUBREC:
+		case CXA_MQTT_MSGTYPE_PUBREL:
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			didMsgValidate = cxa_mqtt_message_publishAck_validateReceivedBytes(msgIn);
+			break;
+
 		case CXA_MQTT_MSGTYPE_SUBSCRIBE:
 			didMsgValidate = cxa_mqtt_message_subscribe_validateReceivedBytes(msgIn);
 			break;
@@ -122,6 +145,7 @@ bool cxa_mqtt_message_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
 	}
 	if( !didMsgValidate ) { msgIn->areFieldsConfigured = false; return false; }
 
+	msgIn->isViewValid = true;
 	return true;
 }
 
@@ -133,6 +157,10 @@ cxa_mqtt_message_type_t cxa_mqtt_message_rxBytes_getType(uint8_t headerByteIn)
 	if( (type_raw != CXA_MQTT_MSGTYPE_CONNECT) &&
 			(type_raw != CXA_MQTT_MSGTYPE_CONNACK) &&
 			(type_raw != CXA_MQTT_MSGTYPE_PUBLISH) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBACK) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBREC) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBREL) &&
+			(type_raw != CXA_MQTT_MSGTYPE_PUBCOMP) &&
 			(type_raw != CXA_MQTT_MSGTYPE_SUBSCRIBE) &&
 			(type_raw != CXA_MQTT_MSGTYPE_SUBACK) &&
 			(type_raw != CXA_MQTT_MSGTYPE_PINGREQ) &&
@@ -195,20 +223,35 @@ bool cxa_mqtt_message_rxBytes_parseVariableLengthField(cxa_fixedByteBuffer_t *co
 }
 
 
+void cxa_mqtt_message_invalidateView(cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(msgIn);
+
+	msgIn->isViewValid = false;
+}
+
+
 #define CXA_LOG_LEVEL				CXA_LOG_LEVEL_TRACE
 #include <cxa_logger_implementation.h>
 
 bool cxa_mqtt_message_updateVariableLengthField(cxa_mqtt_message_t *const msgIn)
+{
+	return cxa_mqtt_message_updateVariableLengthField_withTrailingBytes(msgIn, 0);
+}
+
+
+bool cxa_mqtt_message_updateVariableLengthField_withTrailingBytes(cxa_mqtt_message_t *const msgIn, size_t numTrailingBytesIn)
 {
 	cxa_assert(msgIn);
 
 	if( !msgIn->areFieldsConfigured ) return false;
+	cxa_mqtt_message_invalidateView(msgIn);
 
 	// clear our existing length field
 	if( !cxa_linkedField_clear(&msgIn->field_remainingLength) ) return false;
 
 	// recalculate...total length - first fixed header byte(1) - us(now 0)
-	size_t remainingLength_actual = cxa_fixedByteBuffer_getSize_bytes(msgIn->buffer) - 1;
+	size_t remainingLength_actual = cxa_fixedByteBuffer_getSize_bytes(msgIn->buffer) - 1 + numTrailingBytesIn;
 
 	// convert to variable length encoding
 	uint8_t varLenBytes[REMAININGLEN_MAXBYTES];
@@ -220,9 +263,8 @@ bool cxa_mqtt_message_updateVariableLengthField(cxa_mqtt_message_t *const msgIn)
 		// if there are more data to encode, set the top bit of this byte
 		if( remainingLength_actual > 0 ) currByte |= 128;
 
-		varLenBytes[numBytes_varLenField++] = currByte;
-
 		if( numBytes_varLenField >= REMAININGLEN_MAXBYTES ) return false;
+		varLenBytes[numBytes_varLenField++] = currByte;
 	} while(remainingLength_actual > 0);
 
 	return cxa_linkedField_append(&msgIn->field_remainingLength, varLenBytes, numBytes_varLenField);
@@ -230,3 +272,102 @@ bool cxa_mqtt_message_updateVariableLengthField(cxa_mqtt_message_t *const msgIn)
 
 
 // ******** local function implementations ********
+static bool parseView(cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(msgIn);
+
+	cxa_mqtt_message_view_t* view = &msgIn->view;
+	size_t msgSize_bytes = cxa_fixedByteBuffer_getSize_bytes(msgIn->buffer);
+	if( msgSize_bytes < 2 ) return false;
+	uint8_t* bytes = cxa_fixedByteBuffer_get_pointerToIndex(msgIn->buffer, 0);
+
+	// fixed header
+	view->type = cxa_mqtt_message_rxBytes_getType(bytes[0]);
+	view->flags = bytes[0] & 0x0F;
+
+	bool isVarLenComplete = false;
+	size_t varLenField_bytes;
+	if( !cxa_mqtt_message_rxBytes_parseVariableLengthField(msgIn->buffer, &isVarLenComplete, &view->remainingLength_bytes, &varLenField_bytes) ||
+			!isVarLenComplete ||
+			((1 + varLenField_bytes + view->remainingLength_bytes) != msgSize_bytes) ) return false;
+
+	// variable header (+ payload)
+	uint8_t* varHeader = bytes + 1 + varLenField_bytes;
+	size_t varHeaderSize_bytes = view->remainingLength_bytes;
+	switch( view->type )
+	{
+		case CXA_MQTT_MSGTYPE_PUBLISH:
+		{
+			if( varHeaderSize_bytes < 2 ) return false;
+			view->asPublish.topicNameLen_bytes = (varHeader[0] << 8) | varHeader[1];
+			view->asPublish.topicName = (char*)&varHeader[2];
+			size_t currIndex = 2 + view->asPublish.topicNameLen_bytes;
+
+			view->asPublish.qos = (cxa_mqtt_qosLevel_t)((view->flags >> 1) & 0x03);
+			if( view->asPublish.qos > CXA_MQTT_QOS_EXACTLY_ONCE ) return false;
+			view->asPublish.isDup = (view->flags >> 3) & 0x01;
+			view->asPublish.isRetain = view->flags & 0x01;
+			view->asPublish.packetId = 0;
+			if( view->asPublish.qos != CXA_MQTT_QOS_ATMOST_ONCE )
+			{
+				if( (currIndex + 2) > varHeaderSize_bytes ) return false;
+				view->asPublish.packetId = (varHeader[currIndex] << 8) | varHeader[currIndex+1];
+				currIndex += 2;
+			}
+			if( currIndex > varHeaderSize_bytes ) return false;
+
+			view->asPublish.payloadSize_bytes = varHeaderSize_bytes - currIndex;
+			view->asPublish.payload = (view->asPublish.payloadSize_bytes > 0) ? &varHeader[currIndex] : NULL;
+			break;
+		}
+
+		case CXA_MQTT_MSGTYPE_PUBACK:
+		case CXA_MQTT_MSGTYPE_PUBREC:
+		case CXA_MQTT_MSGTYPE_PUBREL:
+		case CXA_MQTT_MSGTYPE_PUBCOMP:
+			if( varHeaderSize_bytes < 2 ) return false;
+			view->asPublishAck.packetId = (varHeader[0] << 8) | varHeader[1];
+			break;
+
+		case CXA_MQTT_MSGTYPE_SUBACK:
+			if( varHeaderSize_bytes < 3 ) return false;
+			view->asSubAck.packetId = (varHeader[0] << 8) | varHeader[1];
+			view->asSubAck.returnCode = varHeader[2];
+			view->asSubAck.returnCodes = &varHeader[2];
+			view->asSubAck.numReturnCodes = varHeaderSize_bytes - 2;
+			break;
+
+		case CXA_MQTT_MSGTYPE_SUBSCRIBE:
+		{
+			if( varHeaderSize_bytes < 2 ) return false;
+			view->asSubscribe.packetId = (varHeader[0] << 8) | varHeader[1];
+			view->asSubscribe.topicFilters = &varHeader[2];
+			view->asSubscribe.topicFiltersSize_bytes = varHeaderSize_bytes - 2;
+
+			// must contain at least one complete topic filter / qos pair (and nothing else)
+			view->asSubscribe.numTopicFilters = 0;
+			size_t currIndex = 0;
+			while( currIndex < view->asSubscribe.topicFiltersSize_bytes )
+			{
+				if( (currIndex + 2) > view->asSubscribe.topicFiltersSize_bytes ) return false;
+				currIndex += 2 + ((view->asSubscribe.topicFilters[currIndex] << 8) | view->asSubscribe.topicFilters[currIndex+1]) + 1;
+				if( currIndex > view->asSubscribe.topicFiltersSize_bytes ) return false;
+				view->asSubscribe.numTopicFilters++;
+			}
+			if( view->asSubscribe.numTopicFilters == 0 ) return false;
+			break;
+		}
+
+		case CXA_MQTT_MSGTYPE_CONNACK:
+			if( varHeaderSize_bytes < 2 ) return false;
+			view->asConnAck.isSessionPresent = varHeader[0] & 0x01;
+			view->asConnAck.returnCode = varHeader[1];
+			break;
+
+		default:
+			// no view-specific fields for this message type
+			break;
+	}
+
+	return true;
+}
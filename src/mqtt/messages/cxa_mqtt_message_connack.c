@@ -27,6 +27,7 @@
 bool cxa_mqtt_message_connack_init(cxa_mqtt_message_t *const msgIn, bool isSessionPresentIn, cxa_mqtt_connAck_returnCode_t retCodeIn)
 {
 	cxa_assert(msgIn);
+	msgIn->isViewValid = false;
 
 	// fixed header 1
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
@@ -41,6 +41,7 @@ bool cxa_mqtt_message_connect_init(cxa_mqtt_message_t *const msgIn, char* client
 	cxa_assert(clientIdIn);
 	if( passwordLen_bytesIn > 0 ) cxa_assert(passwordIn != NULL);
 	if( willPayloadLen_bytesIn > 0 ) cxa_assert(willPayloadIn != NULL);
+	msgIn->isViewValid = false;
 
 	// get the clientId length
 	size_t cidLen_bytes = strlen(clientIdIn);
@@ -188,6 +189,34 @@ bool cxa_mqtt_message_connect_getPassword(cxa_mqtt_message_t *const msgIn, uint8
 }
 
 
+bool cxa_mqtt_message_connect_getProtocolLevel(cxa_mqtt_message_t *const msgIn, uint8_t *const protocolLevelOut)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_CONNECT) ) return false;
+
+	uint8_t protocolLevel_lcl;
+	if( !cxa_linkedField_get_uint8(&msgIn->fields_connect.field_protocolLevel, 0, protocolLevel_lcl) ) return false;
+
+	if( protocolLevelOut != NULL ) *protocolLevelOut = protocolLevel_lcl;
+	return true;
+}
+
+
+bool cxa_mqtt_message_connect_getKeepAlive_s(cxa_mqtt_message_t *const msgIn, uint16_t *const keepAlive_sOut)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_CONNECT) ) return false;
+
+	uint16_t keepAlive_s_lcl;
+	if( !cxa_linkedField_get_uint16BE(&msgIn->fields_connect.field_keepAlive, 0, keepAlive_s_lcl) ) return false;
+
+	if( keepAlive_sOut != NULL ) *keepAlive_sOut = keepAlive_s_lcl;
+	return true;
+}
+
+
 bool cxa_mqtt_message_connect_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
 {
 	cxa_assert(msgIn);
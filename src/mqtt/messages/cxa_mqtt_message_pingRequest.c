@@ -27,6 +27,7 @@
 bool cxa_mqtt_message_pingRequest_init(cxa_mqtt_message_t *const msgIn)
 {
 	cxa_assert(msgIn);
+	msgIn->isViewValid = false;
 
 	// fixed header 1
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
@@ -32,6 +32,7 @@ bool cxa_mqtt_message_publish_init(cxa_mqtt_message_t *const msgIn, bool dupIn,
 	cxa_assert(msgIn);
 	cxa_assert(topicNameIn);
 	if( payloadSize_bytesIn > 0 ) cxa_assert(payloadIn);
+	msgIn->isViewValid = false;
 
 	// fixed header 1
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
@@ -48,7 +49,7 @@ bool cxa_mqtt_message_publish_init(cxa_mqtt_message_t *const msgIn, bool dupIn,
 	// packet identifier (if higher-level QOS)
 	if( qosIn != CXA_MQTT_QOS_ATMOST_ONCE )
 	{
-		if( !cxa_linkedField_initRoot_fixedLen(&msgIn->fields_publish.field_packetId, msgIn->buffer, 0, 2) ||
+		if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_publish.field_packetId, prevField, 2) ||
 					!cxa_linkedField_append_uint16BE(&msgIn->fields_publish.field_packetId, packedIdIn) ) return false;
 		prevField = &msgIn->fields_publish.field_packetId;
 	}
@@ -68,17 +69,76 @@ bool cxa_mqtt_message_publish_getTopicName(cxa_mqtt_message_t *const msgIn, char
 
 	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
 
+	// received messages have this decoded already
+	if( msgIn->isViewValid )
+	{
+		if( topicNameOut != NULL ) *topicNameOut = msgIn->view.asPublish.topicName;
+		if( topicNameLen_bytesOut != NULL ) *topicNameLen_bytesOut = msgIn->view.asPublish.topicNameLen_bytes;
+		return true;
+	}
+
 	return cxa_linkedField_get_lengthPrefixedCString_uint16BE_inPlace(&msgIn->fields_publish.field_topicName, 0, topicNameOut, topicNameLen_bytesOut);
 }
 
 
+bool cxa_mqtt_message_publish_getQos(cxa_mqtt_message_t *const msgIn, cxa_mqtt_qosLevel_t *const qosOut)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
+
+	uint8_t packetTypeAndFlags;
+	if( !cxa_linkedField_get_uint8(&msgIn->field_packetTypeAndFlags, 0, packetTypeAndFlags) ) return false;
+
+	if( qosOut != NULL ) *qosOut = (cxa_mqtt_qosLevel_t)((packetTypeAndFlags >> 1) & 0x03);
+
+	return true;
+}
+
+
+bool cxa_mqtt_message_publish_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut)
+{
+	cxa_assert(msgIn);
+
+	cxa_mqtt_qosLevel_t qos;
+	if( !cxa_mqtt_message_publish_getQos(msgIn, &qos) || (qos == CXA_MQTT_QOS_ATMOST_ONCE) ) return false;
+
+	uint16_t packetId_lcl;
+	if( !cxa_linkedField_get_uint16BE(&msgIn->fields_publish.field_packetId, 0, packetId_lcl) ) return false;
+
+	if( packetIdOut != NULL ) *packetIdOut = packetId_lcl;
+
+	return true;
+}
+
+
+bool cxa_mqtt_message_publish_setDup(cxa_mqtt_message_t *const msgIn, bool dupIn)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
+
+	uint8_t packetTypeAndFlags;
+	if( !cxa_linkedField_get_uint8(&msgIn->field_packetTypeAndFlags, 0, packetTypeAndFlags) ) return false;
+	packetTypeAndFlags = dupIn ? (packetTypeAndFlags | 0x08) : (packetTypeAndFlags & ~0x08);
+
+	cxa_mqtt_message_invalidateView(msgIn);
+	return cxa_linkedField_replace_uint8(&msgIn->field_packetTypeAndFlags, 0, packetTypeAndFlags);
+}
+
+
 bool cxa_mqtt_message_publish_getPayload(cxa_mqtt_message_t *const msgIn, cxa_linkedField_t **payloadLfOut)
 {
 	cxa_assert(msgIn);
 
 	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
 
-	if( payloadLfOut != NULL ) *payloadLfOut = &msgIn->fields_publish.field_payload;
+	// the caller may modify the payload via this field
+	if( payloadLfOut != NULL )
+	{
+		cxa_mqtt_message_invalidateView(msgIn);
+		*payloadLfOut = &msgIn->fields_publish.field_payload;
+	}
 
 	return true;
 }
@@ -101,6 +161,7 @@ bool cxa_mqtt_message_publish_topicName_trimToPointer(cxa_mqtt_message_t *const
 	uint16_t numBytesToTrimFromLeft = ptrIn - topicName;
 	if( numBytesToTrimFromLeft > topicNameLen_bytes ) return false;
 
+	cxa_mqtt_message_invalidateView(msgIn);
 	return cxa_linkedField_removeFrom_lengthPrefixedField_uint16BE(&msgIn->fields_publish.field_topicName, 0, numBytesToTrimFromLeft);
 }
 
@@ -123,6 +184,7 @@ bool cxa_mqtt_message_publish_topicName_prependString_withLength(cxa_mqtt_messag
 
 	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_PUBLISH) ) return false;
 
+	cxa_mqtt_message_invalidateView(msgIn);
 	return cxa_linkedField_prependTo_lengthPrefixedField_uint16BE(&msgIn->fields_publish.field_topicName, 0, (uint8_t*)stringIn, stringLen_bytesIn);
 }
 
@@ -140,6 +202,7 @@ bool cxa_mqtt_message_publish_topicName_clear(cxa_mqtt_message_t *const msgIn)
 
 	// make sure we don't go out of bounds
 	uint16_t numBytesToTrimFromLeft = topicNameLen_bytes;
+	cxa_mqtt_message_invalidateView(msgIn);
 	return cxa_linkedField_removeFrom_lengthPrefixedField_uint16BE(&msgIn->fields_publish.field_topicName, 0, numBytesToTrimFromLeft);
 }
 
@@ -0,0 +1,85 @@
+/*
+ * This file is subject to the terms and conditions defined in
+ * file 'LICENSE', which is part of this source code package.
+ *
+ * @author Christopher Armenio
+ */
+#include "cxa_mqtt_message_publishAck.h"
+
+
+// ******** includes ********
+#include <cxa_assert.h>
+
+
+// ******** local macro definitions ********
+
+
+// ******** local type definitions ********
+
+
+// ******** local function prototypes ********
+
+
+// ********  local variable declarations *********
+
+
+// ******** global function implementations ********
+bool cxa_mqtt_message_publishAck_init(cxa_mqtt_message_t *const msgIn, cxa_mqtt_message_type_t typeIn, uint16_t packetIdIn)
+{
+	cxa_assert(msgIn);
+	cxa_assert(cxa_mqtt_message_publishAck_isPublishAckType(typeIn));
+	msgIn->isViewValid = false;
+
+	// fixed header 1 (PUBREL has reserved flags set, per spec)
+	uint8_t flags = (typeIn == CXA_MQTT_MSGTYPE_PUBREL) ? 0x02 : 0x00;
+	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
+			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, ((typeIn << 4) | flags)) ) return false;
+
+	// remaining length
+	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
+
+	// packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_publishAck.field_packetId, &msgIn->field_remainingLength, 2) ||
+			!cxa_linkedField_append_uint16BE(&msgIn->fields_publishAck.field_packetId, packetIdIn) ) return false;
+
+	msgIn->areFieldsConfigured = true;
+	return true;
+}
+
+
+bool cxa_mqtt_message_publishAck_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut)
+{
+	cxa_assert(msgIn);
+
+	if( !msgIn->areFieldsConfigured || !cxa_mqtt_message_publishAck_isPublishAckType(cxa_mqtt_message_getType(msgIn)) ) return false;
+
+	uint16_t packetId_lcl;
+	if( !cxa_linkedField_get_uint16BE(&msgIn->fields_publishAck.field_packetId, 0, packetId_lcl) ) return false;
+
+	if( packetIdOut != NULL ) *packetIdOut = packetId_lcl;
+
+	return true;
+}
+
+
+bool cxa_mqtt_message_publishAck_isPublishAckType(cxa_mqtt_message_type_t typeIn)
+{
+	return (typeIn == CXA_MQTT_MSGTYPE_PUBACK) ||
+		   (typeIn == CXA_MQTT_MSGTYPE_PUBREC) ||
+		   (typeIn == CXA_MQTT_MSGTYPE_PUBREL) ||
+		   (typeIn == CXA_MQTT_MSGTYPE_PUBCOMP);
+}
+
+
+bool cxa_mqtt_message_publishAck_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
+{
+	cxa_assert(msgIn);
+
+	// packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_publishAck.field_packetId, &msgIn->field_remainingLength, 2) ) return false;
+
+	return true;
+}
+
+
+// ******** local function implementations ********
@@ -27,6 +27,36 @@
 
 
 // ******** global function implementations ********
+bool cxa_mqtt_message_suback_init(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn, cxa_mqtt_subAck_returnCode_t *const returnCodesIn, size_t numReturnCodesIn)
+{
+	cxa_assert(msgIn);
+	cxa_assert(returnCodesIn);
+	cxa_assert(numReturnCodesIn > 0);
+	msgIn->isViewValid = false;
+
+	// fixed header 1
+	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
+			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, (CXA_MQTT_MSGTYPE_SUBACK << 4)) ) return false;
+
+	// remaining length
+	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
+
+	// packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_suback.field_packetId, &msgIn->field_remainingLength, 2) ||
+			!cxa_linkedField_append_uint16BE(&msgIn->fields_suback.field_packetId, packetIdIn) ) return false;
+
+	// return code(s)
+	if( !cxa_linkedField_initChild(&msgIn->fields_suback.field_returnCode, &msgIn->fields_suback.field_packetId, 0) ) return false;
+	for( size_t i = 0; i < numReturnCodesIn; i++ )
+	{
+		if( !cxa_linkedField_append_uint8(&msgIn->fields_suback.field_returnCode, (uint8_t)returnCodesIn[i]) ) return false;
+	}
+
+	msgIn->areFieldsConfigured = true;
+	return true;
+}
+
+
 bool cxa_mqtt_message_suback_getPacketId(cxa_mqtt_message_t *const msgIn, uint16_t *const packetIdOut)
 {
 	cxa_assert(msgIn);
@@ -64,8 +94,11 @@ bool cxa_mqtt_message_suback_validateReceivedBytes(cxa_mqtt_message_t *const msg
 	// packet id
 	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_suback.field_packetId, &msgIn->field_remainingLength, 2) ) return false;
 
-	// return code
-	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_suback.field_returnCode, &msgIn->fields_suback.field_packetId, 1) ) return false;
+	// return code(s), one per topic filter of the SUBSCRIBE
+	size_t returnCodesStartIndex = cxa_linkedField_getStartIndexOfNextField(&msgIn->fields_suback.field_packetId);
+	size_t msgSize_bytes = cxa_fixedByteBuffer_getSize_bytes(msgIn->buffer);
+	if( (returnCodesStartIndex >= msgSize_bytes) ||
+			!cxa_linkedField_initChild(&msgIn->fields_suback.field_returnCode, &msgIn->fields_suback.field_packetId, msgSize_bytes - returnCodesStartIndex) ) return false;
 
 	return true;
 }
@@ -34,6 +34,7 @@ bool cxa_mqtt_message_subscribe_init(cxa_mqtt_message_t *const msgIn, uint16_t p
 {
 	cxa_assert(msgIn);
 	cxa_assert(topicFilterIn)
+	msgIn->isViewValid = false;
 
 	// fixed header 1
 	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
@@ -59,17 +60,83 @@ bool cxa_mqtt_message_subscribe_init(cxa_mqtt_message_t *const msgIn, uint16_t p
 }
 
 
+bool cxa_mqtt_message_subscribe_initBatch(cxa_mqtt_message_t *const msgIn, uint16_t packetIdIn)
+{
+	cxa_assert(msgIn);
+	msgIn->isViewValid = false;
+
+	// fixed header 1
+	if( !cxa_linkedField_initRoot_fixedLen(&msgIn->field_packetTypeAndFlags, msgIn->buffer, 0, 1) ||
+			!cxa_linkedField_append_uint8(&msgIn->field_packetTypeAndFlags, ((CXA_MQTT_MSGTYPE_SUBSCRIBE << 4) | 0x02)) ) return false;
+
+	// remaining length
+	if( !cxa_linkedField_initChild(&msgIn->field_remainingLength, &msgIn->field_packetTypeAndFlags, 0) ) return false;
+
+	// packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_subscribe.field_packetId, &msgIn->field_remainingLength, 2) ||
+				!cxa_linkedField_append_uint16BE(&msgIn->fields_subscribe.field_packetId, packetIdIn) ) return false;
+
+	// topic filter / qos pairs (all stored in the topic filter field)
+	if( !cxa_linkedField_initChild(&msgIn->fields_subscribe.field_topicFilter, &msgIn->fields_subscribe.field_packetId, 0) ) return false;
+
+	msgIn->areFieldsConfigured = true;
+	return true;
+}
+
+
+bool cxa_mqtt_message_subscribe_appendTopicFilter(cxa_mqtt_message_t *const msgIn, char *const topicFilterIn, cxa_mqtt_qosLevel_t qosLevelIn)
+{
+	cxa_assert(msgIn);
+	cxa_assert(topicFilterIn);
+
+	if( !msgIn->areFieldsConfigured || (cxa_mqtt_message_getType(msgIn) != CXA_MQTT_MSGTYPE_SUBSCRIBE) ) return false;
+
+	// make sure the whole pair fits (so we never leave a partial topic filter),
+	// leaving room for the remaining length field (which is written just before sending)
+	size_t remainingLengthReserve_bytes = (CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES - 1) - cxa_linkedField_getSize_bytes(&msgIn->field_remainingLength);
+	if( cxa_fixedByteBuffer_getFreeSize_bytes(msgIn->buffer) < (CXA_MQTT_MESSAGE_SUBSCRIBE_TOPICFILTER_SIZE_BYTES(strlen(topicFilterIn)) + remainingLengthReserve_bytes) ) return false;
+
+	return cxa_linkedField_append_lengthPrefixedCString_uint16BE(&msgIn->fields_subscribe.field_topicFilter, topicFilterIn, false) &&
+		   cxa_linkedField_append_uint8(&msgIn->fields_subscribe.field_topicFilter, qosLevelIn);
+}
+
+
+bool cxa_mqtt_message_subscribe_getTopicFilter(cxa_mqtt_message_t *const msgIn, size_t currIndexIn,
+											   char** topicFilterOut, uint16_t *const topicFilterLen_bytesOut,
+											   cxa_mqtt_qosLevel_t *const qosOut, size_t *const nextIndexOut)
+{
+	cxa_assert(msgIn);
+
+	const cxa_mqtt_message_view_t* view = cxa_mqtt_message_getView(msgIn);
+	if( (view == NULL) || (view->type != CXA_MQTT_MSGTYPE_SUBSCRIBE) ) return false;
+
+	// pairs were checked for completeness when the view was parsed
+	if( (currIndexIn + 2) > view->asSubscribe.topicFiltersSize_bytes ) return false;
+	uint8_t* currPair = &view->asSubscribe.topicFilters[currIndexIn];
+	uint16_t topicFilterLen_bytes = (currPair[0] << 8) | currPair[1];
+
+	if( topicFilterOut != NULL ) *topicFilterOut = (char*)&currPair[2];
+	if( topicFilterLen_bytesOut != NULL ) *topicFilterLen_bytesOut = topicFilterLen_bytes;
+	if( qosOut != NULL ) *qosOut = (cxa_mqtt_qosLevel_t)(currPair[2 + topicFilterLen_bytes] & 0x03);
+	if( nextIndexOut != NULL ) *nextIndexOut = currIndexIn + 2 + topicFilterLen_bytes + 1;
+
+	return true;
+}
+
+
 bool cxa_mqtt_message_subscribe_validateReceivedBytes(cxa_mqtt_message_t *const msgIn)
 {
 	cxa_assert(msgIn);
 
-	// first up is the topic filter
-	uint16_t numBytesInTopicFilter;
-	if( !cxa_fixedByteBuffer_get_lengthPrefixedCString_uint16BE(msgIn->buffer, cxa_linkedField_getStartIndexOfNextField(&msgIn->field_remainingLength), NULL, &numBytesInTopicFilter, NULL) ||
-			!cxa_linkedField_initChild(&msgIn->fields_subscribe.field_topicFilter, &msgIn->field_remainingLength, numBytesInTopicFilter+2) ) return false;
+	// first up is the packet id
+	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_subscribe.field_packetId, &msgIn->field_remainingLength, 2) ) return false;
 
-	// next is the qos
-	if( !cxa_linkedField_initChild_fixedLen(&msgIn->fields_subscribe.field_qos, &msgIn->fields_subscribe.field_topicFilter, 1) ) return false;
+	// then the topic filter / qos pairs (all stored in the topic filter field,
+	// individual pairs were already checked when the view was parsed)
+	size_t topicFiltersStartIndex = cxa_linkedField_getStartIndexOfNextField(&msgIn->fields_subscribe.field_packetId);
+	size_t msgSize_bytes = cxa_fixedByteBuffer_getSize_bytes(msgIn->buffer);
+	if( (topicFiltersStartIndex >= msgSize_bytes) ||
+			!cxa_linkedField_initChild(&msgIn->fields_subscribe.field_topicFilter, &msgIn->fields_subscribe.field_packetId, msgSize_bytes - topicFiltersStartIndex) ) return false;
 
 	return true;
 }
@@ -168,7 +168,7 @@ static void handleMessage_pingReq(cxa_mqtt_rpc_node_bridge_t *const nodeIn, cxa_
 	cxa_assert(nodeIn);
 
 	cxa_mqtt_message_t* msg = NULL;
-	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
+	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_FIXEDHEADER_MAXSIZE_BYTES)) == NULL) ||
 			!cxa_mqtt_message_pingResponse_init(msg) ||
 			!cxa_protocolParser_writePacket(&nodeIn->mpp->super, cxa_mqtt_message_getBuffer(msg)) )
 	{
@@ -191,7 +191,7 @@ static void sendMessage_connack(cxa_mqtt_rpc_node_bridge_t *const nodeIn, bool i
 	cxa_assert(nodeIn);
 
 	cxa_mqtt_message_t* msg = NULL;
-	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_empty()) == NULL) ||
+	if( ((msg = cxa_mqtt_messageFactory_getFreeMessage_withCapacity(CXA_MQTT_MESSAGE_CONNACK_MAXSIZE_BYTES)) == NULL) ||
 			!cxa_mqtt_message_connack_init(msg, isSessionPresentIn, retCodeIn) ||
 			!cxa_protocolParser_writePacket(&nodeIn->mpp->super, cxa_mqtt_message_getBuffer(msg)) )
 	{
@@ -10,6 +10,7 @@
 // ******** includes ********
 #include <stdbool.h>
 
+#include <cxa_blockPool.h>
 #include <cxa_config.h>
 
 
@@ -35,16 +36,18 @@
 // ******** local type definitions ********
 typedef struct
 {
-	cxa_lwipMbedTls_network_tcpClient_t client;
+	void* poolLink;				// used by tcpClientPool while free
 	bool isReserved;
+	cxa_lwipMbedTls_network_tcpClient_t client;
 }tcpClient_entry_t;
 
 
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS > 0
 typedef struct
 {
-	cxa_lwipMbedTls_network_tcpServer_t server;
+	void* poolLink;				// used by tcpServerPool while free
 	bool isReserved;
+	cxa_lwipMbedTls_network_tcpServer_t server;
 }tcpServer_entry_t;
 #endif
 
@@ -57,11 +60,13 @@ static void cxa_network_factory_init(void);
 static bool isInit = false;
 
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_CLIENTS > 0
-static tcpClient_entry_t tcpClientMap[CXA_LWIPMBEDTLS_MAXNUM_TCP_CLIENTS];
+static cxa_blockPool_t tcpClientPool;
+static tcpClient_entry_t tcpClientPool_entries[CXA_LWIPMBEDTLS_MAXNUM_TCP_CLIENTS];
 #endif
 
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS > 0
-static tcpServer_entry_t tcpServerMap[CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS];
+static cxa_blockPool_t tcpServerPool;
+static tcpServer_entry_t tcpServerPool_entries[CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS];
 #endif
 
 
@@ -73,15 +78,12 @@ cxa_network_tcpClient_t* cxa_network_factory_reserveTcpClient(int threadIdIn)
 	cxa_network_tcpClient_t* retVal = NULL;
 
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_CLIENTS > 0
-	for( size_t i = 0; i < (sizeof(tcpClientMap)/sizeof(*tcpClientMap)); i++ )
+	tcpClient_entry_t* newEntry = (tcpClient_entry_t*)cxa_blockPool_reserve(&tcpClientPool);
+	if( newEntry != NULL )
 	{
-		if( !tcpClientMap[i].isReserved )
-		{
-			tcpClientMap[i].isReserved = true;
-			cxa_lwipMbedTls_network_tcpClient_init(&tcpClientMap[i].client, threadIdIn);
-			retVal = &tcpClientMap[i].client.super;
-			break;
-		}
+		newEntry->isReserved = true;
+		cxa_lwipMbedTls_network_tcpClient_init(&newEntry->client, threadIdIn);
+		retVal = &newEntry->client.super;
 	}
 #endif
 
@@ -92,13 +94,11 @@ cxa_network_tcpClient_t* cxa_network_factory_reserveTcpClient(int threadIdIn)
 void cxa_network_factory_freeTcpClient(cxa_network_tcpClient_t *const clientIn)
 {
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_CLIENTS > 0
-	for( size_t i = 0; i < (sizeof(tcpClientMap)/sizeof(*tcpClientMap)); i++ )
+	tcpClient_entry_t* targetEntry = (tcpClient_entry_t*)cxa_blockPool_getBlock_byPointer(&tcpClientPool, clientIn);
+	if( (targetEntry != NULL) && targetEntry->isReserved && (&targetEntry->client.super == clientIn) )
 	{
-		if( &tcpClientMap[i].client.super == clientIn )
-		{
-			tcpClientMap[i].isReserved = false;
-			break;
-		}
+		targetEntry->isReserved = false;
+		cxa_blockPool_release(&tcpClientPool, targetEntry);
 	}
 #endif
 }
@@ -111,15 +111,12 @@ cxa_network_tcpServer_t* cxa_network_factory_reserveTcpServer(int threadIdIn)
 	cxa_network_tcpServer_t* retVal = NULL;
 
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS > 0
-	for( size_t i = 0; i < (sizeof(tcpServerMap)/sizeof(*tcpServerMap)); i++ )
+	tcpServer_entry_t* newEntry = (tcpServer_entry_t*)cxa_blockPool_reserve(&tcpServerPool);
+	if( newEntry != NULL )
 	{
-		if( !tcpServerMap[i].isReserved )
-		{
-			tcpServerMap[i].isReserved = true;
-			cxa_lwipMbedTls_network_tcpServer_init(&tcpServerMap[i].server, threadIdIn);
-			retVal = &tcpServerMap[i].server.super;
-			break;
-		}
+		newEntry->isReserved = true;
+		cxa_lwipMbedTls_network_tcpServer_init(&newEntry->server, threadIdIn);
+		retVal = &newEntry->server.super;
 	}
 #endif
 
@@ -130,13 +127,11 @@ cxa_network_tcpServer_t* cxa_network_factory_reserveTcpServer(int threadIdIn)
 void cxa_network_factory_freeTcpServer(cxa_network_tcpServer_t *const serverIn)
 {
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS > 0
-	for( size_t i = 0; i < (sizeof(tcpServerMap)/sizeof(*tcpServerMap)); i++ )
+	tcpServer_entry_t* targetEntry = (tcpServer_entry_t*)cxa_blockPool_getBlock_byPointer(&tcpServerPool, serverIn);
+	if( (targetEntry != NULL) && targetEntry->isReserved && (&targetEntry->server.super == serverIn) )
 	{
-		if( &tcpServerMap[i].server.super == serverIn )
-		{
-			tcpServerMap[i].isReserved = false;
-			break;
-		}
+		targetEntry->isReserved = false;
+		cxa_blockPool_release(&tcpServerPool, targetEntry);
 	}
 #endif
 }
@@ -146,17 +141,19 @@ void cxa_network_factory_freeTcpServer(cxa_network_tcpServer_t *const serverIn)
 static void cxa_network_factory_init(void)
 {
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_CLIENTS > 0
-	for( size_t i = 0; i < (sizeof(tcpClientMap)/sizeof(*tcpClientMap)); i++ )
+	for( size_t i = 0; i < (sizeof(tcpClientPool_entries)/sizeof(*tcpClientPool_entries)); i++ )
 	{
-		tcpClientMap[i].isReserved = false;
+		tcpClientPool_entries[i].isReserved = false;
 	}
+	cxa_blockPool_initStd(&tcpClientPool, tcpClientPool_entries);
 #endif
 
 #if CXA_LWIPMBEDTLS_MAXNUM_TCP_SERVERS > 0
-	for( size_t i = 0; i < (sizeof(tcpServerMap)/sizeof(*tcpServerMap)); i++ )
+	for( size_t i = 0; i < (sizeof(tcpServerPool_entries)/sizeof(*tcpServerPool_entries)); i++ )
 	{
-		tcpServerMap[i].isReserved = false;
+		tcpServerPool_entries[i].isReserved = false;
 	}
+	cxa_blockPool_initStd(&tcpServerPool, tcpServerPool_entries);
 #endif
 
 	isInit = true;
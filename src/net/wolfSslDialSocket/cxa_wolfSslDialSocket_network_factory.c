@@ -11,6 +11,7 @@
 #include <stdbool.h>
 
 #include <cxa_assert.h>
+#include <cxa_blockPool.h>
 #include <cxa_config.h>
 #include <cxa_wolfSslDialSocket_network_tcpClient.h>
 
@@ -30,8 +31,9 @@
 // ******** local type definitions ********
 typedef struct
 {
-	cxa_wolfSslDialSocket_network_tcpClient_t client;
+	void* poolLink;				// used by tcpClientPool while free
 	bool isReserved;
+	cxa_wolfSslDialSocket_network_tcpClient_t client;
 }tcpClient_entry_t;
 
 
@@ -44,7 +46,8 @@ static bool isInit = false;
 static aq_telitTsvgModem_t* modem = NULL;
 
 #if CXA_WOLFSSLDIALSOCKET_MAXNUM_TCP_CLIENTS > 0
-static tcpClient_entry_t tcpClientMap[CXA_WOLFSSLDIALSOCKET_MAXNUM_TCP_CLIENTS];
+static cxa_blockPool_t tcpClientPool;
+static tcpClient_entry_t tcpClientPool_entries[CXA_WOLFSSLDIALSOCKET_MAXNUM_TCP_CLIENTS];
 #endif
 
 
@@ -66,15 +69,12 @@ cxa_network_tcpClient_t* cxa_network_factory_reserveTcpClient(int threadIdIn)
 
 	cxa_network_tcpClient_t* retVal = NULL;
 
-	for( size_t i = 0; i < (sizeof(tcpClientMap)/sizeof(*tcpClientMap)); i++ )
+	tcpClient_entry_t* newEntry = (tcpClient_entry_t*)cxa_blockPool_reserve(&tcpClientPool);
+	if( newEntry != NULL )
 	{
-		if( !tcpClientMap[i].isReserved )
-		{
-			tcpClientMap[i].isReserved = true;
-			cxa_wolfSslDialSocket_network_tcpClient_init(&tcpClientMap[i].client, modem, threadIdIn);
-			retVal = &tcpClientMap[i].client.super;
-			break;
-		}
+		newEntry->isReserved = true;
+		cxa_wolfSslDialSocket_network_tcpClient_init(&newEntry->client, modem, threadIdIn);
+		retVal = &newEntry->client.super;
 	}
 
 	return retVal;
@@ -83,13 +83,11 @@ cxa_network_tcpClient_t* cxa_network_factory_reserveTcpClient(int threadIdIn)
 
 void cxa_network_factory_freeTcpClient(cxa_network_tcpClient_t *const clientIn)
 {
-	for( size_t i = 0; i < (sizeof(tcpClientMap)/sizeof(*tcpClientMap)); i++ )
+	tcpClient_entry_t* targetEntry = (tcpClient_entry_t*)cxa_blockPool_getBlock_byPointer(&tcpClientPool, clientIn);
+	if( (targetEntry != NULL) && targetEntry->isReserved && (&targetEntry->client.super == clientIn) )
 	{
-		if( &tcpClientMap[i].client.super == clientIn )
-		{
-			tcpClientMap[i].isReserved = false;
-			break;
-		}
+		targetEntry->isReserved = false;
+		cxa_blockPool_release(&tcpClientPool, targetEntry);
 	}
 }
 
@@ -110,10 +108,11 @@ void cxa_network_factory_freeTcpServer(cxa_network_tcpServer_t *const serverIn)
 static void cxa_network_factory_init(void)
 {
 #if CXA_WOLFSSLDIALSOCKET_MAXNUM_TCP_CLIENTS > 0
-	for( size_t i = 0; i < (sizeof(tcpClientMap)/sizeof(*tcpClientMap)); i++ )
+	for( size_t i = 0; i < (sizeof(tcpClientPool_entries)/sizeof(*tcpClientPool_entries)); i++ )
 	{
-		tcpClientMap[i].isReserved = false;
+		tcpClientPool_entries[i].isReserved = false;
 	}
+	cxa_blockPool_initStd(&tcpClientPool, tcpClientPool_entries);
 #endif
 
 	isInit = true;
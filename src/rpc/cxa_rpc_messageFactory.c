@@ -10,6 +10,7 @@
 // ******** includes ********
 #include <stdint.h>
 #include <cxa_assert.h>
+#include <cxa_blockPool.h>
 #include <cxa_config.h>
 
 #define CXA_LOG_LEVEL		CXA_LOG_LEVEL_DEBUG
@@ -25,6 +26,7 @@
 // ******** local type definitions ********
 typedef struct
 {
+	void* poolLink;				// used by msgPool while free
 	uint8_t refCount;
 
 	cxa_rpc_message_t msg;
@@ -40,7 +42,8 @@ static cxa_rpc_messageFactory_msgEntry_t* getMsgEntryFromMessage(cxa_rpc_message
 // ********  local variable declarations *********
 static bool isInit = false;
 static cxa_logger_t logger;
-static cxa_rpc_messageFactory_msgEntry_t msgPool[CXA_RPC_MSGFACTORY_POOL_NUM_MSGS];
+static cxa_blockPool_t msgPool;
+static cxa_rpc_messageFactory_msgEntry_t msgPool_entries[CXA_RPC_MSGFACTORY_POOL_NUM_MSGS];
 
 
 // ******** global function implementations ********
@@ -52,15 +55,16 @@ void cxa_rpc_messageFactory_init(void)
 	cxa_logger_init(&logger, "rpcMsgFactory");
 
 	// setup our message pool
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
+	for( size_t i = 0; i < (sizeof(msgPool_entries)/sizeof(*msgPool_entries)); i++ )
 	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
+		cxa_rpc_messageFactory_msgEntry_t* currEntry = &msgPool_entries[i];
 
 		currEntry->refCount = 0;
 		cxa_fixedByteBuffer_initStd(&currEntry->msgFbb, currEntry->msg_raw);
 
-		cxa_logger_trace(&logger, "message %p added to pool", &currBuffer->msg);
+		cxa_logger_trace(&logger, "message %p added to pool", &currEntry->msg);
 	}
+	cxa_blockPool_initStd(&msgPool, msgPool_entries);
 
 	isInit = true;
 }
@@ -70,39 +74,43 @@ size_t cxa_rpc_messageFactory_getNumFreeMessages(void)
 {
 	if( !isInit ) cxa_rpc_messageFactory_init();
 
-	size_t retVal = 0;
+	return cxa_blockPool_getNumFree(&msgPool);
+}
 
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
-		if( currEntry->refCount == 0 ) retVal++;
-	}
 
-	return retVal;
+size_t cxa_rpc_messageFactory_getHighWaterMark(void)
+{
+	if( !isInit ) cxa_rpc_messageFactory_init();
+
+	return cxa_blockPool_getHighWaterMark(&msgPool);
 }
 
 
-cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_empty(void)
+size_t cxa_rpc_messageFactory_getNumExhausted(void)
 {
 	if( !isInit ) cxa_rpc_messageFactory_init();
 
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
+	return cxa_blockPool_getNumExhausted(&msgPool);
+}
 
-		if( currEntry->refCount == 0 )
-		{
-			currEntry->refCount = 1;
-			cxa_logger_trace(&logger, "message %p newly reserved", &currEntry->msg);
 
-			cxa_fixedByteBuffer_clear(&currEntry->msgFbb);
-			cxa_rpc_message_initEmpty(&currEntry->msg, &currEntry->msgFbb);
-			return &currEntry->msg;
-		}
+cxa_rpc_message_t* cxa_rpc_messageFactory_getFreeMessage_empty(void)
+{
+	if( !isInit ) cxa_rpc_messageFactory_init();
+
+	cxa_rpc_messageFactory_msgEntry_t* newEntry = (cxa_rpc_messageFactory_msgEntry_t*)cxa_blockPool_reserve(&msgPool);
+	if( newEntry == NULL )
+	{
+		cxa_logger_warn(&logger, "no free messages!");
+		return NULL;
 	}
 
-	cxa_logger_warn(&logger, "no free messages!");
-	return NULL;
+	newEntry->refCount = 1;
+	cxa_logger_trace(&logger, "message %p newly reserved", &newEntry->msg);
+
+	cxa_fixedByteBuffer_clear(&newEntry->msgFbb);
+	cxa_rpc_message_initEmpty(&newEntry->msg, &newEntry->msgFbb);
+	return &newEntry->msg;
 }
 
 
@@ -113,15 +121,10 @@ cxa_rpc_message_t* cxa_rpc_messageFactory_getMessage_byBuffer(cxa_fixedByteBuffe
 	// simple case (better than an assert in this case)
 	if( fbbIn == NULL) return NULL;
 
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
-
-		if( (currEntry->refCount != 0) && (&currEntry->msgFbb == fbbIn) ) return &currEntry->msg;
-	}
+	cxa_rpc_messageFactory_msgEntry_t* targetEntry = (cxa_rpc_messageFactory_msgEntry_t*)cxa_blockPool_getBlock_byPointer(&msgPool, fbbIn);
+	if( (targetEntry == NULL) || (targetEntry->refCount == 0) || (&targetEntry->msgFbb != fbbIn) ) return NULL;
 
-	// if we made it here, we couldn't find a match
-	return NULL;
+	return &targetEntry->msg;
 }
 
 
@@ -130,10 +133,10 @@ void cxa_rpc_messageFactory_incrementMessageRefCount(cxa_rpc_message_t *const ms
 	if( !isInit ) cxa_rpc_messageFactory_init();
 
 	cxa_rpc_messageFactory_msgEntry_t* targetEntry = getMsgEntryFromMessage(msgIn);
-	cxa_assert(targetEntry && (targetEntry->refCount < UINT8_MAX));
+	cxa_assert(targetEntry && (targetEntry->refCount > 0) && (targetEntry->refCount < UINT8_MAX));
 
 	targetEntry->refCount++;
-	cxa_logger_trace(&logger, "message %p referenced", &currBuffer->msg);
+	cxa_logger_trace(&logger, "message %p referenced", &targetEntry->msg);
 }
 
 
@@ -148,6 +151,8 @@ void cxa_rpc_messageFactory_decrementMessageRefCount(cxa_rpc_message_t *const ms
 	{
 		targetEntry->refCount--;
 		cxa_logger_trace(&logger, "message %p dereferenced", &targetEntry->msg);
+
+		if( targetEntry->refCount == 0 ) cxa_blockPool_release(&msgPool, targetEntry);
 	}
 	else cxa_logger_warn(&logger, "mismatched decrement call for %p", &targetEntry->msg);
 }
@@ -167,12 +172,6 @@ uint8_t cxa_rpc_messageFactory_getReferenceCountForMessage(cxa_rpc_message_t *co
 // ******** local function implementations ********
 static cxa_rpc_messageFactory_msgEntry_t* getMsgEntryFromMessage(cxa_rpc_message_t *const msgIn)
 {
-	for( size_t i = 0; i < (sizeof(msgPool)/sizeof(*msgPool)); i++ )
-	{
-		cxa_rpc_messageFactory_msgEntry_t* currEntry = (cxa_rpc_messageFactory_msgEntry_t*)&msgPool[i];
-
-		if( &currEntry->msg == msgIn ) return currEntry;
-	}
-
-	return NULL;
+	cxa_rpc_messageFactory_msgEntry_t* targetEntry = (cxa_rpc_messageFactory_msgEntry_t*)cxa_blockPool_getBlock_byPointer(&msgPool, msgIn);
+	return ((targetEntry != NULL) && (&targetEntry->msg == msgIn)) ? targetEntry : NULL;
 }
@@ -9,8 +9,16 @@
 
 // ******** includes ********
 #include <cxa_assert.h>
+#include <cxa_criticalSection.h>
 #include <cxa_timeDiff.h>
 
+#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	#include <cxa_wakeableSleep.h>
+#endif
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+	#include <stdatomic.h>
+#endif
+
 // include for our target build system
 #ifdef __XC
     // microchip
@@ -28,6 +36,19 @@
 #include <cxa_config.h>
 
 // ******** local macro definitions ********
+#ifndef CXA_RUNLOOP_MAXNUM_THREADS
+	#define CXA_RUNLOOP_MAXNUM_THREADS			4
+#endif
+
+#if( defined(CXA_RUNLOOP_STATS_ENABLE) && (CXA_RUNLOOP_MAXNUM_ENTRIES > 256) )
+	#error "CXA_RUNLOOP_STATS_ENABLE supports at most 256 entries"
+#endif
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+	#if( (CXA_RUNLOOP_POSTQUEUE_SIZE == 0) || ((CXA_RUNLOOP_POSTQUEUE_SIZE & (CXA_RUNLOOP_POSTQUEUE_SIZE - 1)) != 0) )
+		#error "CXA_RUNLOOP_POSTQUEUE_SIZE must be a power of two"
+	#endif
+#endif
 
 
 // ******** local type definitions ********
@@ -47,7 +68,8 @@ typedef enum
 }type_t;
 
 
-typedef struct
+typedef struct cxa_runLoop_entry cxa_runLoop_entry_t;
+struct cxa_runLoop_entry
 {
 	state_t state;
 	type_t type;
@@ -55,23 +77,121 @@ typedef struct
 	int threadId;
 
 	uint32_t execPeriod_ms;
+	cxa_runLoop_catchUpPolicy_t catchUpPolicy;
+	cxa_runLoop_pollPolicy_t pollPolicy;
 	cxa_timeDiff_t td_exec;
+	uint64_t nextExec_us;
 
 	cxa_runLoop_cb_t startupCb;
 	cxa_runLoop_cb_t updateCb;
 	void *userVar;
-}cxa_runLoop_entry_t;
+
+	#ifdef CXA_RUNLOOP_STATS_ENABLE
+		cxa_runLoop_entryStats_t stats;
+	#endif
+
+	// membership in the free list OR one of our thread's lists
+	cxa_runLoop_entry_t* next;
+};
+
+
+typedef struct
+{
+	cxa_runLoop_entry_t* head;
+	cxa_runLoop_entry_t* tail;
+}entryList_t;
+
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+typedef struct
+{
+	// sequence number tells producers / consumer who owns the slot
+	atomic_size_t sequence;
+
+	cxa_runLoop_cb_t cb;
+	void *userVar;
+}postQueueSlot_t;
+#endif
+
+
+typedef struct
+{
+	bool isUsed;
+	int threadId;
+
+	uint64_t currTime_us;
+	#ifndef CXA_TIMEDIFF_64BIT_ENABLE
+		uint32_t lastTimeBaseCount_us;
+	#endif
+
+	// entries added, but not yet started (may be appended from other threads)
+	entryList_t unstartedEntries;
+
+	// started, untimed entries
+	entryList_t polledEntries;
+	size_t numPeriodicPolledEntries;
+	entryList_t oneShotEntries;
+
+	// used to determine how long we can sleep after an iteration
+	// (when tickless, these and currTime_us are shared with other threads under a critical section)
+	uint64_t requestedWake_us;
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+		cxa_wakeableSleep_t* wakeableSleep;
+		bool isIdle;
+	#endif
+
+	#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+		// bounded, lock-free MPSC queue (see cxa_runLoop_post)
+		postQueueSlot_t postQueue[CXA_RUNLOOP_POSTQUEUE_SIZE];
+		atomic_size_t postQueue_enqueueIndex;
+		size_t postQueue_dequeueIndex;
+	#endif
+
+	// min-heap of started, timed entries (ordered by nextExec_us)
+	cxa_runLoop_entry_t* timerHeap[CXA_RUNLOOP_MAXNUM_ENTRIES];
+	size_t timerHeap_numEntries;
+}cxa_runLoop_thread_t;
 
 
 // ******** local function prototypes ********
 static void init(void);
+static void addEntry(int threadIdIn, type_t typeIn, uint32_t execPeriod_msIn, cxa_runLoop_catchUpPolicy_t catchUpPolicyIn,
+					 cxa_runLoop_pollPolicy_t pollPolicyIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn);
 static cxa_runLoop_entry_t* reserveUnusedEntry(void);
+static void releaseEntry(cxa_runLoop_entry_t *const entryIn);
+
+static void executeEntry(cxa_runLoop_entry_t *const entryIn);
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+static void resetEntryStats(cxa_runLoop_entry_t *const entryIn);
+static void recordLateness(cxa_runLoop_entry_t *const entryIn, uint64_t lateness_usIn);
+#endif
+
+static void entryList_clear(entryList_t *const listIn);
+static void entryList_append(entryList_t *const listIn, cxa_runLoop_entry_t *const entryIn);
+
+static cxa_runLoop_thread_t* findThread(int threadIdIn);
+static cxa_runLoop_thread_t* getThread(int threadIdIn);
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+static void postQueue_drain(cxa_runLoop_thread_t *const threadIn);
+#endif
+static void updateCurrentTime(cxa_runLoop_thread_t *const threadIn);
+static void wakeThread(int threadIdIn);
+#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+static uint32_t getSleepTime_us(cxa_runLoop_thread_t *const threadIn);
+#endif
+static void scheduleTimedEntry(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn, uint32_t delay_msIn);
+static void rescheduleTimedEntry(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn);
+
+static void timerHeap_push(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn);
+static cxa_runLoop_entry_t* timerHeap_pop(cxa_runLoop_thread_t *const threadIn);
 
 
 // ********  local variable declarations *********
 static bool isInit = false;
 
 static cxa_runLoop_entry_t entries[CXA_RUNLOOP_MAXNUM_ENTRIES];
+static cxa_runLoop_entry_t* freeEntries;
+static cxa_runLoop_thread_t threads[CXA_RUNLOOP_MAXNUM_THREADS];
 
 static cxa_logger_t logger;
 
@@ -79,37 +199,27 @@ static cxa_logger_t logger;
 // ******** global function implementations ********
 void cxa_runLoop_addEntry(int threadIdIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
 {
-	if( !isInit ) init();
+	addEntry(threadIdIn, TYPE_STANDARD, 0, CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT, CXA_RUNLOOP_POLL_PERIODIC, startupCbIn, updateCbIn, userVarIn);
+}
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
 
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_STANDARD;
-	newEntry->execPeriod_ms=0;
-	newEntry->startupCb=startupCbIn;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+void cxa_runLoop_addEntry_full(int threadIdIn, cxa_runLoop_pollPolicy_t pollPolicyIn,
+							   cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+{
+	addEntry(threadIdIn, TYPE_STANDARD, 0, CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT, pollPolicyIn, startupCbIn, updateCbIn, userVarIn);
 }
 
 
 void cxa_runLoop_addTimedEntry(int threadIdIn, uint32_t execPeriod_msIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
 {
-	if( !isInit ) init();
+	addEntry(threadIdIn, TYPE_STANDARD, execPeriod_msIn, CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT, CXA_RUNLOOP_POLL_PERIODIC, startupCbIn, updateCbIn, userVarIn);
+}
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
 
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_STANDARD;
-	newEntry->execPeriod_ms=execPeriod_msIn;
-	newEntry->startupCb=startupCbIn;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+void cxa_runLoop_addTimedEntry_full(int threadIdIn, uint32_t execPeriod_msIn, cxa_runLoop_catchUpPolicy_t catchUpPolicyIn,
+									cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+{
+	addEntry(threadIdIn, TYPE_STANDARD, execPeriod_msIn, catchUpPolicyIn, CXA_RUNLOOP_POLL_PERIODIC, startupCbIn, updateCbIn, userVarIn);
 }
 
 
@@ -122,74 +232,182 @@ void cxa_runLoop_clearAllEntries(void)
 
 void cxa_runLoop_dispatchNextIteration(int threadIdIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
 {
-	if( !isInit ) init();
+	addEntry(threadIdIn, TYPE_ONESHOT, 0, CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT, CXA_RUNLOOP_POLL_PERIODIC, NULL, updateCbIn, userVarIn);
+}
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
 
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_ONESHOT;
-	newEntry->execPeriod_ms=0;
-	newEntry->startupCb=NULL;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+void cxa_runLoop_dispatchAfter(int threadIdIn, uint32_t delay_msIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+{
+	addEntry(threadIdIn, TYPE_ONESHOT, delay_msIn, CXA_RUNLOOP_CATCHUP_POLICY_DEFAULT, CXA_RUNLOOP_POLL_PERIODIC, NULL, updateCbIn, userVarIn);
 }
 
 
-void cxa_runLoop_dispatchAfter(int threadIdIn, uint32_t delay_msIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+bool cxa_runLoop_post(int threadIdIn, cxa_runLoop_cb_t cbIn, void *const userVarIn)
+{
+	// no init, assert, or critical section here...we may be in an ISR
+	cxa_runLoop_thread_t* targetThread = isInit ? findThread(threadIdIn) : NULL;
+	if( targetThread == NULL ) return false;
+
+	// claim a slot
+	postQueueSlot_t* slot;
+	size_t pos = atomic_load_explicit(&targetThread->postQueue_enqueueIndex, memory_order_relaxed);
+	while( 1 )
+	{
+		slot = &targetThread->postQueue[pos & (CXA_RUNLOOP_POSTQUEUE_SIZE - 1)];
+		size_t seq = atomic_load_explicit(&slot->sequence, memory_order_acquire);
+		intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+		if( diff == 0 )
+		{
+			// slot is free for this position...try to claim it
+			if( atomic_compare_exchange_weak_explicit(&targetThread->postQueue_enqueueIndex, &pos, pos + 1,
+													  memory_order_relaxed, memory_order_relaxed) ) break;
+		}
+		else if( diff < 0 ) return false;	// full
+		else pos = atomic_load_explicit(&targetThread->postQueue_enqueueIndex, memory_order_relaxed);
+	}
+
+	// fill and publish the slot
+	slot->cb = cbIn;
+	slot->userVar = userVarIn;
+	atomic_store_explicit(&slot->sequence, pos + 1, memory_order_release);
+
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	cxa_wakeableSleep_wake(targetThread->wakeableSleep);
+	#endif
+
+	return true;
+}
+#endif
+
+
+void cxa_runLoop_requestWakeWithin_ms(int threadIdIn, uint32_t delay_msIn)
 {
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
 	if( !isInit ) init();
 
-	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
-	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
+	cxa_runLoop_thread_t* targetThread = getThread(threadIdIn);
+	cxa_assert_msg(targetThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
 
-	newEntry->threadId = threadIdIn;
-	newEntry->type = TYPE_ONESHOT;
-	newEntry->execPeriod_ms=delay_msIn;
-	newEntry->startupCb=NULL;
-	newEntry->updateCb=updateCbIn;
-	newEntry->userVar=userVarIn;
-	cxa_timeDiff_init(&newEntry->td_exec);
-	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+	// we may be called from another thread while the target is idle
+	cxa_criticalSection_enter();
+	bool isTargetIdle = targetThread->isIdle;
+	if( isTargetIdle ) updateCurrentTime(targetThread);
+
+	uint64_t wake_us = targetThread->currTime_us + (((uint64_t)delay_msIn) * 1000);
+	if( wake_us < targetThread->requestedWake_us ) targetThread->requestedWake_us = wake_us;
+	cxa_criticalSection_exit();
+
+	// a thread is never idle while calling this itself, so this only shortens another thread's sleep
+	if( isTargetIdle ) wakeThread(threadIdIn);
+	#else
+	(void)threadIdIn;
+	(void)delay_msIn;
+	#endif
 }
 
 
-uint32_t cxa_runLoop_iterate(int threadIdIn)
+void cxa_runLoop_wake(int threadIdIn)
 {
 	if( !isInit ) init();
 
-	uint32_t iter_startTime_us = cxa_timeBase_getCount_us();
+	wakeThread(threadIdIn);
+}
 
-	// iterate first and make sure all of our entries have been started
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+
+uint32_t cxa_runLoop_iterate(int threadIdIn)
+{
+	if( !isInit ) init();
+
+	cxa_runLoop_thread_t* currThread = getThread(threadIdIn);
+	cxa_assert_msg(currThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	cxa_criticalSection_enter();
+	updateCurrentTime(currThread);
+	currThread->isIdle = false;
+	// requests which aren't due yet (eg. made from another thread while we slept) carry over
+	if( currThread->requestedWake_us <= currThread->currTime_us ) currThread->requestedWake_us = UINT64_MAX;
+	cxa_criticalSection_exit();
+	#else
+	updateCurrentTime(currThread);
+	#endif
+	uint64_t iter_startTime_us = currThread->currTime_us;
+
+	// start any entries that have been added since our last iteration
+	if( currThread->unstartedEntries.head != NULL )
 	{
-		if( (entries[i].threadId == threadIdIn) &&
-			(entries[i].state == STATE_RESERVED_CONFIGURED_UNSTARTED) )
+		cxa_criticalSection_enter();
+		cxa_runLoop_entry_t* currEntry = currThread->unstartedEntries.head;
+		entryList_clear(&currThread->unstartedEntries);
+		cxa_criticalSection_exit();
+
+		while( currEntry != NULL )
 		{
-			if( entries[i].startupCb != NULL ) entries[i].startupCb(entries[i].userVar);
-			entries[i].state = STATE_RESERVED_CONFIGURED_STARTED;
+			cxa_runLoop_entry_t* nextEntry = currEntry->next;
+
+			if( currEntry->startupCb != NULL ) currEntry->startupCb(currEntry->userVar);
+			currEntry->state = STATE_RESERVED_CONFIGURED_STARTED;
+
+			// sort into the appropriate bucket
+			if( currEntry->execPeriod_ms != 0 )
+			{
+				uint32_t elapsed_ms = cxa_timeDiff_getElapsedTime_ms(&currEntry->td_exec);
+				scheduleTimedEntry(currThread, currEntry, (elapsed_ms < currEntry->execPeriod_ms) ? (currEntry->execPeriod_ms - elapsed_ms) : 0);
+			}
+			else if( currEntry->type == TYPE_ONESHOT ) entryList_append(&currThread->oneShotEntries, currEntry);
+			else if( currEntry->updateCb != NULL )
+			{
+				entryList_append(&currThread->polledEntries, currEntry);
+				if( currEntry->pollPolicy == CXA_RUNLOOP_POLL_PERIODIC ) currThread->numPeriodicPolledEntries++;
+			}
+
+			currEntry = nextEntry;
 		}
 	}
 
-	// now iterate again and call our update functions
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+	// run anything that was posted from other threads / ISRs
+	postQueue_drain(currThread);
+	#endif
+
+	// call our (untimed) update functions
+	for( cxa_runLoop_entry_t* currEntry = currThread->polledEntries.head; currEntry != NULL; currEntry = currEntry->next )
 	{
-		if( (entries[i].threadId == threadIdIn) &&
-			(entries[i].state == STATE_RESERVED_CONFIGURED_STARTED) )
-		{
-			// we know this is valid callback for this thread...
-			// if it's timed, make sure we're calling it at the right pace
-			if( (entries[i].execPeriod_ms == 0) ||
-				 cxa_timeDiff_isElapsed_recurring_ms(&entries[i].td_exec, entries[i].execPeriod_ms) )
-			{
-				if( entries[i].updateCb != NULL ) entries[i].updateCb(entries[i].userVar);
+		executeEntry(currEntry);
+	}
 
-				// free this entry if it's a one-shot
-				if( entries[i].type == TYPE_ONESHOT ) entries[i].state = STATE_UNUSED;
-			}
-		}
+	// service our one-shots (anything dispatched from here on out will run next iteration)
+	cxa_runLoop_entry_t* currOneShot = currThread->oneShotEntries.head;
+	entryList_clear(&currThread->oneShotEntries);
+	while( currOneShot != NULL )
+	{
+		cxa_runLoop_entry_t* nextOneShot = currOneShot->next;
+
+		executeEntry(currOneShot);
+		releaseEntry(currOneShot);
+
+		currOneShot = nextOneShot;
+	}
+
+	// finally, service only the timed entries that are actually due
+	// (as of the start of this iteration, so bursts can't run away from us)
+	uint64_t iterTime_us = currThread->currTime_us;
+	while( (currThread->timerHeap_numEntries > 0) &&
+		   (currThread->timerHeap[0]->nextExec_us <= iterTime_us) )
+	{
+		cxa_runLoop_entry_t* currEntry = timerHeap_pop(currThread);
+
+		#ifdef CXA_RUNLOOP_STATS_ENABLE
+		updateCurrentTime(currThread);
+		recordLateness(currEntry, currThread->currTime_us - currEntry->nextExec_us);
+		#endif
+
+		executeEntry(currEntry);
+
+		// one-shots are freed, recurring entries are rescheduled
+		if( currEntry->type == TYPE_ONESHOT ) releaseEntry(currEntry);
+		else rescheduleTimedEntry(currThread, currEntry);
 	}
 
 #ifdef ESP32
@@ -200,7 +418,95 @@ uint32_t cxa_runLoop_iterate(int threadIdIn)
 	taskYIELD();
 #endif
 
-	return cxa_timeBase_getCount_us() - iter_startTime_us;
+	updateCurrentTime(currThread);
+	return (uint32_t)(currThread->currTime_us - iter_startTime_us);
+}
+
+
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+bool cxa_runLoop_stats_getEntryStats(size_t indexIn, cxa_runLoop_entryStats_t *const statsOut)
+{
+	cxa_assert(statsOut);
+	if( !isInit ) init();
+
+	if( indexIn >= (sizeof(entries)/sizeof(*entries)) ) return false;
+	cxa_runLoop_entry_t* currEntry = &entries[indexIn];
+	if( currEntry->state != STATE_RESERVED_CONFIGURED_STARTED ) return false;
+
+	*statsOut = currEntry->stats;
+	statsOut->threadId = currEntry->threadId;
+	statsOut->updateCb = currEntry->updateCb;
+	statsOut->userVar = currEntry->userVar;
+	statsOut->execPeriod_ms = currEntry->execPeriod_ms;
+
+	return true;
+}
+
+
+void cxa_runLoop_stats_reset(void)
+{
+	if( !isInit ) init();
+
+	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	{
+		resetEntryStats(&entries[i]);
+	}
+}
+
+
+void cxa_runLoop_stats_writeTable(cxa_ioStream_t *const ioStreamIn)
+{
+	cxa_assert(ioStreamIn);
+	if( !isInit ) init();
+
+	// insertion sort the indices (not the stats) of our active entries by total execution time
+	uint8_t sortedIndices[CXA_RUNLOOP_MAXNUM_ENTRIES];
+	size_t numStats = 0;
+	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	{
+		if( entries[i].state != STATE_RESERVED_CONFIGURED_STARTED ) continue;
+
+		size_t insertIndex = numStats++;
+		while( (insertIndex > 0) && (entries[sortedIndices[insertIndex-1]].stats.totalExecTime_us < entries[i].stats.totalExecTime_us) )
+		{
+			sortedIndices[insertIndex] = sortedIndices[insertIndex-1];
+			insertIndex--;
+		}
+		sortedIndices[insertIndex] = (uint8_t)i;
+	}
+
+	// written column-by-column to keep within the ioStream's formatting buffer
+	cxa_ioStream_writeLine(ioStreamIn, "thr  updateCb           userVar              per_ms      calls     total_us   avg_us   min_us   max_us   ovrn maxlate_us");
+	for( size_t i = 0; i < numStats; i++ )
+	{
+		cxa_runLoop_entryStats_t stats;
+		if( !cxa_runLoop_stats_getEntryStats(sortedIndices[i], &stats) ) continue;
+		cxa_runLoop_entryStats_t* currStats = &stats;
+
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%-4d ", currStats->threadId);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%-18p ", (void*)currStats->updateCb);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%-18p ", currStats->userVar);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%8lu ", (unsigned long)currStats->execPeriod_ms);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%10lu ", (unsigned long)currStats->numCalls);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%12llu ", (unsigned long long)currStats->totalExecTime_us);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%8lu ", (unsigned long)((currStats->numCalls > 0) ? (currStats->totalExecTime_us / currStats->numCalls) : 0));
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%8lu ", (unsigned long)((currStats->numCalls > 0) ? currStats->minExecTime_us : 0));
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%8lu ", (unsigned long)currStats->maxExecTime_us);
+		cxa_ioStream_writeFormattedString(ioStreamIn, "%6lu ", (unsigned long)currStats->numOverruns);
+		cxa_ioStream_writeFormattedLine(ioStreamIn, "%10lu", (unsigned long)currStats->maxLateness_us);
+	}
+}
+#endif
+
+
+uint64_t cxa_runLoop_getCachedTime_us(int threadIdIn)
+{
+	if( !isInit ) init();
+
+	cxa_runLoop_thread_t* currThread = getThread(threadIdIn);
+	cxa_assert_msg(currThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+
+	return currThread->currTime_us;
 }
 
 
@@ -208,10 +514,21 @@ void cxa_runLoop_execute(int threadIdIn)
 {
 	if( !isInit ) init();
 
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	cxa_runLoop_thread_t* currThread = getThread(threadIdIn);
+	cxa_assert_msg(currThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+	#endif
+
 	// start the iterations
 	while(1)
 	{
 		cxa_runLoop_iterate(threadIdIn);
+
+		#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+		// idle until something needs our attention
+		uint32_t sleep_us = getSleepTime_us(currThread);
+		if( sleep_us > 0 ) cxa_wakeableSleep_sleep_us(currThread->wakeableSleep, sleep_us);
+		#endif
 	}
 }
 
@@ -221,9 +538,16 @@ static void init(void)
 {
 	if( isInit ) return;
 
+	freeEntries = NULL;
 	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
 	{
 		entries[i].state = STATE_UNUSED;
+		entries[i].next = freeEntries;
+		freeEntries = &entries[i];
+	}
+	for( size_t i = 0; i < sizeof(threads)/sizeof(*threads); i++ )
+	{
+		threads[i].isUsed = false;
 	}
 	cxa_logger_init(&logger, "runLoop");
 
@@ -231,16 +555,386 @@ static void init(void)
 }
 
 
+static void addEntry(int threadIdIn, type_t typeIn, uint32_t execPeriod_msIn, cxa_runLoop_catchUpPolicy_t catchUpPolicyIn,
+					 cxa_runLoop_pollPolicy_t pollPolicyIn, cxa_runLoop_cb_t startupCbIn, cxa_runLoop_cb_t updateCbIn, void *const userVarIn)
+{
+	if( !isInit ) init();
+
+	cxa_runLoop_thread_t* targetThread = getThread(threadIdIn);
+	cxa_assert_msg(targetThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+
+	cxa_runLoop_entry_t* newEntry = reserveUnusedEntry();
+	cxa_assert_msg(newEntry, "increase CXA_RUNLOOP_MAXNUM_ENTRIES");
+
+	newEntry->threadId = threadIdIn;
+	newEntry->type = typeIn;
+	newEntry->execPeriod_ms = execPeriod_msIn;
+	newEntry->catchUpPolicy = catchUpPolicyIn;
+	newEntry->pollPolicy = pollPolicyIn;
+	newEntry->startupCb = startupCbIn;
+	newEntry->updateCb = updateCbIn;
+	newEntry->userVar = userVarIn;
+	cxa_timeDiff_init(&newEntry->td_exec);
+	#ifdef CXA_RUNLOOP_STATS_ENABLE
+	resetEntryStats(newEntry);
+	#endif
+	newEntry->state = STATE_RESERVED_CONFIGURED_UNSTARTED;
+
+	// will be started on the next iteration of the target thread
+	cxa_criticalSection_enter();
+	entryList_append(&targetThread->unstartedEntries, newEntry);
+	cxa_criticalSection_exit();
+
+	wakeThread(threadIdIn);
+}
+
+
 static cxa_runLoop_entry_t* reserveUnusedEntry(void)
 {
-	for( size_t i = 0; i < sizeof(entries)/sizeof(*entries); i++ )
+	cxa_criticalSection_enter();
+	cxa_runLoop_entry_t* retVal = freeEntries;
+	if( retVal != NULL )
 	{
-		if( entries[i].state == STATE_UNUSED )
+		freeEntries = retVal->next;
+		retVal->state = STATE_RESERVED_CONFIGURING;
+	}
+	cxa_criticalSection_exit();
+
+	return retVal;
+}
+
+
+static void releaseEntry(cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(entryIn);
+
+	cxa_criticalSection_enter();
+	entryIn->state = STATE_UNUSED;
+	entryIn->next = freeEntries;
+	freeEntries = entryIn;
+	cxa_criticalSection_exit();
+}
+
+
+static void executeEntry(cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(entryIn);
+	if( entryIn->updateCb == NULL ) return;
+
+	#ifdef CXA_RUNLOOP_STATS_ENABLE
+	uint32_t startTime_us = cxa_timeBase_getCount_us();
+	#endif
+
+	entryIn->updateCb(entryIn->userVar);
+
+	#ifdef CXA_RUNLOOP_STATS_ENABLE
+	uint32_t execTime_us = cxa_timeBase_getCount_us() - startTime_us;
+	cxa_runLoop_entryStats_t* stats = &entryIn->stats;
+
+	stats->numCalls++;
+	stats->totalExecTime_us += execTime_us;
+	if( execTime_us < stats->minExecTime_us ) stats->minExecTime_us = execTime_us;
+	if( execTime_us > stats->maxExecTime_us ) stats->maxExecTime_us = execTime_us;
+	if( (entryIn->execPeriod_ms != 0) && (execTime_us > (((uint64_t)entryIn->execPeriod_ms) * 1000)) ) stats->numOverruns++;
+	#endif
+}
+
+
+#ifdef CXA_RUNLOOP_STATS_ENABLE
+static void resetEntryStats(cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(entryIn);
+
+	entryIn->stats.numCalls = 0;
+	entryIn->stats.totalExecTime_us = 0;
+	entryIn->stats.minExecTime_us = UINT32_MAX;
+	entryIn->stats.maxExecTime_us = 0;
+	entryIn->stats.numOverruns = 0;
+	entryIn->stats.maxLateness_us = 0;
+	for( size_t i = 0; i < CXA_RUNLOOP_STATS_NUM_LATENESS_BUCKETS; i++ )
+	{
+		entryIn->stats.latenessHistogram[i] = 0;
+	}
+}
+
+
+static void recordLateness(cxa_runLoop_entry_t *const entryIn, uint64_t lateness_usIn)
+{
+	cxa_assert(entryIn);
+
+	uint32_t lateness_us = (lateness_usIn > UINT32_MAX) ? UINT32_MAX : (uint32_t)lateness_usIn;
+	if( lateness_us > entryIn->stats.maxLateness_us ) entryIn->stats.maxLateness_us = lateness_us;
+
+	// decade buckets starting at 100us
+	size_t bucketIndex = 0;
+	for( uint32_t bucketLimit_us = 100; (bucketIndex < (CXA_RUNLOOP_STATS_NUM_LATENESS_BUCKETS-1)) && (lateness_us >= bucketLimit_us); bucketLimit_us *= 10 )
+	{
+		bucketIndex++;
+	}
+	entryIn->stats.latenessHistogram[bucketIndex]++;
+}
+#endif
+
+
+static void entryList_clear(entryList_t *const listIn)
+{
+	cxa_assert(listIn);
+
+	listIn->head = NULL;
+	listIn->tail = NULL;
+}
+
+
+static void entryList_append(entryList_t *const listIn, cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(listIn);
+	cxa_assert(entryIn);
+
+	entryIn->next = NULL;
+	if( listIn->tail != NULL ) listIn->tail->next = entryIn;
+	else listIn->head = entryIn;
+	listIn->tail = entryIn;
+}
+
+
+static cxa_runLoop_thread_t* findThread(int threadIdIn)
+{
+	for( size_t i = 0; i < sizeof(threads)/sizeof(*threads); i++ )
+	{
+		if( threads[i].isUsed && (threads[i].threadId == threadIdIn) ) return &threads[i];
+	}
+	return NULL;
+}
+
+
+static cxa_runLoop_thread_t* getThread(int threadIdIn)
+{
+	cxa_runLoop_thread_t* retVal = findThread(threadIdIn);
+	if( retVal != NULL ) return retVal;
+
+	// first time we've seen this thread...setup its context
+	cxa_criticalSection_enter();
+	for( size_t i = 0; i < sizeof(threads)/sizeof(*threads); i++ )
+	{
+		// check again, another thread may have beaten us to it
+		if( threads[i].isUsed && (threads[i].threadId == threadIdIn) )
+		{
+			retVal = &threads[i];
+			break;
+		}
+		if( !threads[i].isUsed && (retVal == NULL) ) retVal = &threads[i];
+	}
+	if( (retVal != NULL) && !retVal->isUsed )
+	{
+		retVal->threadId = threadIdIn;
+		#ifdef CXA_TIMEDIFF_64BIT_ENABLE
+		retVal->currTime_us = cxa_timeBase_getCount64_us();
+		#else
+		retVal->lastTimeBaseCount_us = cxa_timeBase_getCount_us();
+		retVal->currTime_us = retVal->lastTimeBaseCount_us;
+		#endif
+		retVal->requestedWake_us = UINT64_MAX;
+		entryList_clear(&retVal->unstartedEntries);
+		entryList_clear(&retVal->polledEntries);
+		retVal->numPeriodicPolledEntries = 0;
+		entryList_clear(&retVal->oneShotEntries);
+		retVal->timerHeap_numEntries = 0;
+		#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+		for( size_t i = 0; i < CXA_RUNLOOP_POSTQUEUE_SIZE; i++ )
 		{
-			entries[i].state = STATE_RESERVED_CONFIGURING;
-			return &entries[i];
+			atomic_init(&retVal->postQueue[i].sequence, i);
 		}
+		atomic_init(&retVal->postQueue_enqueueIndex, 0);
+		retVal->postQueue_dequeueIndex = 0;
+		#endif
+		#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+		retVal->isIdle = false;
+		// wakeable sleeps are a limited resource...keep the one we had (if any)
+		if( retVal->wakeableSleep == NULL ) retVal->wakeableSleep = cxa_wakeableSleep_reserve();
+		cxa_assert_msg(retVal->wakeableSleep, "no wakeableSleep available for runLoop thread");
+		#endif
+		retVal->isUsed = true;
 	}
+	cxa_criticalSection_exit();
 
-	return NULL;
+	return retVal;
+}
+
+
+#ifdef CXA_RUNLOOP_POSTQUEUE_ENABLE
+static void postQueue_drain(cxa_runLoop_thread_t *const threadIn)
+{
+	cxa_assert(threadIn);
+
+	// bounded so a busy producer can't starve the rest of the iteration
+	for( size_t i = 0; i < CXA_RUNLOOP_POSTQUEUE_SIZE; i++ )
+	{
+		size_t pos = threadIn->postQueue_dequeueIndex;
+		postQueueSlot_t* slot = &threadIn->postQueue[pos & (CXA_RUNLOOP_POSTQUEUE_SIZE - 1)];
+		if( atomic_load_explicit(&slot->sequence, memory_order_acquire) != (pos + 1) ) break;
+
+		cxa_runLoop_cb_t cb = slot->cb;
+		void* userVar = slot->userVar;
+
+		// hand the slot back to the producers before calling (the callback may post again)
+		atomic_store_explicit(&slot->sequence, pos + CXA_RUNLOOP_POSTQUEUE_SIZE, memory_order_release);
+		threadIn->postQueue_dequeueIndex = pos + 1;
+
+		if( cb != NULL ) cb(userVar);
+	}
+}
+#endif
+
+
+static void updateCurrentTime(cxa_runLoop_thread_t *const threadIn)
+{
+	cxa_assert(threadIn);
+
+	// other threads read our time when requesting a wake (critical sections nest)
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	cxa_criticalSection_enter();
+	#endif
+#ifdef CXA_TIMEDIFF_64BIT_ENABLE
+	threadIn->currTime_us = cxa_timeBase_getCount64_us();
+#else
+	// extend the (potentially rolling-over) timeBase into a 64-bit, per-thread time
+	uint32_t curr_us = cxa_timeBase_getCount_us();
+	uint32_t elapsed_us = (curr_us >= threadIn->lastTimeBaseCount_us) ?
+						  (curr_us - threadIn->lastTimeBaseCount_us) :
+						  ((cxa_timeBase_getMaxCount_us() - threadIn->lastTimeBaseCount_us) + curr_us);
+	threadIn->currTime_us += elapsed_us;
+	threadIn->lastTimeBaseCount_us = curr_us;
+#endif
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	cxa_criticalSection_exit();
+	#endif
+}
+
+
+static void wakeThread(int threadIdIn)
+{
+	#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+	cxa_runLoop_thread_t* currThread = getThread(threadIdIn);
+	cxa_assert_msg(currThread, "increase CXA_RUNLOOP_MAXNUM_THREADS");
+
+	cxa_wakeableSleep_wake(currThread->wakeableSleep);
+	#else
+	(void)threadIdIn;
+	#endif
+}
+
+
+#ifdef CXA_RUNLOOP_TICKLESS_ENABLE
+static uint32_t getSleepTime_us(cxa_runLoop_thread_t *const threadIn)
+{
+	cxa_assert(threadIn);
+
+	// from here on, requests from other threads must wake us (see cxa_runLoop_requestWakeWithin_ms)
+	cxa_criticalSection_enter();
+	threadIn->isIdle = true;
+	updateCurrentTime(threadIn);
+
+	// polled entries (unless they request their own wakes) limit how long we can sleep
+	uint64_t wake_us = threadIn->currTime_us +
+					   (((uint64_t)((threadIn->numPeriodicPolledEntries > 0) ? CXA_RUNLOOP_TICKLESS_POLLPERIOD_MS : CXA_RUNLOOP_TICKLESS_MAXSLEEP_MS)) * 1000);
+
+	// as do our timed entries and any explicit requests
+	if( (threadIn->timerHeap_numEntries > 0) && (threadIn->timerHeap[0]->nextExec_us < wake_us) ) wake_us = threadIn->timerHeap[0]->nextExec_us;
+	if( threadIn->requestedWake_us < wake_us ) wake_us = threadIn->requestedWake_us;
+
+	uint32_t retVal = (wake_us > threadIn->currTime_us) ? (uint32_t)(wake_us - threadIn->currTime_us) : 0;
+	cxa_criticalSection_exit();
+
+	return retVal;
+}
+#endif
+
+
+static void scheduleTimedEntry(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn, uint32_t delay_msIn)
+{
+	cxa_assert(threadIn);
+	cxa_assert(entryIn);
+
+	entryIn->nextExec_us = threadIn->currTime_us + (((uint64_t)delay_msIn) * 1000);
+	timerHeap_push(threadIn, entryIn);
+}
+
+
+static void rescheduleTimedEntry(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(threadIn);
+	cxa_assert(entryIn);
+
+	// schedule against our previous deadline (not when we actually ran) to avoid drift
+	uint64_t period_us = ((uint64_t)entryIn->execPeriod_ms) * 1000;
+	entryIn->nextExec_us += period_us;
+
+	if( entryIn->nextExec_us < threadIn->currTime_us )
+	{
+		// we've missed at least one deadline
+		switch( entryIn->catchUpPolicy )
+		{
+			case CXA_RUNLOOP_CATCHUP_SKIP:
+				entryIn->nextExec_us += (((threadIn->currTime_us - entryIn->nextExec_us) / period_us) + 1) * period_us;
+				break;
+
+			case CXA_RUNLOOP_CATCHUP_COALESCE:
+				entryIn->nextExec_us = threadIn->currTime_us + period_us;
+				break;
+
+			case CXA_RUNLOOP_CATCHUP_BURST:
+			default:
+				// leave it in the past, we'll keep executing until we catch up
+				break;
+		}
+	}
+
+	timerHeap_push(threadIn, entryIn);
+}
+
+
+static void timerHeap_push(cxa_runLoop_thread_t *const threadIn, cxa_runLoop_entry_t *const entryIn)
+{
+	cxa_assert(threadIn);
+	cxa_assert(entryIn);
+	cxa_assert(threadIn->timerHeap_numEntries < (sizeof(threadIn->timerHeap)/sizeof(*threadIn->timerHeap)));
+
+	// sift up from the bottom of the heap
+	size_t currIndex = threadIn->timerHeap_numEntries++;
+	while( currIndex > 0 )
+	{
+		size_t parentIndex = (currIndex - 1) / 2;
+		if( threadIn->timerHeap[parentIndex]->nextExec_us <= entryIn->nextExec_us ) break;
+
+		threadIn->timerHeap[currIndex] = threadIn->timerHeap[parentIndex];
+		currIndex = parentIndex;
+	}
+	threadIn->timerHeap[currIndex] = entryIn;
+}
+
+
+static cxa_runLoop_entry_t* timerHeap_pop(cxa_runLoop_thread_t *const threadIn)
+{
+	cxa_assert(threadIn);
+	if( threadIn->timerHeap_numEntries == 0 ) return NULL;
+
+	cxa_runLoop_entry_t* retVal = threadIn->timerHeap[0];
+	cxa_runLoop_entry_t* lastEntry = threadIn->timerHeap[--threadIn->timerHeap_numEntries];
+
+	// sift the last entry down from the top of the heap
+	size_t currIndex = 0;
+	while( 1 )
+	{
+		size_t childIndex = (2 * currIndex) + 1;
+		if( childIndex >= threadIn->timerHeap_numEntries ) break;
+		if( ((childIndex + 1) < threadIn->timerHeap_numEntries) &&
+			(threadIn->timerHeap[childIndex + 1]->nextExec_us < threadIn->timerHeap[childIndex]->nextExec_us) ) childIndex++;
+		if( lastEntry->nextExec_us <= threadIn->timerHeap[childIndex]->nextExec_us ) break;
+
+		threadIn->timerHeap[currIndex] = threadIn->timerHeap[childIndex];
+		currIndex = childIndex;
+	}
+	if( threadIn->timerHeap_numEntries > 0 ) threadIn->timerHeap[currIndex] = lastEntry;
+
+	return retVal;
 }
@@ -57,16 +57,26 @@ void cxa_ioStream_bind(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_readByt
 	// save our references
 	ioStreamIn->readCb = readCbIn;
 	ioStreamIn->writeCb = writeCbIn;
+	ioStreamIn->writeVectoredCb = NULL;
 	ioStreamIn->userVar = userVarIn;
 }
 
 
+void cxa_ioStream_bindVectoredWrite(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_cb_writeBytesVectored_t writeVectoredCbIn)
+{
+	cxa_assert(ioStreamIn);
+
+	ioStreamIn->writeVectoredCb = writeVectoredCbIn;
+}
+
+
 void cxa_ioStream_unbind(cxa_ioStream_t *const ioStreamIn)
 {
 	cxa_assert(ioStreamIn);
 
 	ioStreamIn->readCb = NULL;
 	ioStreamIn->writeCb = NULL;
+	ioStreamIn->writeVectoredCb = NULL;
 	ioStreamIn->userVar = NULL;
 }
 
@@ -180,6 +190,24 @@ bool cxa_ioStream_writeFixedByteBuffer(cxa_ioStream_t *const ioStreamIn, cxa_fix
 }
 
 
+bool cxa_ioStream_writeBytes_vectored(cxa_ioStream_t *const ioStreamIn, cxa_ioStream_ioVec_t *const iovIn, size_t numIovIn)
+{
+	cxa_assert(ioStreamIn);
+	if( numIovIn > 0 ) cxa_assert(iovIn);
+
+	// make sure we're bound
+	if( !cxa_ioStream_isBound(ioStreamIn) ) return false;
+
+	if( ioStreamIn->writeVectoredCb != NULL ) return ioStreamIn->writeVectoredCb(iovIn, numIovIn, ioStreamIn->userVar);
+
+	for( size_t i = 0; i < numIovIn; i++ )
+	{
+		if( (iovIn[i].size_bytes > 0) && !cxa_ioStream_writeBytes(ioStreamIn, iovIn[i].buff, iovIn[i].size_bytes) ) return false;
+	}
+	return true;
+}
+
+
 bool cxa_ioStream_writeString(cxa_ioStream_t *const ioStreamIn, const char* stringIn)
 {
 	cxa_assert(ioStreamIn);
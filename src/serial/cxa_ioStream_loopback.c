@@ -58,10 +58,5 @@ static bool write_cb(void* buffIn, size_t bufferSize_bytesIn, void *const userVa
 	cxa_ioStream_loopback_t* ioStreamIn = (cxa_ioStream_loopback_t*)userVarIn;
 	if( buffIn == NULL ) return false;
 
-	for( size_t i = 0; i < bufferSize_bytesIn; i++ )
-	{
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-	}
-
-	return true;
+	return cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo, buffIn, bufferSize_bytesIn);
 }
@@ -75,12 +75,7 @@ static bool write_cb_ep1(void* buffIn, size_t bufferSize_bytesIn, void *const us
 	cxa_ioStream_pipe_t* ioStreamIn = (cxa_ioStream_pipe_t*)userVarIn;
 	if( buffIn == NULL ) return false;
 
-	for( size_t i = 0; i < bufferSize_bytesIn; i++ )
-	{
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep2Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-	}
-
-	return true;
+	return cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep2Read, buffIn, bufferSize_bytesIn);
 }
 
 
@@ -99,10 +94,5 @@ static bool write_cb_ep2(void* buffIn, size_t bufferSize_bytesIn, void *const us
 	cxa_ioStream_pipe_t* ioStreamIn = (cxa_ioStream_pipe_t*)userVarIn;
 	if( buffIn == NULL ) return false;
 
-	for( size_t i = 0; i < bufferSize_bytesIn; i++ )
-	{
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep1Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-	}
-
-	return true;
+	return cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep1Read, buffIn, bufferSize_bytesIn);
 }
@@ -88,13 +88,10 @@ static bool write_cb_ep1(void* buffIn, size_t bufferSize_bytesIn, void *const us
 	cxa_ioStream_tee_t* ioStreamIn = (cxa_ioStream_tee_t*)userVarIn;
 	if( buffIn == NULL ) return false;
 
-	for( size_t i = 0; i < bufferSize_bytesIn; i++ )
-	{
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep2Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep3Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-	}
+	bool retVal = cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep2Read, buffIn, bufferSize_bytesIn);
+	retVal &= cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep3Read, buffIn, bufferSize_bytesIn);
 
-	return true;
+	return retVal;
 }
 
 
@@ -113,13 +110,10 @@ static bool write_cb_ep2(void* buffIn, size_t bufferSize_bytesIn, void *const us
 	cxa_ioStream_tee_t* ioStreamIn = (cxa_ioStream_tee_t*)userVarIn;
 	if( buffIn == NULL ) return false;
 
-	for( size_t i = 0; i < bufferSize_bytesIn; i++ )
-	{
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep1Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep3Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-	}
+	bool retVal = cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep1Read, buffIn, bufferSize_bytesIn);
+	retVal &= cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep3Read, buffIn, bufferSize_bytesIn);
 
-	return true;
+	return retVal;
 }
 
 
@@ -138,11 +132,8 @@ static bool write_cb_ep3(void* buffIn, size_t bufferSize_bytesIn, void *const us
 	cxa_ioStream_tee_t* ioStreamIn = (cxa_ioStream_tee_t*)userVarIn;
 	if( buffIn == NULL ) return false;
 
-	for( size_t i = 0; i < bufferSize_bytesIn; i++ )
-	{
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep1Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-		if( !cxa_fixedFifo_queue(&ioStreamIn->fifo_ep2Read, (void*)&(((uint8_t*)buffIn)[i])) ) return false;
-	}
+	bool retVal = cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep1Read, buffIn, bufferSize_bytesIn);
+	retVal &= cxa_fixedFifo_bulkQueue(&ioStreamIn->fifo_ep2Read, buffIn, bufferSize_bytesIn);
 
-	return true;
+	return retVal;
 }
@@ -41,6 +41,7 @@ void cxa_stateMachine_init(cxa_stateMachine_t *const smIn, const char* nameIn, i
 	smIn->currState = NULL;
 	smIn->nextState = NULL;
 	smIn->hasStarted = false;
+	smIn->threadId = threadIdIn;
 
 	// setup our internal state
 	cxa_array_init(&smIn->states, sizeof(*smIn->states_raw), (void*)smIn->states_raw, sizeof(smIn->states_raw));
@@ -58,8 +59,8 @@ void cxa_stateMachine_init(cxa_stateMachine_t *const smIn, const char* nameIn, i
 	cxa_array_initStd(&smIn->listeners, smIn->listeners_raw);
 	#endif
 
-	// register for run loop execution
-	cxa_runLoop_addEntry(threadIdIn, cb_onRunLoopUpdate, cb_onRunLoopUpdate, (void*)smIn);
+	// register for run loop execution (transitions and timed states request their own wakes)
+	cxa_runLoop_addEntry_full(threadIdIn, CXA_RUNLOOP_POLL_ONREQUEST, cb_onRunLoopUpdate, cb_onRunLoopUpdate, (void*)smIn);
 }
 
 
@@ -175,6 +176,9 @@ void cxa_stateMachine_setInitialState(cxa_stateMachine_t *const smIn, int stateI
 
 	// we have a valid new state...mark for transition
 	smIn->nextState = newNextState;
+
+	// make sure the transition happens promptly (in case our runLoop is idle)
+	cxa_runLoop_requestWakeWithin_ms(smIn->threadId, 0);
 }
 
 
@@ -197,6 +201,9 @@ void cxa_stateMachine_transition(cxa_stateMachine_t *const smIn, int stateIdIn)
 
 	// we have a valid new state...mark for transition
 	smIn->nextState = newNextState;
+
+	// make sure the transition happens promptly (in case our runLoop is idle)
+	cxa_runLoop_requestWakeWithin_ms(smIn->threadId, 0);
 }
 
 
@@ -276,7 +283,11 @@ static void cb_onRunLoopUpdate(void* userVarIn)
 		if( smIn->currState->cb_entered != NULL ) smIn->currState->cb_entered(smIn, ((prevState != NULL) ? prevState->stateId : CXA_STATE_MACHINE_STATE_UNKNOWN), smIn->currState->userVar);
 
 		#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
-			if( smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED ) cxa_timeDiff_setStartTime_now(&smIn->td_timedTransition);
+			if( smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED )
+			{
+				cxa_timeDiff_setStartTime_now(&smIn->td_timedTransition);
+				cxa_runLoop_requestWakeWithin_ms(smIn->threadId, smIn->currState->stateTime_ms);
+			}
 		#endif
 
 		// notify our listeners last
@@ -293,11 +304,17 @@ static void cb_onRunLoopUpdate(void* userVarIn)
 	{
 		#ifdef CXA_STATE_MACHINE_ENABLE_TIMED_STATES
 			// see if our state's time has expired...if so, transition into our next state
-			if( (smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED) &&
-				cxa_timeDiff_isElapsed_ms(&smIn->td_timedTransition, smIn->currState->stateTime_ms) )
+			if( smIn->currState->type == CXA_STATE_MACHINE_STATE_TYPE_TIMED )
 			{
-				cxa_stateMachine_transition(smIn, smIn->currState->nextStateId);
-				return;
+				uint32_t elapsed_ms = cxa_timeDiff_getElapsedTime_ms(&smIn->td_timedTransition);
+				if( elapsed_ms >= smIn->currState->stateTime_ms )
+				{
+					cxa_stateMachine_transition(smIn, smIn->currState->nextStateId);
+					return;
+				}
+
+				// make sure we're back in time to transition
+				cxa_runLoop_requestWakeWithin_ms(smIn->threadId, smIn->currState->stateTime_ms - elapsed_ms);
 			}
 		#endif
 
@@ -305,6 +322,9 @@ static void cb_onRunLoopUpdate(void* userVarIn)
 		if( (smIn->currState != NULL) && (smIn->currState->cb_state != NULL) ) smIn->currState->cb_state(smIn, smIn->currState->userVar);
 	}
 
+	// states with a state callback still need to be polled
+	if( (smIn->currState != NULL) && (smIn->currState->cb_state != NULL) ) cxa_runLoop_requestWakeWithin_ms(smIn->threadId, CXA_RUNLOOP_TICKLESS_POLLPERIOD_MS);
+
 	// notify our listeners
 	#ifdef CXA_STATE_MACHINE_ENABLE_LISTENERS
 	cxa_array_iterate(&smIn->listeners, currListener, cxa_stateMachine_listenerEntry_t)
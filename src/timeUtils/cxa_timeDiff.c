@@ -36,7 +36,11 @@ void cxa_timeDiff_setStartTime_now(cxa_timeDiff_t *const tdIn)
 {
 	cxa_assert(tdIn);
 
+#ifdef CXA_TIMEDIFF_64BIT_ENABLE
+	tdIn->startTime_us = cxa_timeBase_getCount64_us();
+#else
 	tdIn->startTime_us = cxa_timeBase_getCount_us();
+#endif
 }
 
 
@@ -44,11 +48,16 @@ uint32_t cxa_timeDiff_getElapsedTime_ms(cxa_timeDiff_t *const tdIn)
 {
 	cxa_assert(tdIn);
 
+#ifdef CXA_TIMEDIFF_64BIT_ENABLE
+	uint64_t elapsedTime_ms = (cxa_timeBase_getCount64_us() - tdIn->startTime_us) / 1000;
+	return (elapsedTime_ms > UINT32_MAX) ? UINT32_MAX : (uint32_t)elapsedTime_ms;
+#else
 	uint32_t curr_us = cxa_timeBase_getCount_us();
 	uint32_t elapsedTime_us = (curr_us >= tdIn->startTime_us) ?
 							  (curr_us - tdIn->startTime_us) :
 							  ((cxa_timeBase_getMaxCount_us() - tdIn->startTime_us) + curr_us);
 	return elapsedTime_us / 1000;
+#endif
 }
 
 